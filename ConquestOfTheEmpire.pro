@@ -22,7 +22,28 @@ SOURCES += \
     playerinfowidget.cpp \
     troopselectiondialog.cpp \
     combatdialog.cpp \
-    citydestructiondialog.cpp
+    citydestructiondialog.cpp \
+    gamestate.cpp \
+    rulesengine.cpp \
+    gamestatebridge.cpp \
+    scoreledger.cpp \
+    roadnetwork.cpp \
+    reachability.cpp \
+    movegenerator.cpp \
+    combatodds.cpp \
+    combatsimulator.cpp \
+    gamerandom.cpp \
+    threadpool.cpp \
+    mctsplayer.cpp \
+    zobrist.cpp \
+    transpositiontable.cpp \
+    gamehistory.cpp \
+    savegame.cpp \
+    savegamejson.cpp \
+    staterecord.cpp \
+    gamejournal.cpp \
+    gamereplay.cpp \
+    savewriter.cpp
 
 HEADERS += \
     mainwindow.h \
@@ -38,7 +59,32 @@ HEADERS += \
     common.h \
     troopselectiondialog.h \
     combatdialog.h \
-    citydestructiondialog.h
+    citydestructiondialog.h \
+    tilemask.h \
+    gamestate.h \
+    cowptr.h \
+    rulesengine.h \
+    gamestatebridge.h \
+    scoreledger.h \
+    roadnetwork.h \
+    reachability.h \
+    movegenerator.h \
+    combatodds.h \
+    combatsimulator.h \
+    fastrng.h \
+    gamerandom.h \
+    threadpool.h \
+    mctsplayer.h \
+    zobrist.h \
+    transpositiontable.h \
+    gamehistory.h \
+    savegame.h \
+    savegamejson.h \
+    bytestream.h \
+    staterecord.h \
+    gamejournal.h \
+    gamereplay.h \
+    savewriter.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -0,0 +1,21 @@
+QT       = core
+CONFIG  += console c++17
+CONFIG  -= app_bundle
+TEMPLATE = app
+
+TARGET = SaveTool
+
+# The save codecs are shared with the game
+INCLUDEPATH += ..
+
+HEADERS += ../tilemask.h \
+           ../bytestream.h \
+           ../gamestate.h \
+           ../savegame.h \
+           ../savegamejson.h
+
+SOURCES += main.cpp \
+           ../savegame.cpp \
+           ../savegamejson.cpp
+
+CONFIG(release, debug|release):DEFINES += NDEBUG
@@ -0,0 +1,119 @@
+#include "savegamejson.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <cstdio>
+
+// Command-line converter for save archives: rewrites each save in the other
+// format (binary <-> JSON) and prints sizes and decode times. With --check it
+// only decodes and validates each save, without writing anything; --compress
+// writes binary saves zlib-compressed for archiving.
+
+static void printUsage(const char *program)
+{
+    std::printf("Usage: %s [options] file...\n"
+                "  --to binary|json   Output format (default: the other format of each input)\n"
+                "  --out DIR          Write converted files to DIR (default: next to each input)\n"
+                "  --compress         Compress binary output (smaller archives, but no zero-copy load)\n"
+                "  --check            Only validate each save\n",
+                program);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QString target;
+    QString outputDir;
+    bool checkOnly = false;
+    bool compress = false;
+    QStringList inputs;
+    QStringList arguments = app.arguments();
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString &option = arguments[i];
+        bool hasValue = (i + 1 < arguments.size());
+
+        if (option == "--to" && hasValue) {
+            target = arguments[++i];
+        } else if (option == "--out" && hasValue) {
+            outputDir = arguments[++i];
+        } else if (option == "--check") {
+            checkOnly = true;
+        } else if (option == "--compress") {
+            compress = true;
+        } else if (!option.startsWith("--")) {
+            inputs.append(option);
+        } else {
+            inputs.clear();
+            break;
+        }
+    }
+
+    if (inputs.isEmpty() || (!target.isEmpty() && target != "binary" && target != "json")) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+    qint64 bytesIn = 0;
+    qint64 bytesOut = 0;
+    qint64 decodeNs = 0;
+    for (const QString &input : inputs) {
+        QFile file(input);
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::fprintf(stderr, "%s: cannot open\n", qPrintable(input));
+            ++failures;
+            continue;
+        }
+        QByteArray data = file.readAll();
+        file.close();
+
+        QElapsedTimer timer;
+        timer.start();
+        SaveGame save;
+        bool ok = SaveGameJson::read(data, save);
+        decodeNs += timer.nsecsElapsed();
+        std::string error;
+        if (!ok || !save.validate(&error)) {
+            std::fprintf(stderr, "%s: not a valid save%s%s\n", qPrintable(input), error.empty() ? "" : ": ", error.c_str());
+            ++failures;
+            continue;
+        }
+        bytesIn += data.size();
+        if (checkOnly) {
+            continue;
+        }
+
+        bool wasBinary = SaveGameJson::isBinaryData(data);
+        bool binary = target.isEmpty() ? !wasBinary : (target == "binary");
+        QFileInfo info(input);
+        QString name = info.completeBaseName() + "." + (binary ? SaveGameJson::BINARY_EXTENSION : "json");
+        QString output = QDir(outputDir.isEmpty() ? info.absolutePath() : outputDir).filePath(name);
+        // Rewriting a binary save in place is fine when only its compression changes
+        bool recompress = binary && wasBinary && data.startsWith(SaveGameJson::COMPRESSED_MAGIC) != compress;
+        if (QFileInfo(output).absoluteFilePath() == info.absoluteFilePath() && !recompress) {
+            std::fprintf(stderr, "%s: already in that format\n", qPrintable(input));
+            continue;
+        }
+
+        QByteArray converted = SaveGameJson::write(save, binary, compress);
+        QFile outFile(output);
+        if (!outFile.open(QIODevice::WriteOnly) || outFile.write(converted) != converted.size()) {
+            std::fprintf(stderr, "%s: cannot write\n", qPrintable(output));
+            ++failures;
+            continue;
+        }
+
+        bytesOut += converted.size();
+        std::printf("%s -> %s (%lld -> %lld bytes)\n", qPrintable(input), qPrintable(output),
+                    static_cast<long long>(data.size()), static_cast<long long>(converted.size()));
+    }
+
+    std::printf("%d file(s), %lld -> %lld bytes, %.1f us average decode, %d failure(s)\n",
+                static_cast<int>(inputs.size()), static_cast<long long>(bytesIn), static_cast<long long>(bytesOut),
+                inputs.isEmpty() ? 0.0 : decodeNs / 1000.0 / inputs.size(), failures);
+    return failures == 0 ? 0 : 1;
+}
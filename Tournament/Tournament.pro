@@ -0,0 +1,51 @@
+CONFIG  += console c++17 thread
+CONFIG  -= app_bundle qt
+TEMPLATE = app
+
+TARGET = Tournament
+
+# The headless rules engine is shared with the game
+INCLUDEPATH += ..
+
+HEADERS += tournament.h \
+           replayverifier.h \
+           ../tilemask.h \
+           ../gamestate.h \
+           ../cowptr.h \
+           ../roadnetwork.h \
+           ../rulesengine.h \
+           ../reachability.h \
+           ../movegenerator.h \
+           ../combatodds.h \
+           ../combatsimulator.h \
+           ../fastrng.h \
+           ../gamerandom.h \
+           ../threadpool.h \
+           ../mctsplayer.h \
+           ../zobrist.h \
+           ../transpositiontable.h \
+           ../bytestream.h \
+           ../staterecord.h \
+           ../gamejournal.h \
+           ../gamereplay.h
+
+SOURCES += main.cpp \
+           tournament.cpp \
+           replayverifier.cpp \
+           ../gamestate.cpp \
+           ../roadnetwork.cpp \
+           ../rulesengine.cpp \
+           ../reachability.cpp \
+           ../movegenerator.cpp \
+           ../combatodds.cpp \
+           ../combatsimulator.cpp \
+           ../gamerandom.cpp \
+           ../threadpool.cpp \
+           ../mctsplayer.cpp \
+           ../zobrist.cpp \
+           ../transpositiontable.cpp \
+           ../staterecord.cpp \
+           ../gamejournal.cpp \
+           ../gamereplay.cpp
+
+CONFIG(release, debug|release):DEFINES += NDEBUG
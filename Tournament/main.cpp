@@ -0,0 +1,272 @@
+#include "tournament.h"
+#include "replayverifier.h"
+#include "combatsimulator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// Command-line self-play: plays N headless games between bots and prints
+// throughput, game length and win rates by bot, seat and home province.
+// With --verify it re-executes recorded games instead (see ReplayVerifier), and
+// with --simulate it rolls one battle many times (see CombatSimulator).
+
+static void printUsage(const char *program)
+{
+    std::printf("Usage: %s [options]\n"
+                "       %s --verify FILE...\n"
+                "       %s --simulate [combat options]\n"
+                "  --games N          Games to play (default 100)\n"
+                "  --bots a,b,...     Bot per seat, 2-6 of: random, greedy, mcts (default mcts,greedy,random,random)\n"
+                "  --threads N        Worker threads (default: one per core)\n"
+                "  --seed S           Base seed; game i always gets the same map and dice (default 1). Moves\n"
+                "                     repeat too, except for mcts seats searching on time: use --mcts-iterations\n"
+                "  --rounds N         Rounds before a game is adjudicated on position (default 60)\n"
+                "  --mcts-ms N        MCTS time budget per movement phase in ms (default 100)\n"
+                "  --mcts-iterations N\n"
+                "                     MCTS playouts per movement phase instead of a time budget, so\n"
+                "                     mcts seats play the same moves for the same seed\n"
+                "  --fixed-seats      Keep every bot in its seat instead of rotating each game\n"
+                "  --inflation-at A,B Richest wallet that doubles / triples all prices (default: never)\n"
+                "  --record DIR       Save every game as DIR/game-<i>.ctreplay, with each engine call\n"
+                "  --verify FILE...   Re-execute replays (or check autosave journals) and report the\n"
+                "                     first action whose state doesn't match the recorded one\n"
+                "Combat options (--simulate):\n"
+                "  --attacker I,C,K   Attacking infantry, cavalry, catapults (default 3,1,1)\n"
+                "  --defender I,C,K   Defending infantry, cavalry, catapults (default 3,1,1)\n"
+                "  --fortified        Defender holds a fortified city\n"
+                "  --defender-first   Defender fires the first volley\n"
+                "  --attacker-targets P, --defender-targets P\n"
+                "                     Troop each side shoots at: easiest, hardest, random (default easiest)\n"
+                "  --combats N        Combats to roll (default 1000000)\n"
+                "  --threads N        Worker threads (default: one per core)\n"
+                "  --seed S           Seed; same seed and thread count give the same result (default 1)\n",
+                program, program, program);
+}
+
+static std::vector<std::string> splitList(const std::string &text)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+static bool parseArguments(int argc, char *argv[], Tournament::Settings &settings)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (option == "--games" && hasValue) {
+            settings.games = std::atoll(argv[++i]);
+        } else if (option == "--bots" && hasValue) {
+            settings.bots = splitList(argv[++i]);
+        } else if (option == "--threads" && hasValue) {
+            settings.threads = std::atoi(argv[++i]);
+        } else if (option == "--seed" && hasValue) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if (option == "--rounds" && hasValue) {
+            settings.maxRounds = std::atoi(argv[++i]);
+        } else if (option == "--mcts-ms" && hasValue) {
+            settings.mctsBudgetMs = std::atoi(argv[++i]);
+        } else if (option == "--mcts-iterations" && hasValue) {
+            settings.mctsIterations = std::atoll(argv[++i]);
+        } else if (option == "--record" && hasValue) {
+            settings.replayDir = argv[++i];
+        } else if (option == "--fixed-seats") {
+            settings.rotateSeats = false;
+        } else if (option == "--inflation-at" && hasValue) {
+            std::vector<std::string> levels = splitList(argv[++i]);
+            for (size_t level = 0; level < levels.size() && level < 2; ++level) {
+                settings.inflationAt[level] = std::atoi(levels[level].c_str());
+            }
+        } else {
+            return false;
+        }
+    }
+
+    if (settings.bots.size() < 2 || settings.bots.size() > static_cast<size_t>(MAX_PLAYERS) || settings.games < 1) {
+        return false;
+    }
+    for (const std::string &name : settings.bots) {
+        if (!Bot::create(name, settings.mctsBudgetMs)) {
+            std::fprintf(stderr, "Unknown bot: %s\n", name.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parseTroops(const std::string &text, TroopCounts &troops)
+{
+    std::vector<std::string> counts = splitList(text);
+    if (counts.size() != 3) {
+        return false;
+    }
+    troops.infantry = std::atoi(counts[0].c_str());
+    troops.cavalry = std::atoi(counts[1].c_str());
+    troops.catapults = std::atoi(counts[2].c_str());
+    return troops.infantry >= 0 && troops.cavalry >= 0 && troops.catapults >= 0;
+}
+
+static bool parsePolicy(const std::string &text, CombatSimulator::TargetPolicy &policy)
+{
+    if (text == "easiest") {
+        policy = CombatSimulator::TargetPolicy::Easiest;
+    } else if (text == "hardest") {
+        policy = CombatSimulator::TargetPolicy::Hardest;
+    } else if (text == "random") {
+        policy = CombatSimulator::TargetPolicy::Random;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool parseSimulation(int argc, char *argv[], CombatSimulator::Settings &settings)
+{
+    settings.attacker.infantry = settings.defender.infantry = 3;
+    settings.attacker.cavalry = settings.defender.cavalry = 1;
+    settings.attacker.catapults = settings.defender.catapults = 1;
+    settings.seed = 1;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string option = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (option == "--attacker" && hasValue) {
+            if (!parseTroops(argv[++i], settings.attacker)) return false;
+        } else if (option == "--defender" && hasValue) {
+            if (!parseTroops(argv[++i], settings.defender)) return false;
+        } else if (option == "--fortified") {
+            settings.defenderFortified = true;
+        } else if (option == "--defender-first") {
+            settings.attackerShootsFirst = false;
+        } else if (option == "--attacker-targets" && hasValue) {
+            if (!parsePolicy(argv[++i], settings.attackerTargets)) return false;
+        } else if (option == "--defender-targets" && hasValue) {
+            if (!parsePolicy(argv[++i], settings.defenderTargets)) return false;
+        } else if (option == "--combats" && hasValue) {
+            settings.combats = std::atoll(argv[++i]);
+        } else if (option == "--threads" && hasValue) {
+            settings.threads = std::atoi(argv[++i]);
+        } else if (option == "--seed" && hasValue) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 0);
+        } else {
+            return false;
+        }
+    }
+    return settings.combats > 0 && settings.attacker.total() > 0 && settings.defender.total() > 0;
+}
+
+static int simulateCombat(const CombatSimulator::Settings &settings)
+{
+    CombatSimulator::Report report = CombatSimulator::run(settings);
+
+    std::printf("%lld combats on %d threads in %.2f s (%.0f combats/s)\n",
+                static_cast<long long>(report.combats), report.threads, report.seconds, report.combatsPerSecond);
+    std::printf("Attacker wins %6.2f%%  (95%% CI %.2f%% - %.2f%%)\n", 100.0 * report.attackerWinRate,
+                100.0 * report.confidenceLow, 100.0 * report.confidenceHigh);
+    std::printf("Mean losses: attacker %.2f of %d, defender %.2f of %d\n",
+                report.meanAttackerLosses, settings.attacker.total(),
+                report.meanDefenderLosses, settings.defender.total());
+    return 0;
+}
+
+// Exit code 0 if every file verifies
+static int verifyReplays(int count, char *paths[])
+{
+    int failures = 0;
+    for (int i = 0; i < count; ++i) {
+        ReplayVerifier::Report report = ReplayVerifier::verify(paths[i]);
+        const char *unit = report.journal ? "records" : "steps";
+
+        if (!report.loaded) {
+            std::printf("%s: not a replay or autosave journal, or damaged\n", paths[i]);
+        } else if (report.ok) {
+            std::printf("%s: OK, %d %s (%d re-executed)\n", paths[i], report.steps, unit, report.reexecuted);
+        } else if (report.journal) {
+            std::printf("%s: diverged at record %d\n  %s\n", paths[i], report.step, report.error.c_str());
+        } else {
+            std::printf("%s: diverged at step %d (turn %d, \"%s\") after %d matching %s\n  %s\n", paths[i],
+                        report.step, report.turn + 1, report.label.c_str(), report.steps, unit, report.error.c_str());
+        }
+        failures += !report.ok;
+    }
+    return failures > 0 ? 1 : 0;
+}
+
+static double percent(int64_t wins, int64_t games)
+{
+    return games > 0 ? 100.0 * wins / games : 0.0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 2 && std::strcmp(argv[1], "--verify") == 0) {
+        return verifyReplays(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--simulate") == 0) {
+        CombatSimulator::Settings combat;
+        if (!parseSimulation(argc, argv, combat)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        return simulateCombat(combat);
+    }
+
+    Tournament::Settings settings;
+    if (!parseArguments(argc, argv, settings)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Tournament::Report report = Tournament::run(settings);
+    int seats = static_cast<int>(settings.bots.size());
+
+    std::printf("%lld games on %d threads in %.2f s (%.2f games/s)\n",
+                static_cast<long long>(report.games), report.threads, report.seconds, report.gamesPerSecond);
+    std::printf("Average length %.1f rounds, %lld adjudicated after %d rounds\n\n",
+                report.averageRounds, static_cast<long long>(report.adjudicated), settings.maxRounds);
+
+    std::printf("Win rate by bot\n");
+    for (int bot = 0; bot < seats; ++bot) {
+        std::printf("  %-8s (entry %d)  %6.2f%%  of %lld games\n", settings.bots[bot].c_str(), bot + 1,
+                    percent(report.botWins[bot], report.botGames[bot]), static_cast<long long>(report.botGames[bot]));
+    }
+
+    std::printf("\nWin rate by seat (turn order)\n");
+    for (int seat = 0; seat < seats; ++seat) {
+        std::printf("  %c  %6.2f%%\n", 'A' + seat, percent(report.seatWins[seat], report.games));
+    }
+
+    std::printf("\nWin rate by home province value\n");
+    std::printf("   5 talents  %6.2f%%  of %lld\n", percent(report.homeValueWins[0], report.homeValueGames[0]),
+                static_cast<long long>(report.homeValueGames[0]));
+    std::printf("  10 talents  %6.2f%%  of %lld\n", percent(report.homeValueWins[1], report.homeValueGames[1]),
+                static_cast<long long>(report.homeValueGames[1]));
+
+    std::printf("\nWin rate by home province position (%%, '-' = never a home province)\n     ");
+    for (int col = 0; col < BOARD_COLUMNS; ++col) {
+        std::printf("%6d", col);
+    }
+    std::printf("\n");
+    for (int row = 0; row < BOARD_ROWS; ++row) {
+        std::printf("  %d  ", row);
+        for (int col = 0; col < BOARD_COLUMNS; ++col) {
+            int tile = tileIndex(row, col);
+            if (report.homeGames[tile] == 0) {
+                std::printf("%6s", "-");
+            } else {
+                std::printf("%6.1f", percent(report.homeWins[tile], report.homeGames[tile]));
+            }
+        }
+        std::printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,310 @@
+#include "replayverifier.h"
+#include "gamejournal.h"
+#include "movegenerator.h"
+#include "rulesengine.h"
+#include "tournament.h"
+#include <cstdarg>
+#include <cstdio>
+
+// Setup retries maps until one has enough coastal provinces; a recorded seed
+// found one, so this many failures means the rules changed under it
+static constexpr int MAX_SETUP_ATTEMPTS = 10000;
+
+static std::string format(const char *text, ...)
+{
+    char buffer[256];
+    va_list arguments;
+    va_start(arguments, text);
+    std::vsnprintf(buffer, sizeof(buffer), text, arguments);
+    va_end(arguments);
+    return buffer;
+}
+
+// ========== Verifying ==========
+
+ReplayVerifier::Report ReplayVerifier::verify(const std::string &path)
+{
+    GameReplay replay;
+    if (!replay.load(path)) {
+        // Damaged replays are rejected whole, so anything that isn't one may be a journal
+        return verifyJournal(path);
+    }
+
+    Report report;
+    report.loaded = true;
+
+    GameState recorded;
+    GameState actual;
+    GameReplay::Extras extras;
+    for (int step = 0; step < replay.steps(); ++step) {
+        report.step = step;
+        report.turn = replay.turnOf(step);
+        report.label = replay.label(step);
+
+        bool decoded = (step == 0) ? replay.seek(0, recorded, extras) : replay.advance(step, recorded, extras);
+        if (!decoded) {
+            report.error = "the record doesn't rebuild the state it was recorded from";
+            return report;
+        }
+
+        const GameReplay::Command &command = replay.command(step);
+        if (command.kind == GameReplay::Command::Kind::None) {
+            actual = recorded;
+        } else {
+            if (!execute(command, actual, report.error)) {
+                return report;
+            }
+            if (StateRecord::digest(actual) != StateRecord::digest(recorded)) {
+                report.error = difference(recorded, actual);
+                if (report.error.empty()) {
+                    report.error = "the state digests differ";
+                }
+                return report;
+            }
+            ++report.reexecuted;
+        }
+
+        report.error = missingRoad(actual);
+        if (!report.error.empty()) {
+            return report;
+        }
+        ++report.steps;
+    }
+
+    report.ok = true;
+    report.step = -1;
+    report.turn = -1;
+    report.label.clear();
+    return report;
+}
+
+ReplayVerifier::Report ReplayVerifier::verifyJournal(const std::string &path)
+{
+    // A journal keeps only what each action changed, so recovering it decodes every
+    // record against the digest it was written with
+    Report report;
+    report.journal = true;
+
+    GameState state;
+    GameJournal::Extras extras;
+    int records = 0;
+    bool intact = false;
+    if (!GameJournal::recover(path, state, extras, &records, &intact)) {
+        return report;
+    }
+    report.loaded = true;
+    report.steps = records + 1;
+
+    if (!intact) {
+        report.step = records + 1;
+        report.error = "the record is torn, damaged or doesn't rebuild the state it was recorded from";
+        return report;
+    }
+    report.error = missingRoad(state);
+    if (!report.error.empty()) {
+        report.step = records;
+        return report;
+    }
+    report.ok = true;
+    return report;
+}
+
+// ========== Re-executing ==========
+
+bool ReplayVerifier::execute(const GameReplay::Command &command, GameState &state, std::string &error)
+{
+    using Kind = GameReplay::Command::Kind;
+
+    if (command.kind == Kind::Setup) {
+        if (command.player < 2 || command.player > MAX_PLAYERS) {
+            error = format("a new game can't have %d players", command.player);
+            return false;
+        }
+        Xoshiro256 random;
+        random.setState(command.random.data());
+        for (int attempt = 0; attempt < MAX_SETUP_ATTEMPTS; ++attempt) {
+            if (RulesEngine::setupNewGame(state, random, command.player)) {
+                return true;
+            }
+        }
+        error = "RulesEngine::setupNewGame no longer finds a map for the recorded seed";
+        return false;
+    }
+
+    int player = command.player;
+    if (player < 0 || player >= state.playerCount()) {
+        error = format("the command is for player %d of %d", player, state.playerCount());
+        return false;
+    }
+
+    // Whether the engine accepts an action is part of what is checked: a
+    // rejected one leaves the state alone, and the digests show if it shouldn't have
+    switch (command.kind) {
+    case Kind::None:
+    case Kind::Setup:
+        break;
+    case Kind::Legions:
+        for (const std::pair<int, int> &assignment : command.legions) {
+            RulesEngine::assignToLegion(state, player, assignment.first, assignment.second);
+        }
+        break;
+    case Kind::Move:
+        MoveGenerator::apply(state, player, command.move);
+        break;
+    case Kind::Combats: {
+        Xoshiro256 random;
+        random.setState(command.random.data());
+        RulesEngine::resolveAllCombats(state, player, random);
+        break;
+    }
+    case Kind::Purchase:
+        RulesEngine::purchase(state, player, command.order);
+        break;
+    case Kind::EndTurn:
+        RulesEngine::endTurn(state);
+        Tournament::applyInflation(command.inflationAt, state);
+        break;
+    case Kind::Taxes:
+        RulesEngine::collectTaxes(state, player);
+        break;
+    }
+    return true;
+}
+
+// ========== Reporting ==========
+
+static std::string pieceDifference(const PieceState &recorded, const PieceState &actual)
+{
+    struct Field { const char *name; int recorded; int actual; };
+    const Field fields[] = {
+        {"kind", static_cast<int>(recorded.kind), static_cast<int>(actual.kind)},
+        {"tile", recorded.tile, actual.tile},
+        {"last tile", recorded.lastTile, actual.lastTile},
+        {"moves left", recorded.movesRemaining, actual.movesRemaining},
+        {"general number", recorded.generalNumber, actual.generalNumber},
+        {"captured by", recorded.capturedBy, actual.capturedBy},
+        {"leader", recorded.leaderId, actual.leaderId},
+        {"galley", recorded.galleyId, actual.galleyId}
+    };
+    for (const Field &field : fields) {
+        if (field.recorded != field.actual) {
+            return format("piece %d %s: recorded %d, re-executed %d", recorded.id, field.name, field.recorded, field.actual);
+        }
+    }
+    return std::string();
+}
+
+static bool hasPiece(const std::vector<PieceState> &pieces, int id)
+{
+    for (const PieceState &piece : pieces) {
+        if (piece.id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::string maskDifference(char player, const char *name, const TileMask &recorded, const TileMask &actual)
+{
+    int tile = (recorded ^ actual).first();
+    return format("player %c %s: tile %d is %s when recorded, %s when re-executed", player, name, tile,
+                  recorded.test(tile) ? "in" : "out", actual.test(tile) ? "in" : "out");
+}
+
+std::string ReplayVerifier::difference(const GameState &recorded, const GameState &actual)
+{
+    if (recorded.playerCount() != actual.playerCount()) {
+        return format("players: recorded %d, re-executed %d", recorded.playerCount(), actual.playerCount());
+    }
+    if (recorded.map->land != actual.map->land) {
+        return "the map differs";
+    }
+
+    for (int p = 0; p < recorded.playerCount(); ++p) {
+        const PlayerState &expected = recorded.players[p];
+        const PlayerState &player = actual.players[p];
+        char id = expected.id;
+
+        if (expected.eliminated != player.eliminated) {
+            return format("player %c is %seliminated when re-executed", id, player.eliminated ? "" : "not ");
+        }
+        if (expected.wallet != player.wallet) {
+            return format("player %c wallet: recorded %d, re-executed %d", id, expected.wallet, player.wallet);
+        }
+        if (expected.homeTile != player.homeTile) {
+            return format("player %c home: recorded tile %d, re-executed %d", id, expected.homeTile, player.homeTile);
+        }
+        if (expected.owned != player.owned) {
+            return maskDifference(id, "territories", expected.owned, player.owned);
+        }
+        if (expected.cities != player.cities) {
+            return maskDifference(id, "cities", expected.cities, player.cities);
+        }
+        if (expected.fortifiedCities != player.fortifiedCities) {
+            return maskDifference(id, "fortified cities", expected.fortifiedCities, player.fortifiedCities);
+        }
+
+        const std::vector<PieceState> &expectedPieces = *expected.pieces;
+        const std::vector<PieceState> &pieces = *player.pieces;
+        for (size_t i = 0; i < expectedPieces.size() || i < pieces.size(); ++i) {
+            // Pieces are kept in the order they were created, so the first different id is the one lost or gained
+            if (i == pieces.size() || (i < expectedPieces.size() && expectedPieces[i].id != pieces[i].id &&
+                                       !hasPiece(pieces, expectedPieces[i].id))) {
+                return format("player %c piece %d: recorded, missing when re-executed", id, expectedPieces[i].id);
+            }
+            if (i == expectedPieces.size() || expectedPieces[i].id != pieces[i].id) {
+                return format("player %c piece %d: re-executed, missing when recorded", id, pieces[i].id);
+            }
+            std::string piece = pieceDifference(expectedPieces[i], pieces[i]);
+            if (!piece.empty()) {
+                return format("player %c ", id) + piece;
+            }
+        }
+
+        for (int tile = 0; tile < BOARD_TILES; ++tile) {
+            TileMask changed = expected.roads->neighbours(tile) ^ player.roads->neighbours(tile);
+            if (changed.any()) {
+                int other = changed.first();
+                return format("player %c road between tiles %d and %d: %s when recorded, %s when re-executed", id,
+                              tile, other, expected.roads->hasRoad(tile, other) ? "built" : "missing",
+                              player.roads->hasRoad(tile, other) ? "built" : "missing");
+            }
+        }
+    }
+
+    if (recorded.currentPlayer != actual.currentPlayer) {
+        return format("current player: recorded %d, re-executed %d", recorded.currentPlayer, actual.currentPlayer);
+    }
+    if (recorded.turnNumber != actual.turnNumber) {
+        return format("turn number: recorded %d, re-executed %d", recorded.turnNumber, actual.turnNumber);
+    }
+    if (recorded.pieceCounter != actual.pieceCounter) {
+        return format("piece counter: recorded %d, re-executed %d", recorded.pieceCounter, actual.pieceCounter);
+    }
+    if (recorded.inflationMultiplier != actual.inflationMultiplier) {
+        return format("inflation: recorded x%d, re-executed x%d", recorded.inflationMultiplier, actual.inflationMultiplier);
+    }
+    return std::string();
+}
+
+std::string ReplayVerifier::missingRoad(const GameState &state)
+{
+    // Roads only ever follow cities, so a complete network is one updateRoads leaves alone
+    GameState rebuilt = state;
+    for (int p = 0; p < state.playerCount(); ++p) {
+        RulesEngine::updateRoads(rebuilt, p);
+        const RoadNetwork &roads = *state.players[p].roads;
+        const RoadNetwork &expected = *rebuilt.players[p].roads;
+        if (roads == expected) {
+            continue;
+        }
+        for (int tile = 0; tile < BOARD_TILES; ++tile) {
+            TileMask missing = expected.neighbours(tile) ^ roads.neighbours(tile);
+            if (missing.any()) {
+                return format("player %c has no road between its cities on tiles %d and %d", state.players[p].id, tile,
+                              missing.first());
+            }
+        }
+    }
+    return std::string();
+}
@@ -0,0 +1,46 @@
+#ifndef REPLAYVERIFIER_H
+#define REPLAYVERIFIER_H
+
+#include <string>
+#include "gamereplay.h"
+#include "gamestate.h"
+
+// Checks that a recorded game still plays out the same. Every record carries
+// the StateRecord::digest of the state it was made from; a step with a
+// Command (every step of a self-play game, the taxes of a game played in the
+// window) is run again through the RulesEngine from the re-executed
+// position, dice and all, and its digest compared with the recorded one.
+// Other steps and autosave journals are checked for records that rebuild
+// their own digest and for roads that match what RulesEngine::updateRoads
+// would build (the window builds its roads with that call too).
+class ReplayVerifier
+{
+public:
+    struct Report {
+        bool loaded = false;        // The file is a replay or journal at all
+        bool ok = false;            // Every step matched
+        bool journal = false;
+        int steps = 0;              // Steps checked (records, for a journal)
+        int reexecuted = 0;         // Of those, run again through the engine
+        int step = -1;              // First divergence
+        int turn = -1;
+        std::string label;
+        std::string error;          // What diverged
+    };
+
+    static Report verify(const std::string &path);
+
+    // Run a step's engine call on state; false (and why) if the command can't apply to it
+    static bool execute(const GameReplay::Command &command, GameState &state, std::string &error);
+
+    // First field that differs between two states ("" if none)
+    static std::string difference(const GameState &recorded, const GameState &actual);
+
+    // First road RulesEngine::updateRoads would add ("" if the roads are complete)
+    static std::string missingRoad(const GameState &state);
+
+private:
+    static Report verifyJournal(const std::string &path);
+};
+
+#endif // REPLAYVERIFIER_H
@@ -0,0 +1,387 @@
+#include "tournament.h"
+#include "combatodds.h"
+#include "mctsplayer.h"
+#include "movegenerator.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Step labels in recorded games
+static const char *LEGIONS_LABEL = "Form Legions";
+static const char *MOVE_LABEL = "Move";
+static const char *COMBATS_LABEL = "Combat";
+static const char *PURCHASE_LABEL = "Purchase";
+static const char *END_TURN_LABEL = "End Turn";
+
+// ========== Bots ==========
+
+RulesEngine::PurchaseOrder Bot::choosePurchase(const GameState &state, int player)
+{
+    return MctsPlayer::choosePurchase(state, player);
+}
+
+void Bot::formLegions(GameState &state, int player)
+{
+    std::vector<std::pair<int, int>> legions = MctsPlayer::formLegions(state, player);
+    if (m_replay && !legions.empty()) {
+        GameReplay::Command command;
+        command.kind = GameReplay::Command::Kind::Legions;
+        command.player = player;
+        command.legions = std::move(legions);
+        m_replay->record(state, LEGIONS_LABEL, false, command);
+    }
+}
+
+void Bot::assignToLegions(GameState &state, int player, const std::vector<std::pair<int, int>> &legions)
+{
+    for (const std::pair<int, int> &assignment : legions) {
+        RulesEngine::assignToLegion(state, player, assignment.first, assignment.second);
+    }
+    if (m_replay && !legions.empty()) {
+        GameReplay::Command command;
+        command.kind = GameReplay::Command::Kind::Legions;
+        command.player = player;
+        command.legions = legions;
+        m_replay->record(state, LEGIONS_LABEL, false, command);
+    }
+}
+
+void Bot::apply(GameState &state, int player, const Move &move)
+{
+    MoveGenerator::apply(state, player, move);
+    if (m_replay) {
+        GameReplay::Command command;
+        command.kind = GameReplay::Command::Kind::Move;
+        command.player = player;
+        command.move = move;
+        m_replay->record(state, MOVE_LABEL, false, command);
+    }
+}
+
+// Random legal moves, stopping early a quarter of the time (MctsPlayer's rollout policy)
+class RandomBot : public Bot
+{
+public:
+    void playMovement(GameState &state, int player, Xoshiro256 &random) override
+    {
+        formLegions(state, player);
+        for (int i = 0; i < MAX_MOVES; ++i) {
+            m_generator.generate(state, player, m_moves);
+            if (m_moves.isEmpty() || random.bounded(4) == 0) {
+                return;
+            }
+            apply(state, player, m_moves[random.bounded(static_cast<uint32_t>(m_moves.size()))]);
+        }
+    }
+
+private:
+    static constexpr int MAX_MOVES = 40;
+
+    MoveGenerator m_generator;
+    MoveList m_moves;
+};
+
+// One-move lookahead: claim the richest free territory in reach, attack only with
+// good exact odds, and keep Caesar at home
+class GreedyBot : public Bot
+{
+public:
+    void playMovement(GameState &state, int player, Xoshiro256 &random) override
+    {
+        formLegions(state, player);
+        for (int i = 0; i < MAX_MOVES; ++i) {
+            m_generator.generate(state, player, m_moves);
+
+            const Move *best = nullptr;
+            double bestScore = 0.0;
+            for (const Move &move : m_moves) {
+                double score = scoreMove(state, player, move) + random.bounded(100) * 1e-4;   // Random tie-break
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = &move;
+                }
+            }
+            if (!best) {
+                return;
+            }
+            apply(state, player, *best);
+        }
+    }
+
+private:
+    static constexpr int MAX_MOVES = 40;
+    static constexpr double MIN_ATTACK_ODDS = 0.6;
+
+    static double scoreMove(const GameState &state, int player, const Move &move)
+    {
+        const PieceState *piece = state.findPiece(move.pieceId);
+        if (!piece || piece->kind == PieceKind::Caesar || move.kind == Move::Kind::Galley || move.kind == Move::Kind::Embark) {
+            return 0.0;
+        }
+
+        int tile = move.toTile;
+        double value = state.map->value[tile];
+        int defender = RulesEngine::defenderAt(state, player, tile);
+        if (defender == NO_PLAYER) {
+            return state.players[player].owned.test(tile) ? 0.0 : value;
+        }
+
+        // The legion joins any of our troops already fighting there
+        TroopCounts attackers = CombatOdds::troopsAt(state, player, tile);
+        for (const PieceState &troop : *state.players[player].pieces) {
+            if (troop.leaderId == move.pieceId && troop.tile == move.fromTile && troop.movesRemaining > 0) {
+                attackers.infantry += troop.kind == PieceKind::Infantry;
+                attackers.cavalry += troop.kind == PieceKind::Cavalry;
+                attackers.catapults += troop.kind == PieceKind::Catapult;
+            }
+        }
+        TroopCounts defenders = CombatOdds::troopsAt(state, defender, tile);
+        bool fortified = state.players[defender].fortifiedCities.test(tile);
+        double odds = CombatOdds::outcome(attackers, defenders, fortified).attackerWinProbability;
+        if (odds < MIN_ATTACK_ODDS) {
+            return 0.0;
+        }
+
+        if (state.countAt(defender, tile, PieceKind::Caesar) > 0) {
+            value += RulesEngine::CAESAR_CAPTURE_BONUS + state.players[defender].wallet;
+        }
+        if (state.players[defender].cities.test(tile)) {
+            value += RulesEngine::CITY_TAX;
+        }
+        return odds * value;
+    }
+
+    MoveGenerator m_generator;
+    MoveList m_moves;
+};
+
+// MctsPlayer searching on its own single-thread pool (the tournament already uses every core)
+class MctsBot : public Bot
+{
+public:
+    MctsBot(int budgetMs, int64_t iterations)
+        : m_pool(1)
+        , m_budgetMs(budgetMs)
+        , m_iterations(iterations)
+    {
+    }
+
+    void playMovement(GameState &state, int player, Xoshiro256 &random) override
+    {
+        MctsPlayer::Settings settings;
+        settings.timeBudgetMs = m_budgetMs;
+        settings.iterations = m_iterations;
+        settings.threads = 1;
+        settings.seed = random.next() | 1;
+        MctsPlayer planner(settings, m_pool);
+
+        MctsPlayer::TurnPlan plan = planner.planMovement(state, player);
+        assignToLegions(state, player, plan.legions);
+        for (const Move &move : plan.moves) {
+            apply(state, player, move);
+        }
+    }
+
+private:
+    ThreadPool m_pool;
+    int m_budgetMs;
+    int64_t m_iterations;
+};
+
+std::unique_ptr<Bot> Bot::create(const std::string &name, int mctsBudgetMs, int64_t mctsIterations)
+{
+    if (name == "random") {
+        return std::make_unique<RandomBot>();
+    }
+    if (name == "greedy") {
+        return std::make_unique<GreedyBot>();
+    }
+    if (name == "mcts") {
+        return std::make_unique<MctsBot>(mctsBudgetMs, mctsIterations);
+    }
+    return nullptr;
+}
+
+std::vector<std::string> Bot::names()
+{
+    return {"random", "greedy", "mcts"};
+}
+
+// ========== Games ==========
+
+Tournament::GameResult Tournament::playGame(const Settings &settings, int64_t gameIndex,
+                                            std::vector<std::unique_ptr<Bot>> &bots)
+{
+    int seats = static_cast<int>(settings.bots.size());
+    GameResult result;
+
+    // Seeds are spread by splitmix inside reseed, so consecutive indices are independent
+    Xoshiro256 random(settings.seed + static_cast<uint64_t>(gameIndex) * 0x9E3779B97F4A7C15ULL);
+    GameReplay::Command command;
+    command.kind = GameReplay::Command::Kind::Setup;
+    command.player = seats;
+    random.getState(command.random.data());
+
+    GameState state;
+    while (!RulesEngine::setupNewGame(state, random, seats)) {
+        // Too few coastal provinces on this map; draw another
+    }
+
+    // Every engine call is recorded with what it needs to run again (see ReplayVerifier)
+    bool recording = !settings.replayDir.empty();
+    GameReplay replay;
+    if (recording) {
+        replay.start(state, std::vector<bool>(seats, true), true, command);
+        for (std::unique_ptr<Bot> &bot : bots) {
+            bot->setReplay(&replay);
+        }
+    }
+
+    for (int seat = 0; seat < seats; ++seat) {
+        int bot = settings.rotateSeats ? static_cast<int>((seat + gameIndex) % seats) : seat;
+        result.seatBot.push_back(bot);
+        result.homeTiles.push_back(state.players[seat].homeTile);
+        result.homeValues.push_back(state.map->value[state.players[seat].homeTile]);
+    }
+
+    while (RulesEngine::winner(state) == NO_PLAYER && state.turnNumber <= settings.maxRounds) {
+        int player = state.currentPlayer;
+        Bot &bot = *bots[result.seatBot[player]];
+
+        bot.playMovement(state, player, random);
+
+        command = GameReplay::Command();
+        command.kind = GameReplay::Command::Kind::Combats;
+        command.player = player;
+        random.getState(command.random.data());
+        RulesEngine::resolveAllCombats(state, player, random);
+        if (recording) {
+            replay.record(state, COMBATS_LABEL, false, command);
+        }
+
+        if (!state.players[player].eliminated) {
+            command = GameReplay::Command();
+            command.kind = GameReplay::Command::Kind::Purchase;
+            command.player = player;
+            command.order = bot.choosePurchase(state, player);
+            RulesEngine::purchase(state, player, command.order);
+            if (recording) {
+                replay.record(state, PURCHASE_LABEL, false, command);
+            }
+        }
+
+        RulesEngine::endTurn(state);
+        applyInflation(settings.inflationAt, state);
+        if (recording) {
+            command = GameReplay::Command();
+            command.kind = GameReplay::Command::Kind::EndTurn;
+            command.player = player;
+            command.inflationAt[0] = settings.inflationAt[0];
+            command.inflationAt[1] = settings.inflationAt[1];
+            replay.record(state, END_TURN_LABEL, true, command);
+        }
+    }
+
+    if (recording) {
+        for (std::unique_ptr<Bot> &bot : bots) {
+            bot->setReplay(nullptr);
+        }
+        std::string path = settings.replayDir + "/game-" + std::to_string(gameIndex) + "." + GameReplay::FILE_EXTENSION;
+        if (!replay.save(path)) {
+            std::fprintf(stderr, "Could not write %s\n", path.c_str());
+        }
+    }
+
+    result.rounds = std::min(state.turnNumber, settings.maxRounds);
+    result.winner = RulesEngine::winner(state);
+    if (result.winner == NO_PLAYER) {
+        result.adjudicated = true;
+        double bestValue = -1.0;
+        for (int seat = 0; seat < seats; ++seat) {
+            double value = MctsPlayer::evaluate(state, seat);
+            if (value > bestValue) {
+                bestValue = value;
+                result.winner = seat;
+            }
+        }
+    }
+    return result;
+}
+
+void Tournament::applyInflation(const int inflationAt[2], GameState &state)
+{
+    int richest = 0;
+    for (const PlayerState &player : state.players) {
+        if (!player.eliminated) {
+            richest = std::max(richest, player.wallet);
+        }
+    }
+
+    // Prices only ever go up
+    for (int level = 0; level < 2; ++level) {
+        if (inflationAt[level] > 0 && richest >= inflationAt[level]) {
+            state.inflationMultiplier = std::max(state.inflationMultiplier, level + 2);
+        }
+    }
+}
+
+// ========== Tournament ==========
+
+Tournament::Report Tournament::run(const Settings &settings)
+{
+    Report report;
+    int seats = static_cast<int>(settings.bots.size());
+    int threads = settings.threads > 0 ? settings.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(threads, settings.games)));
+    report.threads = threads;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Workers take the next game number until none are left; each has its own bots
+    std::vector<GameResult> results(settings.games > 0 ? settings.games : 0);
+    std::atomic<int64_t> nextGame(0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([&settings, &results, &nextGame]() {
+            std::vector<std::unique_ptr<Bot>> bots;
+            for (const std::string &name : settings.bots) {
+                bots.push_back(Bot::create(name, settings.mctsBudgetMs, settings.mctsIterations));
+            }
+            for (int64_t game = nextGame++; game < static_cast<int64_t>(results.size()); game = nextGame++) {
+                results[game] = playGame(settings, game, bots);
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.games = static_cast<int64_t>(results.size());
+    report.gamesPerSecond = report.seconds > 0.0 ? report.games / report.seconds : 0.0;
+    report.botGames.assign(seats, 0);
+    report.botWins.assign(seats, 0);
+    report.seatWins.assign(seats, 0);
+
+    int64_t totalRounds = 0;
+    for (const GameResult &result : results) {
+        totalRounds += result.rounds;
+        report.adjudicated += result.adjudicated;
+        for (int seat = 0; seat < seats; ++seat) {
+            bool won = (seat == result.winner);
+            int valueIndex = result.homeValues[seat] >= 10 ? 1 : 0;
+            report.botGames[result.seatBot[seat]]++;
+            report.botWins[result.seatBot[seat]] += won;
+            report.seatWins[seat] += won;
+            report.homeGames[result.homeTiles[seat]]++;
+            report.homeWins[result.homeTiles[seat]] += won;
+            report.homeValueGames[valueIndex]++;
+            report.homeValueWins[valueIndex] += won;
+        }
+    }
+    report.averageRounds = report.games > 0 ? static_cast<double>(totalRounds) / report.games : 0.0;
+    return report;
+}
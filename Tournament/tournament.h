@@ -0,0 +1,98 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "gamereplay.h"
+#include "gamestate.h"
+#include "rulesengine.h"
+
+// A computer player for self-play. Bots only decide; the tournament runs
+// combats, purchases and taxes through the RulesEngine like the UI does.
+class Bot
+{
+public:
+    virtual ~Bot() = default;
+
+    // Record every legion and move this bot makes as a replay step (nullptr to stop)
+    void setReplay(GameReplay *replay) { m_replay = replay; }
+
+    // Move the player's pieces for this turn
+    virtual void playMovement(GameState &state, int player, Xoshiro256 &random) = 0;
+
+    // Purchase phase (MctsPlayer's heuristic unless a bot knows better)
+    virtual RulesEngine::PurchaseOrder choosePurchase(const GameState &state, int player);
+
+    // "random", "greedy" or "mcts" (nullptr for anything else). mcts searches for
+    // mctsIterations playouts per movement phase if non-zero, else for mctsBudgetMs
+    static std::unique_ptr<Bot> create(const std::string &name, int mctsBudgetMs, int64_t mctsIterations = 0);
+    static std::vector<std::string> names();
+
+protected:
+    // The engine calls movement is made of, recorded when a replay is attached
+    void formLegions(GameState &state, int player);
+    void assignToLegions(GameState &state, int player, const std::vector<std::pair<int, int>> &legions);
+    void apply(GameState &state, int player, const Move &move);
+
+private:
+    GameReplay *m_replay = nullptr;
+};
+
+// Plays many full games between bots without widgets, spread over all cores.
+// Maps and home provinces come from RulesEngine::setupNewGame and taxes from
+// RulesEngine::endTurn (the engine ports of MapWidget, Player::collectTaxes
+// and the PurchaseDialog prices), so rule changes made there show up here.
+class Tournament
+{
+public:
+    struct Settings {
+        std::vector<std::string> bots = {"mcts", "greedy", "random", "random"};   // One per seat
+        int64_t games = 100;
+        int threads = 0;               // 0 = one per hardware thread
+        int maxRounds = 60;            // Unfinished games are adjudicated on position value
+        uint64_t seed = 1;             // Game i always gets the same map and dice (and moves, unless mcts runs on time)
+        bool rotateSeats = true;       // Bot b sits in seat (b + i) % seats in game i
+        int mctsBudgetMs = 100;        // Per movement phase
+        int64_t mctsIterations = 0;    // Playouts per movement phase instead of mctsBudgetMs (0 = use time)
+        int inflationAt[2] = {0, 0};   // Richest wallet that doubles / triples prices (0 = never)
+        std::string replayDir;         // Save game i as game-<i>.ctreplay here (empty = don't record)
+    };
+
+    struct GameResult {
+        int winner = NO_PLAYER;        // Seat
+        bool adjudicated = false;      // Hit maxRounds; winner has the best MctsPlayer::evaluate
+        int rounds = 0;
+        std::vector<int> seatBot;      // Index into Settings::bots per seat
+        std::vector<int> homeTiles;    // Per seat
+        std::vector<int> homeValues;   // Tax value of each seat's home province
+    };
+
+    struct Report {
+        int64_t games = 0;
+        int64_t adjudicated = 0;
+        double seconds = 0.0;
+        double gamesPerSecond = 0.0;
+        double averageRounds = 0.0;
+        int threads = 0;
+        std::vector<int64_t> botGames;                 // Per entry of Settings::bots
+        std::vector<int64_t> botWins;
+        std::vector<int64_t> seatWins;                 // Every game fills every seat
+        std::array<int64_t, BOARD_TILES> homeGames {};
+        std::array<int64_t, BOARD_TILES> homeWins {};
+        int64_t homeValueGames[2] = {0, 0};            // Home provinces worth 5 / 10 talents
+        int64_t homeValueWins[2] = {0, 0};
+    };
+
+    static Report run(const Settings &settings);
+
+    // One game with the given bots (indexed like Settings::bots)
+    static GameResult playGame(const Settings &settings, int64_t gameIndex, std::vector<std::unique_ptr<Bot>> &bots);
+
+    // Raise prices once the richest wallet reaches a threshold (0 = never)
+    static void applyInflation(const int inflationAt[2], GameState &state);
+};
+
+#endif // TOURNAMENT_H
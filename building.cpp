@@ -7,7 +7,7 @@ Building::Building(QChar owner, const Position &position, const QString &territo
     : QObject(parent)
     , m_owner(owner)
     , m_position(position)
-    , m_territoryName(territoryName)
+    , m_territoryId(TerritoryNames::idOf(territoryName))
 {
 }
 
@@ -19,6 +19,16 @@ City::City(QChar owner, const Position &position, const QString &territoryName,
 {
 }
 
+void City::setFortified(bool fortified)
+{
+    if (fortified == m_isFortified) {
+        return;
+    }
+
+    m_isFortified = fortified;
+    emit fortificationChanged(this, fortified);
+}
+
 void City::paint(QPainter &painter, int x, int y, int width, int height) const
 {
     // Draw city as a small square in the center of the tile
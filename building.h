@@ -30,13 +30,14 @@ public:
     Position getPosition() const { return m_position; }
     void setPosition(const Position &pos) { m_position = pos; }
 
-    QString getTerritoryName() const { return m_territoryName; }
-    void setTerritoryName(const QString &name) { m_territoryName = name; }
+    TerritoryId getTerritoryId() const { return m_territoryId; }
+    QString getTerritoryName() const { return TerritoryNames::nameOf(m_territoryId); }
+    void setTerritoryName(const QString &name) { m_territoryId = TerritoryNames::idOf(name); }
 
 protected:
     QChar m_owner;              // Which player owns this building
     Position m_position;        // Grid position
-    QString m_territoryName;    // Territory name where this building is located
+    TerritoryId m_territoryId;  // Territory where this building is located
 };
 
 // City class - can be fortified
@@ -52,9 +53,13 @@ public:
 
     // Fortification
     bool isFortified() const { return m_isFortified; }
-    void setFortified(bool fortified) { m_isFortified = fortified; }
-    void addFortification() { m_isFortified = true; }
-    void removeFortification() { m_isFortified = false; }
+    void setFortified(bool fortified);
+    void addFortification() { setFortified(true); }
+    void removeFortification() { setFortified(false); }
+
+signals:
+    // Lets the owning Player keep its Zobrist hash up to date
+    void fortificationChanged(City *city, bool fortified);
 
 private:
     bool m_isFortified;  // Does this city have walls/fortification?
@@ -0,0 +1,185 @@
+#ifndef BYTESTREAM_H
+#define BYTESTREAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tilemask.h"
+
+// Varint byte encoding shared by the binary save (SaveGame) and the autosave
+// journal (GameJournal). Counts are LEB128 varints, signed values are zigzag
+// encoded so small negatives stay one byte, and 64-bit words are little-endian.
+class ByteWriter
+{
+public:
+    void byte(uint8_t value) { m_data.push_back(static_cast<char>(value)); }
+
+    void count(uint64_t value)
+    {
+        while (value >= 0x80) {
+            byte(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        byte(static_cast<uint8_t>(value));
+    }
+
+    void integer(int value)
+    {
+        count((static_cast<uint64_t>(static_cast<int64_t>(value)) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63));
+    }
+
+    void word(uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i) {
+            byte(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    // Board positions as tile + 1, with 0 for off the board
+    void position(int row, int col) { count(isOnBoard(row, col) ? tileIndex(row, col) + 1 : 0); }
+    void tile(int tile) { count(tile >= 0 && tile < BOARD_TILES ? tile + 1 : 0); }
+
+    void mask(const TileMask &mask)
+    {
+        count(mask.lowWord());
+        count(mask.highWord());
+    }
+
+    void bytes(const std::string &text) { m_data.insert(m_data.end(), text.begin(), text.end()); }
+
+    void text(const std::string &text)
+    {
+        count(text.size());
+        bytes(text);
+    }
+
+    std::vector<char> &data() { return m_data; }
+
+private:
+    std::vector<char> m_data;
+};
+
+// Bounds-checked cursor over a ByteWriter's output; after the first error
+// every read returns 0 and ok() stays false
+class ByteReader
+{
+public:
+    ByteReader(const char *data, size_t size)
+        : m_pos(reinterpret_cast<const uint8_t*>(data))
+        , m_end(m_pos + size)
+        , m_ok(true)
+    {
+    }
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos == m_end; }
+    size_t remaining() const { return static_cast<size_t>(m_end - m_pos); }
+    const char *current() const { return reinterpret_cast<const char*>(m_pos); }
+
+    uint8_t byte()
+    {
+        if (m_pos == m_end) {
+            return fail();
+        }
+        return *m_pos++;
+    }
+
+    uint64_t count()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t next = byte();
+            value |= static_cast<uint64_t>(next & 0x7F) << shift;
+            if (!(next & 0x80)) {
+                return value;
+            }
+        }
+        return fail();
+    }
+
+    // A count of items that each take at least one byte, so garbage can't allocate gigabytes
+    size_t items()
+    {
+        uint64_t value = count();
+        if (value > remaining()) {
+            return fail();
+        }
+        return static_cast<size_t>(value);
+    }
+
+    int integer()
+    {
+        uint64_t value = count();
+        int64_t decoded = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        if (decoded < INT32_MIN || decoded > INT32_MAX) {
+            return fail();
+        }
+        return static_cast<int>(decoded);
+    }
+
+    uint64_t word()
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(byte()) << (8 * i);
+        }
+        return value;
+    }
+
+    void position(int &row, int &col)
+    {
+        int value = tile();
+        row = value == -1 ? -1 : tileRow(value);
+        col = value == -1 ? -1 : tileColumn(value);
+    }
+
+    // -1 for off the board
+    int tile()
+    {
+        uint64_t value = count();
+        if (value > BOARD_TILES) {
+            fail();
+            value = 0;
+        }
+        return static_cast<int>(value) - 1;
+    }
+
+    TileMask mask()
+    {
+        uint64_t low = count();
+        uint64_t high = count();
+        return TileMask(low, high);
+    }
+
+    std::string text()
+    {
+        size_t length = items();
+        std::string value(reinterpret_cast<const char*>(m_pos), m_ok ? length : 0);
+        m_pos += value.size();
+        return value;
+    }
+
+    // Skip size bytes (fails if there are fewer left)
+    void skip(size_t size)
+    {
+        if (size > remaining()) {
+            fail();
+            return;
+        }
+        m_pos += size;
+    }
+
+    uint8_t fail()
+    {
+        m_ok = false;
+        m_pos = m_end;
+        return 0;
+    }
+
+private:
+    const uint8_t *m_pos;
+    const uint8_t *m_end;
+    bool m_ok;
+};
+
+#endif // BYTESTREAM_H
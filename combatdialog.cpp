@@ -1,7 +1,11 @@
 #include "combatdialog.h"
+#include "gamestatebridge.h"
+#include "rulesengine.h"
+#include "combatodds.h"
+#include "gamerandom.h"
 #include <QDebug>
 #include <QMessageBox>
-#include <cstdlib>  // for rand()
+#include <QTimer>
 
 CombatDialog::CombatDialog(Player *attackingPlayer,
                            Player *defendingPlayer,
@@ -18,6 +22,7 @@ CombatDialog::CombatDialog(Player *attackingPlayer,
     , m_retreatButton(nullptr)
     , m_attackingHeader(nullptr)
     , m_defendingHeader(nullptr)
+    , m_oddsLabel(nullptr)
     , m_dieWidget(nullptr)
 {
     setWindowTitle("Combat Resolution");
@@ -72,6 +77,9 @@ CombatDialog::CombatDialog(Player *attackingPlayer,
             checkCombatEnd();
         });
         tempLayout->addWidget(okButton);
+        if (m_attackingPlayer->isComputerControlled()) {
+            QTimer::singleShot(COMPUTER_SHOT_DELAY_MS, okButton, &QPushButton::click);
+        }
 
         return;  // Skip normal combat dialog setup
     }
@@ -92,6 +100,9 @@ CombatDialog::CombatDialog(Player *attackingPlayer,
             checkCombatEnd();
         });
         tempLayout->addWidget(okButton);
+        if (m_attackingPlayer->isComputerControlled()) {
+            QTimer::singleShot(COMPUTER_SHOT_DELAY_MS, okButton, &QPushButton::click);
+        }
 
         return;  // Skip normal combat dialog setup
     }
@@ -123,6 +134,11 @@ CombatDialog::CombatDialog(Player *attackingPlayer,
 
     mainLayout->addLayout(combatLayout);
 
+    // Odds of the fight if both sides keep shooting at the easiest target
+    m_oddsLabel = new QLabel();
+    m_oddsLabel->setAlignment(Qt::AlignCenter);
+    mainLayout->addWidget(m_oddsLabel);
+
     // Bottom buttons
     QHBoxLayout *buttonLayout = new QHBoxLayout();
     buttonLayout->addStretch();
@@ -135,10 +151,12 @@ CombatDialog::CombatDialog(Player *attackingPlayer,
 
     // Update advantage display
     updateAdvantageDisplay();
+    updateOddsDisplay();
 
     // Initialize button states - only defender's troops are clickable
     setAttackingButtonsEnabled(false);  // Disable attacker's troops (not used in combat)
     setDefendingButtonsEnabled(true);   // Enable defender's troops for attacker to target
+    scheduleComputerShot();
 }
 
 QWidget* CombatDialog::createAttackingSide()
@@ -592,15 +610,8 @@ int CombatDialog::calculateDefenderAdvantage() const
 
 int CombatDialog::getNetAdvantage(bool forAttacker) const
 {
-    int attackerAdv = calculateAttackerAdvantage();
-    int defenderAdv = calculateDefenderAdvantage();
-    int difference = attackerAdv - defenderAdv;
-
-    if (forAttacker) {
-        return (difference > 0) ? difference : 0;  // Only positive for attacker
-    } else {
-        return (difference < 0) ? -difference : 0;  // Only positive for defender
-    }
+    // Defender advantage already includes the walled city bonus
+    return RulesEngine::netAdvantage(calculateAttackerAdvantage(), calculateDefenderAdvantage(), false, forAttacker);
 }
 
 void CombatDialog::updateAdvantageDisplay()
@@ -630,23 +641,50 @@ void CombatDialog::updateAdvantageDisplay()
     }
 }
 
+void CombatDialog::updateOddsDisplay()
+{
+    if (!m_oddsLabel) {
+        return;
+    }
+
+    auto countTroops = [](const QMap<QPushButton*, GamePiece*> &buttons) {
+        TroopCounts troops;
+        for (GamePiece *piece : buttons.values()) {
+            if (!piece) continue;
+            switch (piece->getType()) {
+                case GamePiece::Type::Infantry: ++troops.infantry; break;
+                case GamePiece::Type::Cavalry: ++troops.cavalry; break;
+                case GamePiece::Type::Catapult: ++troops.catapults; break;
+                default: break;
+            }
+        }
+        return troops;
+    };
+
+    City *city = m_defendingPlayer->getCityAtPosition(m_combatPosition);
+    bool fortified = city && city->isFortified();
+
+    const CombatOutcome &outcome = CombatOdds::outcome(countTroops(m_attackingTroopButtons),
+                                                       countTroops(m_defendingTroopButtons),
+                                                       fortified, m_isAttackersTurn);
+    m_oddsLabel->setText(QString("Player %1 wins: %2%   |   Expected losses: %3 / %4")
+                             .arg(m_attackingPlayer->getId())
+                             .arg(outcome.attackerWinProbability * 100.0, 0, 'f', 1)
+                             .arg(outcome.expectedAttackerLosses, 0, 'f', 1)
+                             .arg(outcome.expectedDefenderLosses, 0, 'f', 1));
+}
+
 bool CombatDialog::resolveAttack(GamePiece::Type targetType, int attackerAdvantage)
 {
     // Roll dice (1-6)
-    int roll = (qrand() % 6) + 1;
+    int roll = GameRandom::current().rollDie();
     int modifiedRoll = roll + attackerAdvantage;
 
     qDebug() << "Roll:" << roll << "+ Advantage:" << attackerAdvantage << "= Total:" << modifiedRoll;
 
     // Determine hit threshold based on target type
-    int hitThreshold;
-    if (targetType == GamePiece::Type::Infantry) {
-        hitThreshold = 4;
-    } else if (targetType == GamePiece::Type::Cavalry) {
-        hitThreshold = 5;
-    } else if (targetType == GamePiece::Type::Catapult) {
-        hitThreshold = 6;
-    } else {
+    int hitThreshold = RulesEngine::hitThreshold(GameStateBridge::toPieceKind(targetType));
+    if (hitThreshold == 0) {
         return false;  // Leaders can't be targeted
     }
 
@@ -750,8 +788,8 @@ bool CombatDialog::checkCombatEnd()
             m_attackingPlayer->addMoney(capturedMoney + 100);  // Add money + bonus
 
             // Transfer all territories
-            QList<QString> territories = m_defendingPlayer->getOwnedTerritories();
-            for (const QString &territory : territories) {
+            QList<TerritoryId> territories = m_defendingPlayer->getOwnedTerritoryIds();
+            for (TerritoryId territory : territories) {
                 m_defendingPlayer->unclaimTerritory(territory);
                 m_attackingPlayer->claimTerritory(territory);
             }
@@ -783,7 +821,9 @@ bool CombatDialog::checkCombatEnd()
                     // Return to original owner as active general
                     general->clearCaptured();
                     general->setParent(m_attackingPlayer);
-                    m_attackingPlayer->addGeneral(general);
+                    if (!m_attackingPlayer->getGenerals().contains(general)) {
+                        m_attackingPlayer->addGeneral(general);
+                    }
                 } else {
                     // Transfer as captured general to winner
                     general->setCapturedBy(m_attackingPlayer->getId());
@@ -871,26 +911,32 @@ bool CombatDialog::checkCombatEnd()
         for (GeneralPiece *general : defeatedGenerals) {
             qDebug() << "Processing defeated general" << general->getPlayer() << "#" << general->getNumber();
 
-            QMessageBox msgBox(this);
-            msgBox.setWindowTitle("Capture or Kill General?");
-            msgBox.setText(QString("Defender's General %1 #%2 has been defeated.\n\nDo you want to capture this general?")
-                .arg(general->getPlayer())
-                .arg(general->getNumber()));
-            QPushButton *captureButton = msgBox.addButton("Capture", QMessageBox::YesRole);
-            QPushButton *killButton = msgBox.addButton("Kill", QMessageBox::NoRole);
-            msgBox.exec();
-
-            QMessageBox::StandardButton choice = (msgBox.clickedButton() == captureButton)
-                ? QMessageBox::Yes : QMessageBox::No;
+            // The computer always takes prisoners (they can be ransomed)
+            QMessageBox::StandardButton choice = QMessageBox::Yes;
+            if (!m_attackingPlayer->isComputerControlled()) {
+                QMessageBox msgBox(this);
+                msgBox.setWindowTitle("Capture or Kill General?");
+                msgBox.setText(QString("Defender's General %1 #%2 has been defeated.\n\nDo you want to capture this general?")
+                    .arg(general->getPlayer())
+                    .arg(general->getNumber()));
+                QPushButton *captureButton = msgBox.addButton("Capture", QMessageBox::YesRole);
+                msgBox.addButton("Kill", QMessageBox::NoRole);
+                msgBox.exec();
+
+                choice = (msgBox.clickedButton() == captureButton)
+                    ? QMessageBox::Yes : QMessageBox::No;
+            }
 
             if (choice == QMessageBox::Yes) {
                 qDebug() << "Capturing general";
-                // Capture the general
-                // Mark as captured (keeps general in original player's list)
+                // Capture the general: it leaves its owner's list (and tile index) before it is
+                // marked, so only the captor's captured list holds it
+                m_defendingPlayer->removeGeneral(general);
                 general->setCapturedBy(m_attackingPlayer->getId());
+                general->clearLegion();
                 // Move to attacker's position
                 general->setPosition(m_combatPosition);
-                // Add to attacker's captured list (for easy reference)
+                general->setParent(m_attackingPlayer);
                 m_attackingPlayer->addCapturedGeneral(general);
                 qDebug() << "General captured successfully";
             } else {
@@ -903,13 +949,14 @@ bool CombatDialog::checkCombatEnd()
         }
 
         // Transfer territory ownership
-        QString territoryName = m_mapWidget->getTerritoryNameAt(m_combatPosition.row, m_combatPosition.col);
+        TerritoryId territory = territoryIdAt(m_combatPosition);
+        QString territoryName = TerritoryNames::nameOf(territory);
 
         // Remove territory from defender
-        m_defendingPlayer->unclaimTerritory(territoryName);
+        m_defendingPlayer->unclaimTerritory(territory);
 
         // Add territory to attacker
-        m_attackingPlayer->claimTerritory(territoryName);
+        m_attackingPlayer->claimTerritory(territory);
 
         // Transfer any cities at this position from defender to attacker
         City *city = m_defendingPlayer->getCityAtPosition(m_combatPosition);
@@ -1033,8 +1080,8 @@ bool CombatDialog::checkCombatEnd()
             m_defendingPlayer->addMoney(capturedMoney + 100);  // Add money + bonus
 
             // Transfer all territories
-            QList<QString> territories = m_attackingPlayer->getOwnedTerritories();
-            for (const QString &territory : territories) {
+            QList<TerritoryId> territories = m_attackingPlayer->getOwnedTerritoryIds();
+            for (TerritoryId territory : territories) {
                 m_attackingPlayer->unclaimTerritory(territory);
                 m_defendingPlayer->claimTerritory(territory);
             }
@@ -1066,7 +1113,9 @@ bool CombatDialog::checkCombatEnd()
                     // Return to original owner as active general
                     general->clearCaptured();
                     general->setParent(m_defendingPlayer);
-                    m_defendingPlayer->addGeneral(general);
+                    if (!m_defendingPlayer->getGenerals().contains(general)) {
+                        m_defendingPlayer->addGeneral(general);
+                    }
                 } else {
                     // Transfer as captured general to winner
                     general->setCapturedBy(m_defendingPlayer->getId());
@@ -1154,26 +1203,32 @@ bool CombatDialog::checkCombatEnd()
         for (GeneralPiece *general : defeatedGenerals) {
             qDebug() << "Processing defeated general" << general->getPlayer() << "#" << general->getNumber();
 
-            QMessageBox msgBox(this);
-            msgBox.setWindowTitle("Capture or Kill General?");
-            msgBox.setText(QString("Attacker's General %1 #%2 has been defeated.\n\nDo you want to capture this general?")
-                .arg(general->getPlayer())
-                .arg(general->getNumber()));
-            QPushButton *captureButton = msgBox.addButton("Capture", QMessageBox::YesRole);
-            QPushButton *killButton = msgBox.addButton("Kill", QMessageBox::NoRole);
-            msgBox.exec();
-
-            QMessageBox::StandardButton choice = (msgBox.clickedButton() == captureButton)
-                ? QMessageBox::Yes : QMessageBox::No;
+            // The computer always takes prisoners (they can be ransomed)
+            QMessageBox::StandardButton choice = QMessageBox::Yes;
+            if (!m_defendingPlayer->isComputerControlled()) {
+                QMessageBox msgBox(this);
+                msgBox.setWindowTitle("Capture or Kill General?");
+                msgBox.setText(QString("Attacker's General %1 #%2 has been defeated.\n\nDo you want to capture this general?")
+                    .arg(general->getPlayer())
+                    .arg(general->getNumber()));
+                QPushButton *captureButton = msgBox.addButton("Capture", QMessageBox::YesRole);
+                msgBox.addButton("Kill", QMessageBox::NoRole);
+                msgBox.exec();
+
+                choice = (msgBox.clickedButton() == captureButton)
+                    ? QMessageBox::Yes : QMessageBox::No;
+            }
 
             if (choice == QMessageBox::Yes) {
                 qDebug() << "Capturing general";
-                // Capture the general
-                // Mark as captured (keeps general in original player's list)
+                // Capture the general: it leaves its owner's list (and tile index) before it is
+                // marked, so only the captor's captured list holds it
+                m_attackingPlayer->removeGeneral(general);
                 general->setCapturedBy(m_defendingPlayer->getId());
+                general->clearLegion();
                 // Keep at current position (defender's territory)
                 general->setPosition(m_combatPosition);
-                // Add to defender's captured list (for easy reference)
+                general->setParent(m_defendingPlayer);
                 m_defendingPlayer->addCapturedGeneral(general);
                 qDebug() << "General captured successfully";
             } else {
@@ -1246,17 +1301,12 @@ void CombatDialog::onRollComplete(int dieValue, QObject *sender)
     qDebug() << "Roll:" << dieValue << "+ Advantage:" << advantage << "= Total:" << modifiedRoll;
 
     // Determine hit threshold based on target type
-    int hitThreshold;
     GamePiece::Type targetType = targetPiece->getType();
-    if (targetType == GamePiece::Type::Infantry) {
-        hitThreshold = 4;
-    } else if (targetType == GamePiece::Type::Cavalry) {
-        hitThreshold = 5;
-    } else if (targetType == GamePiece::Type::Catapult) {
-        hitThreshold = 6;
-    } else {
+    int hitThreshold = RulesEngine::hitThreshold(GameStateBridge::toPieceKind(targetType));
+    if (hitThreshold == 0) {
         setDefendingButtonsEnabled(true);
         setAttackingButtonsEnabled(false);
+        scheduleComputerShot();
         return;  // Leaders cannot be targeted
     }
 
@@ -1277,7 +1327,13 @@ Rolled %2 + %3 advantage = %4 (needed %5)")
                             .arg(dieValue).arg(advantage).arg(modifiedRoll).arg(hitThreshold);
     }
 
-    QMessageBox::information(this, "Combat Result", resultMessage);
+    // The die shows the computer's rolls; only people confirm their own
+    Player *shootingPlayer = isAttackersTurn ? m_attackingPlayer : m_defendingPlayer;
+    if (!shootingPlayer->isComputerControlled()) {
+        QMessageBox::information(this, "Combat Result", resultMessage);
+    } else {
+        qDebug() << resultMessage;
+    }
 
     // Remove the troop if it was hit
     if (isHit) {
@@ -1310,4 +1366,38 @@ Rolled %2 + %3 advantage = %4 (needed %5)")
         setDefendingButtonsEnabled(true);
         setAttackingButtonsEnabled(false);
     }
+    m_isAttackersTurn = !isAttackersTurn;
+    updateOddsDisplay();
+    scheduleComputerShot();
+}
+
+void CombatDialog::scheduleComputerShot()
+{
+    Player *shooter = m_isAttackersTurn ? m_attackingPlayer : m_defendingPlayer;
+    if (shooter->isComputerControlled()) {
+        QTimer::singleShot(COMPUTER_SHOT_DELAY_MS, this, &CombatDialog::takeComputerShot);
+    }
+}
+
+void CombatDialog::takeComputerShot()
+{
+    if (!isVisible()) {
+        return;  // The combat ended (e.g. a retreat) while the shot was pending
+    }
+
+    // Same choice as the odds display and RulesEngine: infantry, then cavalry, then catapults
+    const QMap<QPushButton*, GamePiece*> &targets = m_isAttackersTurn ? m_defendingTroopButtons : m_attackingTroopButtons;
+    QPushButton *target = nullptr;
+    int targetThreshold = 0;
+    for (auto it = targets.constBegin(); it != targets.constEnd(); ++it) {
+        int threshold = RulesEngine::hitThreshold(GameStateBridge::toPieceKind(it.value()->getType()));
+        if (threshold > 0 && (!target || threshold < targetThreshold)) {
+            target = it.key();
+            targetThreshold = threshold;
+        }
+    }
+
+    if (target) {
+        target->click();
+    }
 }
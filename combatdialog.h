@@ -31,8 +31,15 @@ private slots:
     void onDefendingTroopClicked();
     void onRetreatClicked();
     void onRollComplete(int value, QObject *sender);
+    void takeComputerShot();
 
 private:
+    // Pause before a computer-controlled side fires, so people can follow the fight
+    static constexpr int COMPUTER_SHOT_DELAY_MS = 600;
+
+    // Fire for the side to shoot next if the computer plays it
+    void scheduleComputerShot();
+
     // Create the attacking side (left)
     QWidget* createAttackingSide();
 
@@ -60,6 +67,9 @@ private:
     // Update group box titles with advantages
     void updateAdvantageDisplay();
 
+    // Show the exact chance of winning from the troops left and the side to shoot next
+    void updateOddsDisplay();
+
     // Combat resolution
     bool resolveAttack(GamePiece::Type targetType, int attackerAdvantage);
     void removeTroopButton(QPushButton *button);
@@ -94,6 +104,9 @@ private:
     QLabel *m_attackingHeader;
     QLabel *m_defendingHeader;
 
+    // Win probability for the attacker
+    QLabel *m_oddsLabel;
+
     // Rolling die widget
     LAURollingDieWidget *m_dieWidget;
 };
@@ -0,0 +1,179 @@
+#include "combatodds.h"
+#include "rulesengine.h"
+
+std::mutex CombatOdds::s_cacheMutex;
+std::unordered_map<uint64_t, CombatOutcome> CombatOdds::s_cache;
+
+// Side after losing its first `losses` troops (easiest to hit go first)
+static TroopCounts afterLosses(const TroopCounts &troops, int losses)
+{
+    TroopCounts remaining = troops;
+    int lost = losses < remaining.infantry ? losses : remaining.infantry;
+    remaining.infantry -= lost;
+    losses -= lost;
+    lost = losses < remaining.cavalry ? losses : remaining.cavalry;
+    remaining.cavalry -= lost;
+    losses -= lost;
+    remaining.catapults -= losses;
+    return remaining;
+}
+
+// Chance that one shot at the easiest target of `target` hits
+static double hitChance(const TroopCounts &target, int advantage)
+{
+    PieceKind kind = target.infantry > 0 ? PieceKind::Infantry
+                   : target.cavalry > 0 ? PieceKind::Cavalry
+                   : PieceKind::Catapult;
+    int needed = RulesEngine::hitThreshold(kind) - advantage;
+    int faces = 7 - (needed < 1 ? 1 : needed);
+    return faces <= 0 ? 0.0 : faces / 6.0;
+}
+
+TroopCounts CombatOdds::troopsAt(const GameState &state, int player, int tile)
+{
+    TroopCounts troops;
+    for (const PieceState &piece : *state.players[player].pieces) {
+        if (piece.tile != tile) {
+            continue;
+        }
+        switch (piece.kind) {
+            case PieceKind::Infantry: ++troops.infantry; break;
+            case PieceKind::Cavalry: ++troops.cavalry; break;
+            case PieceKind::Catapult: ++troops.catapults; break;
+            default: break;
+        }
+    }
+    return troops;
+}
+
+const CombatOutcome &CombatOdds::outcome(const TroopCounts &attacker, const TroopCounts &defender,
+                                         bool defenderFortified, bool attackerShootsFirst)
+{
+    uint64_t key = cacheKey(attacker, defender, defenderFortified, attackerShootsFirst);
+    {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        auto it = s_cache.find(key);
+        if (it != s_cache.end()) {
+            return it->second;
+        }
+    }
+
+    // Solve outside the lock; if another thread got there first its entry wins
+    CombatOutcome result = compute(attacker, defender, defenderFortified, attackerShootsFirst);
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+    return s_cache.emplace(key, std::move(result)).first->second;
+}
+
+const CombatOutcome &CombatOdds::outcome(const GameState &state, int tile, int attacker, int defender)
+{
+    return outcome(troopsAt(state, attacker, tile), troopsAt(state, defender, tile),
+                   state.players[defender].fortifiedCities.test(tile));
+}
+
+CombatOutcome CombatOdds::compute(const TroopCounts &attacker, const TroopCounts &defender,
+                                  bool defenderFortified, bool attackerShootsFirst)
+{
+    CombatOutcome result;
+    int attackerTroops = attacker.total();
+    int defenderTroops = defender.total();
+    if (attackerTroops == 0 && defenderTroops == 0) {
+        return result;
+    }
+    result.fought = true;
+    result.attackerWinsAfterLosses.assign(attackerTroops, 0.0);
+    result.defenderWinsAfterLosses.assign(defenderTroops, 0.0);
+
+    // Nothing to roll when one side is already empty
+    if (defenderTroops == 0) {
+        result.attackerWinProbability = 1.0;
+        result.attackerWinsAfterLosses[0] = 1.0;
+        return result;
+    }
+    if (attackerTroops == 0) {
+        result.defenderWinsAfterLosses[0] = 1.0;
+        return result;
+    }
+
+    // Probability of reaching (attacker losses i, defender losses j) with the attacker / defender to shoot
+    int stride = defenderTroops + 1;
+    std::vector<double> attackerToShoot((attackerTroops + 1) * stride, 0.0);
+    std::vector<double> defenderToShoot((attackerTroops + 1) * stride, 0.0);
+    (attackerShootsFirst ? attackerToShoot : defenderToShoot)[0] = 1.0;
+
+    // Every transition costs one side a troop, so sweep by total losses
+    for (int total = 0; total < attackerTroops + defenderTroops; ++total) {
+        int firstLoss = total > defenderTroops - 1 ? total - (defenderTroops - 1) : 0;
+        int lastLoss = total < attackerTroops - 1 ? total : attackerTroops - 1;
+        for (int i = firstLoss; i <= lastLoss; ++i) {
+            int j = total - i;
+            double fromAttacker = attackerToShoot[i * stride + j];
+            double fromDefender = defenderToShoot[i * stride + j];
+            if (fromAttacker == 0.0 && fromDefender == 0.0) {
+                continue;
+            }
+
+            TroopCounts attackers = afterLosses(attacker, i);
+            TroopCounts defenders = afterLosses(defender, j);
+            int attackerAdvantage = RulesEngine::netAdvantage(attackers.catapults, defenders.catapults,
+                                                              defenderFortified, true);
+            int defenderAdvantage = RulesEngine::netAdvantage(attackers.catapults, defenders.catapults,
+                                                              defenderFortified, false);
+            double attackerHits = hitChance(defenders, attackerAdvantage);
+            double defenderHits = hitChance(attackers, defenderAdvantage);
+
+            // Fold the miss-miss loop back into the state: someone is eventually hit
+            double someoneHit = 1.0 - (1.0 - attackerHits) * (1.0 - defenderHits);
+            double defenderLoses = (fromAttacker + fromDefender * (1.0 - defenderHits)) * attackerHits / someoneHit;
+            double attackerLoses = (fromAttacker * (1.0 - attackerHits) + fromDefender) * defenderHits / someoneHit;
+
+            // After a hit the other side shoots next
+            if (j + 1 == defenderTroops) {
+                result.attackerWinsAfterLosses[i] += defenderLoses;
+            } else {
+                defenderToShoot[i * stride + j + 1] += defenderLoses;
+            }
+            if (i + 1 == attackerTroops) {
+                result.defenderWinsAfterLosses[j] += attackerLoses;
+            } else {
+                attackerToShoot[(i + 1) * stride + j] += attackerLoses;
+            }
+        }
+    }
+
+    for (int k = 0; k < attackerTroops; ++k) {
+        double p = result.attackerWinsAfterLosses[k];
+        result.attackerWinProbability += p;
+        result.expectedAttackerLosses += p * k;
+        result.expectedDefenderLosses += p * defenderTroops;
+    }
+    for (int k = 0; k < defenderTroops; ++k) {
+        double p = result.defenderWinsAfterLosses[k];
+        result.expectedDefenderLosses += p * k;
+        result.expectedAttackerLosses += p * attackerTroops;
+    }
+    return result;
+}
+
+void CombatOdds::clearCache()
+{
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+    s_cache.clear();
+}
+
+int CombatOdds::cacheSize()
+{
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+    return static_cast<int>(s_cache.size());
+}
+
+uint64_t CombatOdds::cacheKey(const TroopCounts &attacker, const TroopCounts &defender,
+                              bool defenderFortified, bool attackerShootsFirst)
+{
+    // 8 bits per count is plenty: the game box holds at most 60 of any troop
+    uint64_t key = 0;
+    for (int count : {attacker.infantry, attacker.cavalry, attacker.catapults,
+                      defender.infantry, defender.cavalry, defender.catapults}) {
+        key = (key << 8) | static_cast<uint8_t>(count);
+    }
+    return (key << 2) | (defenderFortified ? 2u : 0u) | (attackerShootsFirst ? 1u : 0u);
+}
@@ -0,0 +1,68 @@
+#ifndef COMBATODDS_H
+#define COMBATODDS_H
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "gamestate.h"
+
+// Troops on one side of a fight (leaders and galleys do not take part)
+struct TroopCounts
+{
+    int infantry = 0;
+    int cavalry = 0;
+    int catapults = 0;
+
+    int total() const { return infantry + cavalry + catapults; }
+};
+
+// Exact result distribution of a fight to the end
+struct CombatOutcome
+{
+    bool fought = false;                          // False if neither side has troops
+    double attackerWinProbability = 0.0;
+    double expectedAttackerLosses = 0.0;
+    double expectedDefenderLosses = 0.0;
+    std::vector<double> attackerWinsAfterLosses;  // [k] = P(attacker wins having lost k troops)
+    std::vector<double> defenderWinsAfterLosses;  // [k] = P(defender wins having lost k troops)
+};
+
+// Exact combat odds for RulesEngine::resolveCombat, without rolling dice.
+//
+// Each shot hits the easiest enemy troop (infantry, then cavalry, then
+// catapults), so the fight is a Markov chain whose state is just the losses
+// on each side plus who shoots next. A miss followed by a miss returns to the
+// same state; folding that loop into the transitions leaves a chain where
+// every step costs someone a troop, solved exactly in one pass over
+// (attacker losses, defender losses). Results are memoized by the two troop
+// compositions, the fortification and the side to shoot first.
+class CombatOdds
+{
+public:
+    // Troops a player has on a tile
+    static TroopCounts troopsAt(const GameState &state, int player, int tile);
+
+    // Memoized outcome (thread-safe; the reference stays valid until clearCache)
+    static const CombatOutcome &outcome(const TroopCounts &attacker, const TroopCounts &defender,
+                                        bool defenderFortified, bool attackerShootsFirst = true);
+
+    // Outcome of resolveCombat(state, tile, attacker, defender) as the board stands
+    static const CombatOutcome &outcome(const GameState &state, int tile, int attacker, int defender);
+
+    // Uncached calculation
+    static CombatOutcome compute(const TroopCounts &attacker, const TroopCounts &defender,
+                                 bool defenderFortified, bool attackerShootsFirst = true);
+
+    static void clearCache();
+    static int cacheSize();
+
+private:
+    static uint64_t cacheKey(const TroopCounts &attacker, const TroopCounts &defender,
+                             bool defenderFortified, bool attackerShootsFirst);
+
+    static std::mutex s_cacheMutex;
+    static std::unordered_map<uint64_t, CombatOutcome> s_cache;
+};
+
+#endif // COMBATODDS_H
@@ -0,0 +1,129 @@
+#include "combatsimulator.h"
+#include "fastrng.h"
+#include "rulesengine.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// Troop slots in target order (easiest to hit first)
+static const PieceKind TROOP_KINDS[3] = { PieceKind::Infantry, PieceKind::Cavalry, PieceKind::Catapult };
+static const int CATAPULT_SLOT = 2;
+
+static int chooseTarget(const int troops[3], int total, CombatSimulator::TargetPolicy policy, Xoshiro256 &random)
+{
+    switch (policy) {
+        case CombatSimulator::TargetPolicy::Easiest:
+            return troops[0] > 0 ? 0 : troops[1] > 0 ? 1 : 2;
+        case CombatSimulator::TargetPolicy::Hardest:
+            return troops[2] > 0 ? 2 : troops[1] > 0 ? 1 : 0;
+        case CombatSimulator::TargetPolicy::Random: {
+            int pick = static_cast<int>(random.bounded(static_cast<uint32_t>(total)));
+            return pick < troops[0] ? 0 : pick < troops[0] + troops[1] ? 1 : 2;
+        }
+    }
+    return 0;
+}
+
+CombatSimulator::Report CombatSimulator::run(const Settings &settings)
+{
+    Report report;
+    int threads = settings.threads > 0 ? settings.threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (settings.combats < threads) {
+        threads = settings.combats > 0 ? static_cast<int>(settings.combats) : 1;
+    }
+    report.threads = threads;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Every worker gets its own jump-separated stream and an even share of the fights
+    std::vector<Tally> tallies(threads);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        int64_t share = settings.combats / threads + (i < settings.combats % threads ? 1 : 0);
+        workers.emplace_back(simulate, std::cref(settings), share, settings.seed, i, std::ref(tallies[i]));
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    Tally total;
+    for (const Tally &tally : tallies) {
+        total.attackerWins += tally.attackerWins;
+        total.attackerLosses += tally.attackerLosses;
+        total.defenderLosses += tally.defenderLosses;
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.combats = settings.combats > 0 ? settings.combats : 0;
+    report.attackerWins = total.attackerWins;
+    if (report.combats == 0) {
+        return report;
+    }
+
+    double n = static_cast<double>(report.combats);
+    double rate = total.attackerWins / n;
+    report.attackerWinRate = rate;
+    report.meanAttackerLosses = total.attackerLosses / n;
+    report.meanDefenderLosses = total.defenderLosses / n;
+    report.combatsPerSecond = report.seconds > 0.0 ? n / report.seconds : 0.0;
+
+    // Wilson score interval stays inside [0, 1] even for lopsided fights
+    const double z = 1.96;
+    double denominator = 1.0 + z * z / n;
+    double centre = (rate + z * z / (2.0 * n)) / denominator;
+    double halfWidth = z * std::sqrt(rate * (1.0 - rate) / n + z * z / (4.0 * n * n)) / denominator;
+    report.confidenceLow = centre - halfWidth;
+    report.confidenceHigh = centre + halfWidth;
+    return report;
+}
+
+void CombatSimulator::simulate(const Settings &settings, int64_t combats, uint64_t streamSeed, int stream, Tally &tally)
+{
+    Xoshiro256 random(streamSeed);
+    for (int i = 0; i < stream; ++i) {
+        random.jump();
+    }
+    DiceBatch dice(random);
+
+    const int startAttackers[3] = { settings.attacker.infantry, settings.attacker.cavalry, settings.attacker.catapults };
+    const int startDefenders[3] = { settings.defender.infantry, settings.defender.cavalry, settings.defender.catapults };
+    const int attackerTotal = settings.attacker.total();
+    const int defenderTotal = settings.defender.total();
+
+    Tally local;
+    for (int64_t combat = 0; combat < combats; ++combat) {
+        int attackers[3] = { startAttackers[0], startAttackers[1], startAttackers[2] };
+        int defenders[3] = { startDefenders[0], startDefenders[1], startDefenders[2] };
+        int attackersLeft = attackerTotal;
+        int defendersLeft = defenderTotal;
+        bool attackersTurn = settings.attackerShootsFirst;
+
+        while (attackersLeft > 0 && defendersLeft > 0) {
+            int *targets = attackersTurn ? defenders : attackers;
+            int &targetsLeft = attackersTurn ? defendersLeft : attackersLeft;
+            TargetPolicy policy = attackersTurn ? settings.attackerTargets : settings.defenderTargets;
+
+            int slot = chooseTarget(targets, targetsLeft, policy, random);
+            int advantage = RulesEngine::netAdvantage(attackers[CATAPULT_SLOT], defenders[CATAPULT_SLOT],
+                                                      settings.defenderFortified, attackersTurn);
+            if (RulesEngine::isHit(TROOP_KINDS[slot], dice.roll(), advantage)) {
+                --targets[slot];
+                --targetsLeft;
+            }
+            attackersTurn = !attackersTurn;
+        }
+
+        // Same rule as resolveCombat: the attacker wins only by clearing the defenders
+        if (defendersLeft == 0 && attackerTotal > 0) {
+            ++local.attackerWins;
+        }
+        local.attackerLosses += attackerTotal - attackersLeft;
+        local.defenderLosses += defenderTotal - defendersLeft;
+    }
+
+    tally = local;
+}
@@ -0,0 +1,58 @@
+#ifndef COMBATSIMULATOR_H
+#define COMBATSIMULATOR_H
+
+#include <cstdint>
+#include "combatodds.h"
+
+// Monte Carlo simulation of CombatDialog fights. In the dialog each player
+// picks the troop to shoot at, which the exact CombatOdds model (always the
+// easiest target) cannot capture; here each side follows a targeting policy
+// and millions of fights are rolled across all cores with the same hit
+// thresholds and catapult/fortification advantage as RulesEngine.
+class CombatSimulator
+{
+public:
+    enum class TargetPolicy {
+        Easiest,    // Infantry, then cavalry, then catapults (RulesEngine::resolveCombat)
+        Hardest,    // Catapults first: remove the enemy's advantage
+        Random      // Any enemy troop, uniformly
+    };
+
+    struct Settings {
+        TroopCounts attacker;
+        TroopCounts defender;
+        bool defenderFortified = false;
+        bool attackerShootsFirst = true;
+        TargetPolicy attackerTargets = TargetPolicy::Easiest;
+        TargetPolicy defenderTargets = TargetPolicy::Easiest;
+        int64_t combats = 1000000;
+        int threads = 0;          // 0 = one per hardware thread
+        uint64_t seed = 0;        // Same seed and thread count give the same report
+    };
+
+    struct Report {
+        int64_t combats = 0;
+        int64_t attackerWins = 0;
+        double attackerWinRate = 0.0;
+        double confidenceLow = 0.0;       // 95% Wilson interval on the win rate
+        double confidenceHigh = 0.0;
+        double meanAttackerLosses = 0.0;
+        double meanDefenderLosses = 0.0;
+        double seconds = 0.0;
+        double combatsPerSecond = 0.0;
+        int threads = 0;
+    };
+
+    static Report run(const Settings &settings);
+
+private:
+    struct Tally {
+        int64_t attackerWins = 0;
+        int64_t attackerLosses = 0;
+        int64_t defenderLosses = 0;
+    };
+
+    static void simulate(const Settings &settings, int64_t combats, uint64_t streamSeed, int stream, Tally &tally);
+};
+
+#endif // COMBATSIMULATOR_H
@@ -2,6 +2,9 @@
 #define COMMON_H
 
 #include <QString>
+#include <QHash>
+#include <QVector>
+#include "tilemask.h"
 
 // Position struct - unified across the codebase
 struct Position {
@@ -24,12 +27,72 @@ struct Position {
     }
 };
 
-// Territory location - can be identified by name or position
+// Interned territory key: the tile index (row * BOARD_COLUMNS + col) of the territory.
+// Model code compares these; names are only looked up for display and save files.
+typedef int TerritoryId;
+static constexpr TerritoryId NO_TERRITORY = -1;
+
+inline TerritoryId territoryIdAt(const Position &pos)
+{
+    return isOnBoard(pos.row, pos.col) ? tileIndex(pos.row, pos.col) : NO_TERRITORY;
+}
+
+inline Position territoryPosition(TerritoryId id)
+{
+    return id == NO_TERRITORY ? Position{-1, -1} : Position{tileRow(id), tileColumn(id)};
+}
+
+// Name <-> TerritoryId intern table, filled by MapWidget whenever territories are named
+class TerritoryNames
+{
+public:
+    static void registerName(TerritoryId id, const QString &name)
+    {
+        if (id < 0 || id >= BOARD_TILES) {
+            return;
+        }
+        if (s_names.isEmpty()) {
+            s_names.resize(BOARD_TILES);
+        }
+
+        // Forget the tile's previous name before interning the new one
+        if (!s_names[id].isEmpty() && s_ids.value(s_names[id], NO_TERRITORY) == id) {
+            s_ids.remove(s_names[id]);
+        }
+        s_names[id] = name;
+        if (!name.isEmpty()) {
+            s_ids.insert(name, id);
+        }
+    }
+
+    static void clear()
+    {
+        s_ids.clear();
+        s_names.clear();
+    }
+
+    static TerritoryId idOf(const QString &name) { return s_ids.value(name, NO_TERRITORY); }
+
+    static QString nameOf(TerritoryId id)
+    {
+        return (id >= 0 && id < s_names.size()) ? s_names[id] : QString();
+    }
+
+private:
+    static inline QHash<QString, TerritoryId> s_ids;
+    static inline QVector<QString> s_names;
+};
+
+// Territory location - can be identified by name, position or interned id
 struct TerritoryLocation {
-    QString name;       // Unique territory name (e.g., "Lion", "Tiger")
-    Position position;  // Grid position (row, col)
+    QString name;                   // Unique territory name (e.g., "Lion", "Tiger")
+    Position position;              // Grid position (row, col)
+    TerritoryId id = NO_TERRITORY;  // Interned key used for comparisons
 
     bool operator==(const TerritoryLocation &other) const {
+        if (id != NO_TERRITORY || other.id != NO_TERRITORY) {
+            return id == other.id;
+        }
         return name == other.name && position == other.position;
     }
 };
@@ -0,0 +1,43 @@
+#ifndef COWPTR_H
+#define COWPTR_H
+
+#include <atomic>
+#include <memory>
+
+// Copy-on-write handle, the engine's Qt-free take on implicit sharing:
+// copies share one T, and write() clones it first if any other copy still
+// holds it. Copying a GameState is then a handful of reference count bumps,
+// and a move only pays for the parts it changes. Shared data is only ever
+// read, so snapshots can be handed to other threads; each copy must be
+// written by one thread at a time, like any other value.
+//
+// Take write() before keeping a reference you will write through; a
+// reference taken from a shared copy stays pointed at the shared data.
+template <typename T>
+class CowPtr
+{
+public:
+    CowPtr() : m_data(std::make_shared<T>()) {}
+
+    const T &operator*() const { return *m_data; }
+    const T *operator->() const { return m_data.get(); }
+
+    T &write()
+    {
+        if (m_data.use_count() != 1) {
+            m_data = std::make_shared<T>(*m_data);
+        } else {
+            // use_count() is a relaxed load: order our writes after another thread's
+            // last reads through a copy it has just released
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *m_data;
+    }
+
+    bool isSharedWith(const CowPtr &other) const { return m_data == other.m_data; }
+
+private:
+    std::shared_ptr<T> m_data;
+};
+
+#endif // COWPTR_H
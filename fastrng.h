@@ -0,0 +1,168 @@
+#ifndef FASTRNG_H
+#define FASTRNG_H
+
+#include <cstdint>
+
+// xoshiro256** (Blackman & Vigna): small, fast, and good enough for dice.
+// Headless simulations use it where std::mt19937 would dominate the run time.
+class Xoshiro256
+{
+public:
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+
+    // Expand a 64-bit seed into the 256-bit state with splitmix64
+    void reseed(uint64_t seed)
+    {
+        for (uint64_t &word : m_state) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next()
+    {
+        uint64_t result = rotateLeft(m_state[1] * 5, 7) * 9;
+        uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotateLeft(m_state[3], 45);
+        return result;
+    }
+
+    // Advance 2^128 steps: gives non-overlapping streams for parallel workers
+    void jump()
+    {
+        static const uint64_t JUMP[] = {
+            0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+        };
+        uint64_t jumped[4] = {0, 0, 0, 0};
+        for (uint64_t mask : JUMP) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (mask & (1ULL << bit)) {
+                    for (int i = 0; i < 4; ++i) {
+                        jumped[i] ^= m_state[i];
+                    }
+                }
+                next();
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            m_state[i] = jumped[i];
+        }
+    }
+
+    // Unbiased integer in [0, bound) (Lemire's multiply-shift with rejection)
+    uint32_t bounded(uint32_t bound)
+    {
+        uint64_t product = (next() >> 32) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    // Unbiased integer in [low, high]
+    int uniform(int low, int high)
+    {
+        return low + static_cast<int>(bounded(static_cast<uint32_t>(high - low + 1)));
+    }
+
+    // Fisher-Yates shuffle; unlike std::shuffle the order is the same on every standard library
+    template<typename Iterator>
+    void shuffle(Iterator first, Iterator last)
+    {
+        for (auto count = last - first; count > 1; --count) {
+            auto pick = static_cast<decltype(count)>(bounded(static_cast<uint32_t>(count)));
+            auto tmp = first[count - 1];
+            first[count - 1] = first[pick];
+            first[pick] = tmp;
+        }
+    }
+
+    // Raw state, for saving and restoring a stream mid-game
+    void getState(uint64_t state[4]) const { for (int i = 0; i < 4; ++i) state[i] = m_state[i]; }
+    void setState(const uint64_t state[4]) { for (int i = 0; i < 4; ++i) m_state[i] = state[i]; }
+
+    // std::uniform_random_bit_generator interface
+    typedef uint64_t result_type;
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return ~0ULL; }
+    uint64_t operator()() { return next(); }
+
+private:
+    static uint64_t rotateLeft(uint64_t value, int shift) { return (value << shift) | (value >> (64 - shift)); }
+
+    uint64_t m_state[4];
+};
+
+// Buffered d6 rolls. Each 64-bit draw is split into four 16-bit lanes and
+// mapped to 1-6 by multiply-shift; the 4 in 65536 lane values that would bias
+// the result are rejected. The generator is serial, so refill() draws every
+// lane first, then maps all SIZE lanes in a fixed-count loop the compiler
+// vectorizes, and only squeezes out rejected lanes (about one refill in
+// sixteen has any) in a scalar pass. roll() is a buffer read.
+class DiceBatch
+{
+public:
+    static constexpr int SIZE = 1024;
+
+    explicit DiceBatch(Xoshiro256 &random) : m_random(random), m_count(0), m_next(0) {}
+
+    int roll()
+    {
+        while (m_next == m_count) {
+            refill();
+        }
+        return m_dice[m_next++];
+    }
+
+private:
+    static constexpr uint32_t REJECT_BELOW = 65536 % 6;
+
+    void refill()
+    {
+        for (int i = 0; i < SIZE; i += 4) {
+            uint64_t bits = m_random.next();
+            for (int lane = 0; lane < 4; ++lane) {
+                m_lanes[i + lane] = static_cast<uint16_t>(bits >> (16 * lane));
+            }
+        }
+
+        uint32_t rejected = 0;
+        for (int i = 0; i < SIZE; ++i) {
+            uint32_t scaled = static_cast<uint32_t>(m_lanes[i]) * 6;
+            m_dice[i] = static_cast<uint8_t>((scaled >> 16) + 1);
+            rejected |= static_cast<uint32_t>((scaled & 0xFFFF) < REJECT_BELOW);
+        }
+
+        m_count = SIZE;
+        m_next = 0;
+        if (rejected) {
+            m_count = 0;
+            for (int i = 0; i < SIZE; ++i) {
+                if (((static_cast<uint32_t>(m_lanes[i]) * 6) & 0xFFFF) >= REJECT_BELOW) {
+                    m_dice[m_count++] = m_dice[i];
+                }
+            }
+        }
+    }
+
+    Xoshiro256 &m_random;
+    uint16_t m_lanes[SIZE];
+    uint8_t m_dice[SIZE];
+    int m_count;
+    int m_next;
+};
+
+#endif // FASTRNG_H
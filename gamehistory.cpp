@@ -0,0 +1,208 @@
+#include "gamehistory.h"
+#include <algorithm>
+#include <cstdlib>
+
+static bool sameMap(const MapState &a, const MapState &b)
+{
+    return a.land == b.land && a.value == b.value && a.names == b.names;
+}
+
+GameHistory::GameHistory()
+    : m_position(0)
+{
+    reset(GameState(), RandomState());
+}
+
+void GameHistory::reset(const GameState &state, const RandomState &random)
+{
+    m_commands.clear();
+    m_keyframes.assign(1, state);
+    m_current = state;
+    m_startRandom = random;
+    m_position = 0;
+}
+
+// ========== Recording ==========
+
+bool GameHistory::diffPlayer(const PlayerState &before, PlayerState &after, PlayerDelta &delta)
+{
+    delta.eliminated[0] = before.eliminated;
+    delta.eliminated[1] = after.eliminated;
+    delta.wallet[0] = before.wallet;
+    delta.wallet[1] = after.wallet;
+    delta.owned[0] = before.owned;
+    delta.owned[1] = after.owned;
+    delta.cities[0] = before.cities;
+    delta.cities[1] = after.cities;
+    delta.fortifiedCities[0] = before.fortifiedCities;
+    delta.fortifiedCities[1] = after.fortifiedCities;
+    bool changed = before.eliminated != after.eliminated || before.wallet != after.wallet ||
+                   !(before.owned == after.owned) || !(before.cities == after.cities) ||
+                   !(before.fortifiedCities == after.fortifiedCities);
+
+    // Pieces: edits in place when the list still holds the same ids in the same order
+    const std::vector<PieceState> &oldPieces = *before.pieces;
+    const std::vector<PieceState> &newPieces = *after.pieces;
+    bool sameIds = oldPieces.size() == newPieces.size();
+    for (size_t i = 0; sameIds && i < oldPieces.size(); ++i) {
+        sameIds = oldPieces[i].id == newPieces[i].id;
+    }
+    if (!sameIds) {
+        delta.piecesReplaced = true;
+        delta.pieces[0] = before.pieces;
+        delta.pieces[1] = after.pieces;
+        changed = true;
+    } else if (!after.pieces.isSharedWith(before.pieces)) {
+        for (size_t i = 0; i < oldPieces.size(); ++i) {
+            if (oldPieces[i] != newPieces[i]) {
+                delta.pieceChanges.push_back({static_cast<int>(i), {oldPieces[i], newPieces[i]}});
+            }
+        }
+        if (delta.pieceChanges.empty()) {
+            after.pieces = before.pieces;
+        }
+        changed = changed || !delta.pieceChanges.empty();
+    }
+
+    if (!after.roads.isSharedWith(before.roads)) {
+        if (*after.roads == *before.roads) {
+            after.roads = before.roads;
+        } else {
+            delta.roadsReplaced = true;
+            delta.roads[0] = before.roads;
+            delta.roads[1] = after.roads;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+bool GameHistory::record(const GameState &after, const std::string &label, const RandomState &random)
+{
+    GameState next = after;
+    Command command;
+    command.label = label;
+    command.random = random;
+
+    bool structural = !next.map.isSharedWith(m_current.map) && !sameMap(*next.map, *m_current.map);
+    structural = structural || next.playerCount() != m_current.playerCount();
+    for (int i = 0; !structural && i < next.playerCount(); ++i) {
+        structural = next.players[i].id != m_current.players[i].id ||
+                     next.players[i].homeTile != m_current.players[i].homeTile;
+    }
+
+    if (structural) {
+        command.whole[0] = std::make_shared<const GameState>(m_current);
+        command.whole[1] = std::make_shared<const GameState>(next);
+    } else {
+        next.map = m_current.map;
+        for (int i = 0; i < next.playerCount(); ++i) {
+            PlayerDelta delta;
+            delta.player = i;
+            if (diffPlayer(m_current.players[i], next.players[i], delta)) {
+                command.players.push_back(std::move(delta));
+            }
+        }
+
+        command.currentPlayer[0] = m_current.currentPlayer;
+        command.currentPlayer[1] = next.currentPlayer;
+        command.turnNumber[0] = m_current.turnNumber;
+        command.turnNumber[1] = next.turnNumber;
+        command.pieceCounter[0] = m_current.pieceCounter;
+        command.pieceCounter[1] = next.pieceCounter;
+        command.inflationMultiplier[0] = m_current.inflationMultiplier;
+        command.inflationMultiplier[1] = next.inflationMultiplier;
+
+        if (command.players.empty() && m_current.currentPlayer == next.currentPlayer &&
+            m_current.turnNumber == next.turnNumber && m_current.pieceCounter == next.pieceCounter &&
+            m_current.inflationMultiplier == next.inflationMultiplier) {
+            return false;
+        }
+    }
+
+    // A new action ends the redo branch
+    m_commands.resize(m_position);
+    m_keyframes.resize(m_position / KEYFRAME_INTERVAL + 1);
+
+    m_commands.push_back(std::move(command));
+    m_current = std::move(next);
+    ++m_position;
+    if (m_position % KEYFRAME_INTERVAL == 0) {
+        m_keyframes.push_back(m_current);
+    }
+    return true;
+}
+
+// ========== Navigation ==========
+
+void GameHistory::apply(GameState &state, const Command &command, int side)
+{
+    if (command.whole[side]) {
+        state = *command.whole[side];
+        return;
+    }
+
+    for (const PlayerDelta &delta : command.players) {
+        PlayerState &player = state.players[delta.player];
+        player.eliminated = delta.eliminated[side];
+        player.wallet = delta.wallet[side];
+        player.owned = delta.owned[side];
+        player.cities = delta.cities[side];
+        player.fortifiedCities = delta.fortifiedCities[side];
+
+        if (delta.piecesReplaced) {
+            player.pieces = delta.pieces[side];
+        } else if (!delta.pieceChanges.empty()) {
+            std::vector<PieceState> &pieces = player.pieces.write();
+            for (const PieceChange &change : delta.pieceChanges) {
+                pieces[change.index] = change.state[side];
+            }
+        }
+        if (delta.roadsReplaced) {
+            player.roads = delta.roads[side];
+        }
+    }
+
+    state.currentPlayer = command.currentPlayer[side];
+    state.turnNumber = command.turnNumber[side];
+    state.pieceCounter = command.pieceCounter[side];
+    state.inflationMultiplier = command.inflationMultiplier[side];
+}
+
+const GameState &GameHistory::undo()
+{
+    if (canUndo()) {
+        --m_position;
+        apply(m_current, m_commands[m_position], 0);
+    }
+    return m_current;
+}
+
+const GameState &GameHistory::redo()
+{
+    if (canRedo()) {
+        apply(m_current, m_commands[m_position], 1);
+        ++m_position;
+    }
+    return m_current;
+}
+
+const GameState &GameHistory::seek(int step)
+{
+    step = std::max(0, std::min(step, size()));
+
+    // Walk from here if that is no further than replaying from the keyframe
+    int keyframe = step / KEYFRAME_INTERVAL;
+    if (std::abs(step - m_position) > step - keyframe * KEYFRAME_INTERVAL) {
+        m_current = m_keyframes[keyframe];
+        m_position = keyframe * KEYFRAME_INTERVAL;
+    }
+    while (m_position > step) {
+        undo();
+    }
+    while (m_position < step) {
+        redo();
+    }
+    return m_current;
+}
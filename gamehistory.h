@@ -0,0 +1,108 @@
+#ifndef GAMEHISTORY_H
+#define GAMEHISTORY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "gamerandom.h"
+#include "gamestate.h"
+
+// Unlimited undo/redo over GameState. Each recorded action is stored as an
+// invertible command: the before and after values of whatever it changed
+// (a player's wallet, territories, cities, the pieces that moved, roads,
+// whose turn it is), so undo and redo are a walk along the log applying one
+// side or the other. Every KEYFRAME_INTERVAL commands a full snapshot is
+// kept as well; they are copy-on-write GameStates sharing everything that
+// has not changed since, and seek() jumps to the nearest one and replays
+// at most KEYFRAME_INTERVAL - 1 commands.
+//
+// Commands are built by diffing consecutive states, so callers only have to
+// record() after an action; mutations nobody recorded fold into the next
+// command.
+//
+// Each entry also keeps the random streams as they were when it was
+// recorded, so a caller restoring them after undo or redo rolls the same
+// dice again instead of new ones for the turn it replays.
+class GameHistory
+{
+public:
+    static constexpr int KEYFRAME_INTERVAL = 32;
+    using RandomState = std::array<uint64_t, 4 * GameRandom::STREAM_COUNT>;
+
+    GameHistory();
+
+    // Forget everything and start from a state
+    void reset(const GameState &state, const RandomState &random);
+
+    // Append the change from current() to after, dropping any redo steps.
+    // Returns false (and records nothing) if nothing changed.
+    bool record(const GameState &after, const std::string &label, const RandomState &random);
+
+    bool canUndo() const { return m_position > 0; }
+    bool canRedo() const { return m_position < size(); }
+    const GameState &undo();
+    const GameState &redo();
+
+    // State after the first step commands (0 = the reset state)
+    const GameState &seek(int step);
+
+    const GameState &current() const { return m_current; }
+    int position() const { return m_position; }
+
+    // Random streams saved with current()
+    const RandomState &random() const { return m_position > 0 ? m_commands[m_position - 1].random : m_startRandom; }
+    int size() const { return static_cast<int>(m_commands.size()); }
+
+    // Label of command i, and of the ones undo() and redo() would apply
+    const std::string &label(int i) const { return m_commands[i].label; }
+    std::string undoLabel() const { return canUndo() ? label(m_position - 1) : std::string(); }
+    std::string redoLabel() const { return canRedo() ? label(m_position) : std::string(); }
+
+private:
+    // Index 0 of each pair is the value before the command, 1 after it
+    struct PieceChange
+    {
+        int index;
+        PieceState state[2];
+    };
+
+    struct PlayerDelta
+    {
+        int player;
+        bool eliminated[2];
+        int wallet[2];
+        TileMask owned[2];
+        TileMask cities[2];
+        TileMask fortifiedCities[2];
+        std::vector<PieceChange> pieceChanges;     // Pieces edited in place
+        bool piecesReplaced = false;               // Pieces added or removed: whole lists below
+        CowPtr<std::vector<PieceState>> pieces[2];
+        bool roadsReplaced = false;
+        CowPtr<RoadNetwork> roads[2];
+    };
+
+    struct Command
+    {
+        std::string label;
+        RandomState random;                         // Streams when the command was recorded
+        std::vector<PlayerDelta> players;
+        int currentPlayer[2];
+        int turnNumber[2];
+        int pieceCounter[2];
+        int inflationMultiplier[2];
+        std::shared_ptr<const GameState> whole[2];  // Set instead of the above if the player list or map changed
+    };
+
+    // Fills delta and returns true if anything differs; unchanged lists in after are
+    // pointed back at before's so the log keeps one copy
+    static bool diffPlayer(const PlayerState &before, PlayerState &after, PlayerDelta &delta);
+    static void apply(GameState &state, const Command &command, int side);
+
+    std::vector<Command> m_commands;
+    std::vector<GameState> m_keyframes;   // m_keyframes[k]: state after k * KEYFRAME_INTERVAL commands
+    GameState m_current;
+    RandomState m_startRandom;
+    int m_position;
+};
+
+#endif // GAMEHISTORY_H
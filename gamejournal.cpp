@@ -0,0 +1,257 @@
+#include "gamejournal.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const char JOURNAL_MAGIC[4] = {'C', 'T', 'E', 'J'};
+static constexpr uint8_t JOURNAL_VERSION = 2;
+
+GameJournal::GameJournal(const std::string &path)
+    : m_path(path)
+    , m_stopping(false)
+    , m_flushRequested(false)
+    , m_writing(false)
+    , m_file(nullptr)
+    , m_hasSnapshot(false)
+    , m_sinceSnapshot(0)
+{
+    m_thread = std::thread(&GameJournal::run, this);
+}
+
+GameJournal::~GameJournal()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+void GameJournal::start(const GameState &state, const std::vector<bool> &computer, bool atStartOfTurn)
+{
+    Entry entry{true, state, std::string(), Extras()};
+    entry.extras.computer = computer;
+    entry.extras.atStartOfTurn = atStartOfTurn;
+    entry.extras.randomSeed = GameRandom::current().seed();
+    entry.extras.randomState = GameRandom::current().saveState();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return;
+        }
+        m_computer = computer;
+        m_queue.push_back(std::move(entry));
+    }
+    m_wake.notify_all();
+}
+
+void GameJournal::record(const GameState &state, const std::string &label, bool atStartOfTurn)
+{
+    Entry entry{false, state, label, Extras()};
+    entry.extras.atStartOfTurn = atStartOfTurn;
+    entry.extras.randomSeed = GameRandom::current().seed();
+    entry.extras.randomState = GameRandom::current().saveState();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return;
+        }
+        entry.extras.computer = m_computer;
+        m_queue.push_back(std::move(entry));
+    }
+    m_wake.notify_all();
+}
+
+void GameJournal::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_flushRequested = true;
+    m_wake.notify_all();
+    m_idle.wait(lock, [this] { return m_queue.empty() && !m_writing; });
+    m_flushRequested = false;
+}
+
+void GameJournal::discard()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    std::remove(m_path.c_str());
+    std::remove((m_path + ".tmp").c_str());
+}
+
+void GameJournal::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            break;
+        }
+
+        // Let a burst of actions (a whole computer turn) share one write
+        if (!m_stopping && !m_flushRequested) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(BATCH_WINDOW_MS),
+                            [this] { return m_stopping || m_flushRequested; });
+        }
+
+        std::deque<Entry> batch;
+        batch.swap(m_queue);
+        m_writing = true;
+        lock.unlock();
+        writeBatch(batch);
+        lock.lock();
+        m_writing = false;
+        m_idle.notify_all();
+    }
+}
+
+void GameJournal::writeBatch(std::deque<Entry> &batch)
+{
+    std::vector<char> out;
+    for (Entry &entry : batch) {
+        std::vector<char> payload;
+        bool snapshot = entry.snapshot || !m_hasSnapshot ||
+                        !StateRecord::encodeAction(m_last, m_lastExtras, entry.state, entry.extras, entry.label, payload);
+        if (snapshot) {
+            // Anything still buffered belongs to the journal being replaced
+            out.clear();
+            writeSnapshot(entry.state, entry.extras);
+        } else {
+            StateRecord::appendFrame(out, payload);
+            ++m_sinceSnapshot;
+        }
+        m_last = std::move(entry.state);
+        m_lastExtras = std::move(entry.extras);
+    }
+
+    if (!out.empty() && m_file) {
+        std::fwrite(out.data(), 1, out.size(), m_file);
+        std::fflush(m_file);
+    }
+
+    if (m_sinceSnapshot >= COMPACT_INTERVAL) {
+        writeSnapshot(m_last, m_lastExtras);
+    }
+}
+
+// Flush stdio's buffer and the OS cache to the disk
+static bool syncFile(std::FILE *file)
+{
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool GameJournal::writeSnapshot(const GameState &state, const Extras &extras)
+{
+    std::vector<char> out(JOURNAL_MAGIC, JOURNAL_MAGIC + sizeof(JOURNAL_MAGIC));
+    out.push_back(static_cast<char>(JOURNAL_VERSION));
+    StateRecord::appendFrame(out, StateRecord::encodeSnapshot(state, extras));
+
+    // Write beside the journal and rename over it, so a crash leaves the old or the new one.
+    // The data must reach the disk before the rename does, or a crash can leave an empty file
+    std::string temporary = m_path + ".tmp";
+    std::FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    ok = ok && syncFile(file);
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    if (ok && std::rename(temporary.c_str(), m_path.c_str()) != 0) {
+        // Windows won't rename over an existing file
+        std::remove(m_path.c_str());
+        ok = std::rename(temporary.c_str(), m_path.c_str()) == 0;
+    }
+
+    m_file = std::fopen(m_path.c_str(), "ab");
+    m_hasSnapshot = ok && m_file;
+    m_sinceSnapshot = 0;
+    return m_hasSnapshot;
+}
+
+bool GameJournal::recover(const std::string &path, GameState &state, Extras &extras, int *records, bool *intact)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(JOURNAL_MAGIC) + 1 || std::memcmp(data.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+        static_cast<uint8_t>(data[sizeof(JOURNAL_MAGIC)]) != JOURNAL_VERSION) {
+        return false;
+    }
+
+    ByteReader reader(data.data() + sizeof(JOURNAL_MAGIC) + 1, data.size() - sizeof(JOURNAL_MAGIC) - 1);
+    int replayed = -1;
+    bool complete = true;
+    while (!reader.atEnd()) {
+        // Stop at the first record that is cut short or fails its checksum (written during the crash)
+        const char *payload = nullptr;
+        size_t size = 0;
+        if (!StateRecord::readFrame(reader, payload, size)) {
+            complete = false;
+            break;
+        }
+
+        GameState next = state;
+        Extras nextExtras = extras;
+        bool ok = false;
+        if (replayed == -1) {
+            ok = StateRecord::decodeSnapshot(payload, size, next, nextExtras);
+        } else {
+            ok = StateRecord::applyAction(payload, size, next, nextExtras);
+        }
+        if (!ok) {
+            complete = false;
+            break;
+        }
+        state = std::move(next);
+        extras = std::move(nextExtras);
+        ++replayed;
+    }
+
+    if (records) {
+        *records = replayed;
+    }
+    if (intact) {
+        *intact = complete;
+    }
+    return replayed >= 0;
+}
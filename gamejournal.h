@@ -0,0 +1,90 @@
+#ifndef GAMEJOURNAL_H
+#define GAMEJOURNAL_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "staterecord.h"
+
+// Crash-safe autosave: an append-only file of game actions. It opens with a
+// full snapshot of the game and every action after that is a StateRecord of
+// only what changed. Records are length-prefixed and checksummed, so a record
+// torn by a crash is simply where recovery stops.
+//
+// record() only queues a copy-on-write GameState; a writer thread diffs,
+// encodes and appends, batching whatever arrives within BATCH_WINDOW_MS into
+// one write. Every COMPACT_INTERVAL records it rewrites the file as a single
+// new snapshot (written beside it and renamed over it, so there is always a
+// complete journal on disk).
+class GameJournal
+{
+public:
+    static constexpr int COMPACT_INTERVAL = 64;
+    static constexpr int BATCH_WINDOW_MS = 250;
+
+    using RandomState = StateRecord::RandomState;
+    using Extras = StateRecord::Extras;
+
+    explicit GameJournal(const std::string &path);
+    ~GameJournal();   // Writes everything queued, keeps the file
+
+    const std::string &path() const { return m_path; }
+
+    // Start a new journal from state (replaces any existing file)
+    void start(const GameState &state, const std::vector<bool> &computer, bool atStartOfTurn);
+
+    // Append the state after an action; the random state is taken from GameRandom::current()
+    void record(const GameState &state, const std::string &label, bool atStartOfTurn);
+
+    // Block until everything queued so far is on disk
+    void flush();
+
+    // Stop journalling and delete the file (the game ended or was saved properly)
+    void discard();
+
+    // Rebuild the last journalled state, replaying every intact record after the snapshot.
+    // Returns false if there is no journal or not even the snapshot survived. intact is
+    // set to whether that was every record in the file (false after a crash or damage).
+    static bool recover(const std::string &path, GameState &state, Extras &extras, int *records = nullptr,
+                        bool *intact = nullptr);
+
+private:
+    struct Entry
+    {
+        bool snapshot;
+        GameState state;
+        std::string label;
+        Extras extras;
+    };
+
+    void run();
+    void writeBatch(std::deque<Entry> &batch);
+    bool writeSnapshot(const GameState &state, const Extras &extras);
+
+    std::string m_path;
+
+    // Shared with the writer thread
+    std::mutex m_mutex;
+    std::condition_variable m_wake;       // Work queued, flush requested or stopping
+    std::condition_variable m_idle;       // A batch finished
+    std::deque<Entry> m_queue;
+    bool m_stopping;
+    bool m_flushRequested;
+    bool m_writing;
+    std::vector<bool> m_computer;         // Copied into each entry (set by start)
+
+    // Writer thread only
+    std::FILE *m_file;
+    GameState m_last;                     // State the file currently ends with
+    Extras m_lastExtras;
+    bool m_hasSnapshot;
+    int m_sinceSnapshot;
+
+    std::thread m_thread;
+};
+
+#endif // GAMEJOURNAL_H
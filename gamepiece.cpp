@@ -24,7 +24,7 @@ GamePiece::GamePiece(QChar player, const Position &position, QObject *parent)
     : QObject(parent)
     , m_player(player)
     , m_position(position)
-    , m_territoryName("")
+    , m_territoryId(NO_TERRITORY)
     , m_movesRemaining(2)
     , m_uniqueId(0)  // Will be set by subclass
     , m_onGalleySerialNumber("")  // Not on a galley initially
@@ -57,6 +57,22 @@ void GamePiece::resetCounter()
     s_instanceCounter = 0;
 }
 
+void GamePiece::setCounter(int counter)
+{
+    s_instanceCounter = counter % 1000;
+}
+
+void GamePiece::setPosition(const Position &pos)
+{
+    if (pos == m_position) {
+        return;
+    }
+
+    Position oldPosition = m_position;
+    m_position = pos;
+    emit positionChanged(this, oldPosition, pos);
+}
+
 bool GamePiece::canMoveTo(const Position &from, const Position &to) const
 {
     // Default: pieces can move up to 2 squares orthogonally
@@ -44,16 +44,19 @@ public:
 
     // Unique identifier
     int getUniqueId() const { return m_uniqueId; }
+    void setUniqueId(int id) { m_uniqueId = id; }  // Only when recreating a piece from a saved or undone position
     QString getSerialNumber() const;  // Returns formatted 5-digit serial number (e.g., "10001")
 
     // Getters and setters
     QChar getPlayer() const { return m_player; }
     void setPlayer(QChar player) { m_player = player; }
     Position getPosition() const { return m_position; }
-    void setPosition(const Position &pos) { m_position = pos; }
+    void setPosition(const Position &pos);  // Emits positionChanged if the position differs
 
-    QString getTerritoryName() const { return m_territoryName; }
-    void setTerritoryName(const QString &name) { m_territoryName = name; }
+    TerritoryId getTerritoryId() const { return m_territoryId; }
+    void setTerritoryId(TerritoryId id) { m_territoryId = id; }
+    QString getTerritoryName() const { return TerritoryNames::nameOf(m_territoryId); }
+    void setTerritoryName(const QString &name) { m_territoryId = TerritoryNames::idOf(name); }
 
     int getMovesRemaining() const { return m_movesRemaining; }
     void setMovesRemaining(int moves) { m_movesRemaining = moves; }
@@ -67,13 +70,20 @@ public:
     // Static method to reset counter (for testing or new game)
     static void resetCounter();
 
+    // Continue numbering after a restored position's highest serial
+    static void setCounter(int counter);
+
+signals:
+    // Lets the owning Player keep its per-tile index up to date
+    void positionChanged(GamePiece *piece, const Position &oldPosition, const Position &newPosition);
+
 protected:
     // Generate unique ID based on type prefix and instance counter
     int generateUniqueId(int typePrefix);
 
     QChar m_player;
     Position m_position;
-    QString m_territoryName;           // Name of the territory this piece is in
+    TerritoryId m_territoryId;         // Territory this piece is in
     int m_movesRemaining;
     int m_uniqueId;                    // Unique 5-digit ID (type prefix + instance number)
     QString m_onGalleySerialNumber;    // Serial number of galley this piece is on (empty if not on galley)
@@ -0,0 +1,51 @@
+#include "gamerandom.h"
+#include <chrono>
+#include <random>
+
+GameRandom::GameRandom(uint64_t seed)
+{
+    reseed(seed);
+}
+
+GameRandom &GameRandom::current()
+{
+    static GameRandom game(freshSeed());
+    return game;
+}
+
+uint64_t GameRandom::freshSeed()
+{
+    std::random_device device;
+    uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+
+    // Some platforms have a deterministic random_device; mix in the clock as well
+    seed ^= static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    return seed;
+}
+
+void GameRandom::reseed(uint64_t seed)
+{
+    m_seed = seed;
+    Xoshiro256 generator(seed);
+    for (Xoshiro256 &stream : m_streams) {
+        stream = generator;
+        generator.jump();
+    }
+}
+
+std::array<uint64_t, 4 * GameRandom::STREAM_COUNT> GameRandom::saveState() const
+{
+    std::array<uint64_t, 4 * STREAM_COUNT> state;
+    for (int i = 0; i < STREAM_COUNT; ++i) {
+        m_streams[i].getState(&state[4 * i]);
+    }
+    return state;
+}
+
+void GameRandom::restoreState(uint64_t seed, const std::array<uint64_t, 4 * STREAM_COUNT> &state)
+{
+    m_seed = seed;
+    for (int i = 0; i < STREAM_COUNT; ++i) {
+        m_streams[i].setState(&state[4 * i]);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef GAMERANDOM_H
+#define GAMERANDOM_H
+
+#include <array>
+#include <cstdint>
+#include "fastrng.h"
+
+// Random numbers for one game, split into independent named streams so that
+// e.g. dice animation frames never shift the combat rolls. Every stream is
+// derived from a single 64-bit seed (stream i is the seeded generator jumped
+// i times), and the seed plus each stream's position go into save files so a
+// loaded game continues with the same rolls. The UI game uses current();
+// headless simulations create their own GameRandom and never share state.
+class GameRandom
+{
+public:
+    enum Stream {
+        Combat,
+        MapGeneration,
+        Animation,
+        STREAM_COUNT
+    };
+
+    explicit GameRandom(uint64_t seed);
+
+    // The game being played in the UI (seeded from freshSeed() on first use)
+    static GameRandom &current();
+
+    // A seed from the system entropy source
+    static uint64_t freshSeed();
+
+    void reseed(uint64_t seed);
+    uint64_t seed() const { return m_seed; }
+
+    Xoshiro256 &stream(Stream stream) { return m_streams[stream]; }
+
+    // Die roll 1-6 from the combat stream unless another is given
+    int rollDie(Stream stream = Combat) { return m_streams[stream].uniform(1, 6); }
+
+    // Stream position as 4 words per stream, for save files
+    std::array<uint64_t, 4 * STREAM_COUNT> saveState() const;
+    void restoreState(uint64_t seed, const std::array<uint64_t, 4 * STREAM_COUNT> &state);
+
+private:
+    uint64_t m_seed;
+    std::array<Xoshiro256, STREAM_COUNT> m_streams;
+};
+
+#endif // GAMERANDOM_H
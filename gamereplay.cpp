@@ -0,0 +1,349 @@
+#include "gamereplay.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+static const char REPLAY_MAGIC[4] = {'C', 'T', 'E', 'R'};
+static constexpr uint8_t REPLAY_VERSION = 2;
+static constexpr size_t HEADER_SIZE = sizeof(REPLAY_MAGIC) + 1;
+
+// Each frame is a kind, the turn, the action's label and its Command, then a StateRecord
+enum : uint8_t {
+    OPENING_FRAME = 0,    // Snapshot of the starting position
+    STEP_FRAME = 1,       // An action (or a snapshot if it couldn't be expressed as one)
+    KEYFRAME_FRAME = 2    // Snapshot of the position after the step before it
+};
+
+// ========== Commands ==========
+
+static void writeTiles(ByteWriter &writer, const std::vector<int> &tiles)
+{
+    writer.count(tiles.size());
+    for (int tile : tiles) {
+        writer.tile(tile);
+    }
+}
+
+static void readTiles(ByteReader &reader, std::vector<int> &tiles)
+{
+    tiles.resize(reader.items());
+    for (int &tile : tiles) {
+        tile = reader.tile();
+    }
+}
+
+static void writeCommand(ByteWriter &writer, const GameReplay::Command &command)
+{
+    using Kind = GameReplay::Command::Kind;
+
+    writer.byte(static_cast<uint8_t>(command.kind));
+    if (command.kind == Kind::None) {
+        return;
+    }
+    writer.integer(command.player);
+
+    switch (command.kind) {
+    case Kind::None:
+        break;
+    case Kind::Setup:
+    case Kind::Combats:
+        for (uint64_t word : command.random) {
+            writer.word(word);
+        }
+        break;
+    case Kind::Legions:
+        writer.count(command.legions.size());
+        for (const std::pair<int, int> &assignment : command.legions) {
+            writer.integer(assignment.first);
+            writer.integer(assignment.second);
+        }
+        break;
+    case Kind::Move:
+        writer.byte(static_cast<uint8_t>(command.move.kind));
+        writer.tile(command.move.fromTile);
+        writer.tile(command.move.toTile);
+        writer.integer(command.move.pieceId);
+        if (command.move.kind == Move::Kind::Embark) {
+            writer.integer(command.move.galleyId);
+        }
+        break;
+    case Kind::Purchase:
+        writer.integer(command.order.infantry);
+        writer.integer(command.order.cavalry);
+        writer.integer(command.order.catapults);
+        writer.integer(command.order.galleys);
+        writeTiles(writer, command.order.cities);
+        writeTiles(writer, command.order.fortifiedCities);
+        writeTiles(writer, command.order.fortifications);
+        break;
+    case Kind::EndTurn:
+        writer.integer(command.inflationAt[0]);
+        writer.integer(command.inflationAt[1]);
+        break;
+    case Kind::Taxes:
+        break;
+    }
+}
+
+static bool readCommand(ByteReader &reader, GameReplay::Command &command)
+{
+    using Kind = GameReplay::Command::Kind;
+
+    uint8_t kind = reader.byte();
+    if (kind > static_cast<uint8_t>(Kind::Taxes)) {
+        return false;
+    }
+    command = GameReplay::Command();
+    command.kind = static_cast<Kind>(kind);
+    if (command.kind == Kind::None) {
+        return reader.ok();
+    }
+    command.player = reader.integer();
+
+    switch (command.kind) {
+    case Kind::None:
+        break;
+    case Kind::Setup:
+    case Kind::Combats:
+        for (uint64_t &word : command.random) {
+            word = reader.word();
+        }
+        break;
+    case Kind::Legions:
+        command.legions.resize(reader.items());
+        for (std::pair<int, int> &assignment : command.legions) {
+            assignment.first = reader.integer();
+            assignment.second = reader.integer();
+        }
+        break;
+    case Kind::Move: {
+        uint8_t moveKind = reader.byte();
+        if (moveKind > static_cast<uint8_t>(Move::Kind::Embark)) {
+            return false;
+        }
+        command.move.kind = static_cast<Move::Kind>(moveKind);
+        command.move.fromTile = static_cast<uint8_t>(reader.tile());
+        command.move.toTile = static_cast<uint8_t>(reader.tile());
+        command.move.pieceId = reader.integer();
+        if (command.move.kind == Move::Kind::Embark) {
+            command.move.galleyId = reader.integer();
+        }
+        break;
+    }
+    case Kind::Purchase:
+        command.order.infantry = reader.integer();
+        command.order.cavalry = reader.integer();
+        command.order.catapults = reader.integer();
+        command.order.galleys = reader.integer();
+        readTiles(reader, command.order.cities);
+        readTiles(reader, command.order.fortifiedCities);
+        readTiles(reader, command.order.fortifications);
+        break;
+    case Kind::EndTurn:
+        command.inflationAt[0] = reader.integer();
+        command.inflationAt[1] = reader.integer();
+        break;
+    case Kind::Taxes:
+        break;
+    }
+    return reader.ok();
+}
+
+// ========== Replay ==========
+
+void GameReplay::clear()
+{
+    m_data.assign(REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC));
+    m_data.push_back(static_cast<char>(REPLAY_VERSION));
+    m_steps.clear();
+    m_keyframeSteps.clear();
+    m_keyframes.clear();
+    m_turnStarts.clear();
+}
+
+// ========== Recording ==========
+
+void GameReplay::start(const GameState &state, const std::vector<bool> &computer, bool atStartOfTurn,
+                       const Command &command)
+{
+    clear();
+
+    Extras extras;
+    extras.computer = computer;
+    extras.atStartOfTurn = atStartOfTurn;
+    extras.randomSeed = GameRandom::current().seed();
+    extras.randomState = GameRandom::current().saveState();
+
+    append(OPENING_FRAME, 0, std::string(), command, StateRecord::encodeSnapshot(state, extras));
+    m_last = state;
+    m_lastExtras = extras;
+}
+
+void GameReplay::record(const GameState &state, const std::string &label, bool atStartOfTurn,
+                        const Command &command)
+{
+    if (isEmpty()) {
+        return;
+    }
+
+    Extras extras = m_lastExtras;
+    extras.atStartOfTurn = atStartOfTurn;
+    extras.randomSeed = GameRandom::current().seed();
+    extras.randomState = GameRandom::current().saveState();
+
+    // The step that hands the game to another player is the first position of the new turn
+    int previousTurn = m_steps.back().turn;
+    int turn = previousTurn + (state.currentPlayer != m_last.currentPlayer ? 1 : 0);
+
+    // The label lives in the frame, so the record itself doesn't repeat it
+    std::vector<char> payload;
+    if (!StateRecord::encodeAction(m_last, m_lastExtras, state, extras, std::string(), payload)) {
+        payload = StateRecord::encodeSnapshot(state, extras);
+    }
+    append(STEP_FRAME, turn, label, command, payload);
+
+    if (turn != previousTurn && turn % KEYFRAME_TURNS == 0) {
+        append(KEYFRAME_FRAME, turn, std::string(), Command(), StateRecord::encodeSnapshot(state, extras));
+    }
+
+    m_last = state;
+    m_lastExtras = extras;
+}
+
+void GameReplay::append(uint8_t kind, int turn, const std::string &label, const Command &command,
+                        const std::vector<char> &payload)
+{
+    ByteWriter writer;
+    writer.byte(kind);
+    writer.integer(turn);
+    writer.text(label);
+    writeCommand(writer, command);
+    std::vector<char> &frame = writer.data();
+    frame.insert(frame.end(), payload.begin(), payload.end());
+
+    StateRecord::appendFrame(m_data, frame);
+    index(m_data.data() + m_data.size() - 4 - frame.size(), frame.size());
+}
+
+bool GameReplay::save(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(m_data.data(), static_cast<std::streamsize>(m_data.size()));
+    return static_cast<bool>(file);
+}
+
+// ========== Reading ==========
+
+bool GameReplay::load(const std::string &path)
+{
+    clear();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), m_data.data(), HEADER_SIZE) != 0) {
+        return false;
+    }
+    m_data = std::move(data);
+
+    // Unlike the journal, a replay is written whole, so any damage rejects it
+    ByteReader reader(m_data.data() + HEADER_SIZE, m_data.size() - HEADER_SIZE);
+    while (!reader.atEnd()) {
+        const char *frame = nullptr;
+        size_t size = 0;
+        if (!StateRecord::readFrame(reader, frame, size) || !index(frame, size)) {
+            clear();
+            return false;
+        }
+    }
+
+    // Recording can carry on from the end, and this proves the last stretch decodes
+    if (isEmpty() || !seek(steps() - 1, m_last, m_lastExtras)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+// Adds one frame (already in m_data) to the index; false if it is out of place
+bool GameReplay::index(const char *frame, size_t size)
+{
+    ByteReader reader(frame, size);
+    uint8_t kind = reader.byte();
+    int turn = reader.integer();
+    std::string label = reader.text();
+    Command command;
+    if (!readCommand(reader, command) || turn < 0) {
+        return false;
+    }
+
+    Record record{static_cast<size_t>(reader.current() - m_data.data()), reader.remaining(), turn, label, command};
+    bool snapshot = StateRecord::isSnapshot(reader.current(), reader.remaining());
+
+    switch (kind) {
+    case OPENING_FRAME:
+        if (!isEmpty() || turn != 0 || !snapshot) {
+            return false;
+        }
+        m_turnStarts.push_back(0);
+        m_keyframeSteps.push_back(0);
+        m_keyframes.push_back(record);
+        m_steps.push_back(record);
+        return true;
+
+    case STEP_FRAME:
+        if (isEmpty() || turn < m_steps.back().turn || turn - m_steps.back().turn > 1) {
+            return false;
+        }
+        if (turn != m_steps.back().turn) {
+            m_turnStarts.push_back(steps());
+        }
+        m_steps.push_back(record);
+        return true;
+
+    case KEYFRAME_FRAME:
+        if (isEmpty() || turn != m_steps.back().turn || !snapshot || m_keyframeSteps.back() == steps() - 1) {
+            return false;
+        }
+        m_keyframeSteps.push_back(steps() - 1);
+        m_keyframes.push_back(record);
+        return true;
+    }
+    return false;
+}
+
+bool GameReplay::seek(int step, GameState &state, Extras &extras) const
+{
+    if (step < 0 || step >= steps()) {
+        return false;
+    }
+
+    size_t k = std::upper_bound(m_keyframeSteps.begin(), m_keyframeSteps.end(), step) - m_keyframeSteps.begin() - 1;
+    const Record &keyframe = m_keyframes[k];
+    if (!StateRecord::decodeSnapshot(m_data.data() + keyframe.offset, keyframe.size, state, extras)) {
+        return false;
+    }
+
+    for (int s = m_keyframeSteps[k] + 1; s <= step; ++s) {
+        if (!advance(s, state, extras)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GameReplay::advance(int step, GameState &state, Extras &extras) const
+{
+    if (step < 0 || step >= steps()) {
+        return false;
+    }
+
+    const char *payload = m_data.data() + m_steps[step].offset;
+    size_t size = m_steps[step].size;
+    return StateRecord::isSnapshot(payload, size)
+        ? StateRecord::decodeSnapshot(payload, size, state, extras)
+        : StateRecord::applyAction(payload, size, state, extras);
+}
@@ -0,0 +1,112 @@
+#ifndef GAMEREPLAY_H
+#define GAMEREPLAY_H
+
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+#include "movegenerator.h"
+#include "rulesengine.h"
+#include "staterecord.h"
+
+// The engine call behind a replay step, with everything it needs to run again
+struct ReplayCommand
+{
+    enum class Kind : uint8_t {
+        None,       // Not recorded (games played in the window)
+        Setup,      // RulesEngine::setupNewGame, retried until it succeeds
+        Legions,    // RulesEngine::assignToLegion for each pair
+        Move,       // MoveGenerator::apply
+        Combats,    // RulesEngine::resolveAllCombats
+        Purchase,   // RulesEngine::purchase
+        EndTurn,    // RulesEngine::endTurn, then the inflation thresholds
+        Taxes       // RulesEngine::collectTaxes (the game window taxes before the purchase phase)
+    };
+
+    Kind kind = Kind::None;
+    int player = NO_PLAYER;                     // Seat count for Setup
+    std::vector<std::pair<int, int>> legions;   // (troop id, leader id)
+    ::Move move;
+    std::array<uint64_t, 4> random = {};        // Xoshiro256 state before Setup or Combats
+    RulesEngine::PurchaseOrder order;
+    int inflationAt[2] = {0, 0};                // Richest wallet that doubles / triples prices (0 = never)
+};
+
+// A whole game for review: the opening position (random seed, the named map,
+// home provinces and starting forces) followed by every recorded action as a
+// StateRecord of what it changed, with a full keyframe at the start of every
+// KEYFRAME_TURNS-th turn. A turn is a run of actions by one player, so an
+// undo back into the previous player's turn starts a new one.
+//
+// Records are indexed (not decoded) as they are recorded or loaded. seek()
+// decodes the nearest keyframe at or before the step and applies the actions
+// after it, so any position is at most KEYFRAME_TURNS turns of deltas away.
+//
+// A step may also carry the ReplayCommand that produced it (self-play games
+// record every one, the game window its taxes), so the game can be
+// re-executed and checked against the digest each record ends with.
+class GameReplay
+{
+public:
+    static constexpr int KEYFRAME_TURNS = 6;
+    static constexpr const char *FILE_EXTENSION = "ctreplay";
+
+    using Extras = StateRecord::Extras;
+    using Command = ReplayCommand;
+
+    // Start over from a position (new or loaded game); the random state is taken from GameRandom::current()
+    void start(const GameState &state, const std::vector<bool> &computer, bool atStartOfTurn,
+               const Command &command = Command());
+
+    // Append the state after an action
+    void record(const GameState &state, const std::string &label, bool atStartOfTurn,
+                const Command &command = Command());
+
+    bool save(const std::string &path) const;
+
+    // Replace this replay with a file's; false (and empty) if it isn't a replay or is damaged
+    bool load(const std::string &path);
+
+    bool isEmpty() const { return m_steps.empty(); }
+
+    // Step 0 is the opening position and step i the position after the i-th action
+    int steps() const { return static_cast<int>(m_steps.size()); }
+    int turns() const { return static_cast<int>(m_turnStarts.size()); }
+    int turnOf(int step) const { return m_steps[step].turn; }
+    int firstStepOfTurn(int turn) const { return m_turnStarts[turn]; }
+    const std::string &label(int step) const { return m_steps[step].label; }
+    const Command &command(int step) const { return m_steps[step].command; }
+
+    // Rebuild the position after step; false if step is out of range or its records don't decode
+    bool seek(int step, GameState &state, Extras &extras) const;
+
+    // Apply step's record to the position after the step before it (the cheap way to walk forwards)
+    bool advance(int step, GameState &state, Extras &extras) const;
+
+private:
+    struct Record
+    {
+        size_t offset;  // StateRecord payload within m_data
+        size_t size;
+        int turn;
+        std::string label;
+        Command command;
+    };
+
+    void append(uint8_t kind, int turn, const std::string &label, const Command &command,
+                const std::vector<char> &payload);
+    bool index(const char *frame, size_t size);
+    void clear();
+
+    std::vector<char> m_data;             // Exactly the file: magic, version, frames
+    std::vector<Record> m_steps;
+    std::vector<int> m_keyframeSteps;     // Ascending; the opening is the first
+    std::vector<Record> m_keyframes;      // m_keyframes[k]: snapshot at m_keyframeSteps[k]
+    std::vector<int> m_turnStarts;
+
+    // Recording only
+    GameState m_last;
+    Extras m_lastExtras;
+};
+
+#endif // GAMEREPLAY_H
@@ -0,0 +1,163 @@
+#include "gamestate.h"
+
+// ========== MapState ==========
+
+MapState::MapState()
+{
+    value.fill(0);
+}
+
+int MapState::findTile(const std::string &name) const
+{
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        if (names[tile] == name) {
+            return tile;
+        }
+    }
+    return NO_TILE;
+}
+
+// ========== GameState ==========
+
+GameState::GameState()
+{
+}
+
+int GameState::playerIndex(char id) const
+{
+    for (int i = 0; i < playerCount(); ++i) {
+        if (players[i].id == id) {
+            return i;
+        }
+    }
+    return NO_PLAYER;
+}
+
+int GameState::territoryOwner(int tile) const
+{
+    for (int i = 0; i < playerCount(); ++i) {
+        if (players[i].owned.test(tile)) {
+            return i;
+        }
+    }
+    return NO_PLAYER;
+}
+
+int GameState::cityOwner(int tile) const
+{
+    for (int i = 0; i < playerCount(); ++i) {
+        if (players[i].cities.test(tile)) {
+            return i;
+        }
+    }
+    return NO_PLAYER;
+}
+
+PieceState *GameState::findPiece(int id, int *owner)
+{
+    int holder = NO_PLAYER;
+    const GameState *constThis = this;
+    const PieceState *piece = constThis->findPiece(id, &holder);
+    if (!piece) {
+        return nullptr;
+    }
+    if (owner) {
+        *owner = holder;
+    }
+
+    // The same slot in this state's own copy of the holder's pieces
+    size_t index = static_cast<size_t>(piece - players[holder].pieces->data());
+    return &players[holder].pieces.write()[index];
+}
+
+const PieceState *GameState::findPiece(int id, int *owner) const
+{
+    for (int i = 0; i < playerCount(); ++i) {
+        for (const PieceState &piece : *players[i].pieces) {
+            if (piece.id == id) {
+                if (owner) {
+                    *owner = i;
+                }
+                return &piece;
+            }
+        }
+    }
+    return nullptr;
+}
+
+TileMask GameState::occupiedTiles(int player) const
+{
+    TileMask occupied;
+    for (const PieceState &piece : *players[player].pieces) {
+        if (piece.capturedBy == NO_PLAYER && piece.tile != NO_TILE) {
+            occupied.set(piece.tile);
+        }
+    }
+    return occupied;
+}
+
+bool GameState::hasPiecesAt(int player, int tile) const
+{
+    for (const PieceState &piece : *players[player].pieces) {
+        if (piece.tile == tile && piece.capturedBy == NO_PLAYER) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GameState::hasEnemyPiecesAt(int player, int tile) const
+{
+    for (int i = 0; i < playerCount(); ++i) {
+        if (i != player && hasPiecesAt(i, tile)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int GameState::countAt(int player, int tile, PieceKind kind) const
+{
+    int count = 0;
+    for (const PieceState &piece : *players[player].pieces) {
+        if (piece.tile == tile && piece.kind == kind && piece.capturedBy == NO_PLAYER) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+int GameState::countInPlay(PieceKind kind) const
+{
+    int count = 0;
+    for (const PlayerState &player : players) {
+        for (const PieceState &piece : *player.pieces) {
+            if (piece.kind == kind) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+int GameState::activePlayerCount() const
+{
+    int count = 0;
+    for (const PlayerState &player : players) {
+        if (!player.eliminated) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+int GameState::allocatePieceId(PieceKind kind)
+{
+    // Same scheme as GamePiece::generateUniqueId: counter wraps at 1000
+    pieceCounter++;
+    if (pieceCounter >= 1000) {
+        pieceCounter = 1;
+    }
+    int typePrefix = (static_cast<int>(kind) + 1) * 10;
+    return typePrefix * 1000 + pieceCounter;
+}
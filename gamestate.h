@@ -0,0 +1,131 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include "tilemask.h"
+#include "roadnetwork.h"
+#include "cowptr.h"
+
+// Plain C++ game model used by the rules engine. It has no Qt or widget
+// dependencies so whole games can be simulated headless; the Qt classes
+// (MapWidget, Player, GamePiece) are converted with GameStateBridge.
+// Copies are cheap snapshots: the map and each player's pieces and roads
+// are copy-on-write (see CowPtr), so search, previews and undo can copy a
+// GameState per step and only clone the parts a move touches.
+
+static constexpr int MAX_PLAYERS = 6;
+static constexpr int NO_TILE = -1;
+static constexpr int NO_PLAYER = -1;
+
+// Piece kinds, in the same order as GamePiece::Type
+enum class PieceKind {
+    Caesar,
+    General,
+    Infantry,
+    Cavalry,
+    Catapult,
+    Galley
+};
+
+inline bool isLeaderKind(PieceKind kind) { return kind == PieceKind::Caesar || kind == PieceKind::General; }
+inline bool isTroopKind(PieceKind kind)
+{
+    return kind == PieceKind::Infantry || kind == PieceKind::Cavalry || kind == PieceKind::Catapult;
+}
+
+// Terrain, names and tax values of the 96 board tiles
+struct MapState
+{
+    MapState();
+
+    bool isLand(int tile) const { return land.test(tile); }
+    bool isSea(int tile) const { return !land.test(tile); }
+
+    // Find a tile by territory name (NO_TILE if not found)
+    int findTile(const std::string &name) const;
+
+    TileMask land;
+    std::array<int, BOARD_TILES> value;            // 5 or 10 for land, 0 for sea
+    std::array<std::string, BOARD_TILES> names;    // Animal names for land, fish names for sea
+};
+
+struct PieceState
+{
+    int id = 0;                    // Same value as GamePiece::getUniqueId()
+    PieceKind kind = PieceKind::Infantry;
+    int tile = NO_TILE;
+    int lastTile = NO_TILE;        // Leaders and galleys: tile before the last move (retreat target)
+    int movesRemaining = 0;
+    int generalNumber = 0;         // Generals only (1-6)
+    int capturedBy = NO_PLAYER;    // Generals only: index of the player holding this general prisoner
+    int leaderId = 0;              // Troops: id of the leader whose legion this troop marches with (0 = unled)
+    int galleyId = 0;              // Id of the galley carrying this piece (0 = not embarked)
+
+    bool operator==(const PieceState &other) const
+    {
+        return id == other.id && kind == other.kind && tile == other.tile && lastTile == other.lastTile &&
+               movesRemaining == other.movesRemaining && generalNumber == other.generalNumber &&
+               capturedBy == other.capturedBy && leaderId == other.leaderId && galleyId == other.galleyId;
+    }
+    bool operator!=(const PieceState &other) const { return !(*this == other); }
+};
+
+struct PlayerState
+{
+    char id = 'A';                 // 'A'-'F'
+    bool eliminated = false;       // Caesar was captured, everything went to the captor
+    int wallet = 100;
+    int homeTile = NO_TILE;
+    TileMask owned;                // Claimed territories
+    TileMask cities;
+    TileMask fortifiedCities;      // Subset of cities
+    CowPtr<std::vector<PieceState>> pieces;
+    CowPtr<RoadNetwork> roads;
+};
+
+class GameState
+{
+public:
+    GameState();
+
+    int playerCount() const { return static_cast<int>(players.size()); }
+
+    // Index of the player with the given id ('A'-'F'), NO_PLAYER if absent
+    int playerIndex(char id) const;
+
+    // Ownership queries (NO_PLAYER if nobody)
+    int territoryOwner(int tile) const;
+    int cityOwner(int tile) const;
+
+    // Find a piece by unique id across all players (the non-const one unshares the owner's pieces)
+    PieceState *findPiece(int id, int *owner = nullptr);
+    const PieceState *findPiece(int id, int *owner = nullptr) const;
+
+    // Tiles where a player has pieces that can fight or be attacked (prisoners excluded)
+    TileMask occupiedTiles(int player) const;
+    bool hasPiecesAt(int player, int tile) const;
+    bool hasEnemyPiecesAt(int player, int tile) const;
+
+    // Number of a player's active pieces of one kind at a tile
+    int countAt(int player, int tile, PieceKind kind) const;
+
+    // Count of a piece kind across every player (limited by the pieces in the game box)
+    int countInPlay(PieceKind kind) const;
+
+    // Players still in the game
+    int activePlayerCount() const;
+
+    // Allocate a unique id the same way GamePiece does (2-digit type prefix + 3-digit counter)
+    int allocatePieceId(PieceKind kind);
+
+    CowPtr<MapState> map;          // Fixed once the game is set up
+    std::vector<PlayerState> players;
+    int currentPlayer = 0;
+    int turnNumber = 1;
+    int pieceCounter = 0;          // Mirrors GamePiece's instance counter
+    int inflationMultiplier = 1;   // Price multiplier (the UI currently always plays at 1)
+};
+
+#endif // GAMESTATE_H
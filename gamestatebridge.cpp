@@ -0,0 +1,377 @@
+#include "gamestatebridge.h"
+#include "mapwidget.h"
+#include "player.h"
+#include "building.h"
+#include <QDebug>
+#include <QHash>
+#include <QSet>
+
+static PieceState capturePiece(const GamePiece *piece)
+{
+    PieceState state;
+    state.id = piece->getUniqueId();
+    state.kind = GameStateBridge::toPieceKind(piece->getType());
+    state.tile = GameStateBridge::toTile(piece->getPosition());
+    state.movesRemaining = piece->getMovesRemaining();
+    state.galleyId = piece->isOnGalley() ? piece->getOnGalley().toInt() : 0;
+    return state;
+}
+
+GameState GameStateBridge::capture(const MapWidget *mapWidget, const QList<Player*> &players, int currentPlayerIndex)
+{
+    GameState state;
+    state.currentPlayer = currentPlayerIndex;
+
+    state.map.write() = mapWidget->getMapState();
+
+    // Players in turn order
+    QHash<QChar, int> playerIndices;
+    for (int i = 0; i < players.size(); ++i) {
+        playerIndices[players[i]->getId()] = i;
+    }
+
+    for (Player *player : players) {
+        PlayerState playerState;
+        playerState.id = player->getId().toLatin1();
+        playerState.wallet = player->getWallet();
+        playerState.homeTile = toTile(player->getHomeProvince());
+        playerState.eliminated = player->getCaesars().isEmpty();
+
+        playerState.owned = player->getOwnedTerritoryMask();
+
+        for (City *city : player->getCities()) {
+            int tile = toTile(city->getPosition());
+            playerState.cities.set(tile);
+            playerState.fortifiedCities.assign(tile, city->isFortified());
+        }
+
+        playerState.roads.write() = player->getRoadNetwork();
+
+        // Leaders first, remembering each legion so the troops can point back at their leader
+        QHash<int, int> leaderOf;
+        QHash<int, int> galleyOf;
+        for (CaesarPiece *caesar : player->getCaesars()) {
+            PieceState pieceState = capturePiece(caesar);
+            pieceState.lastTile = caesar->hasLastTerritory() ? toTile(caesar->getLastTerritory()) : NO_TILE;
+            for (int id : caesar->getLegion()) {
+                leaderOf[id] = caesar->getUniqueId();
+            }
+            playerState.pieces.write().push_back(pieceState);
+        }
+
+        // A player's generals include the ones other players hold prisoner. Each goes in
+        // once by id, even if a general is still listed by its owner as well as its captor
+        QList<GeneralPiece*> generals = player->getGenerals();
+        QSet<int> generalIds;
+        for (GeneralPiece *general : generals) {
+            generalIds.insert(general->getUniqueId());
+        }
+        for (Player *holder : players) {
+            for (GeneralPiece *general : holder->getCapturedGenerals()) {
+                if (general->getPlayer() == player->getId() && !generalIds.contains(general->getUniqueId())) {
+                    generalIds.insert(general->getUniqueId());
+                    generals.append(general);
+                }
+            }
+        }
+        for (GeneralPiece *general : generals) {
+            PieceState pieceState = capturePiece(general);
+            pieceState.generalNumber = general->getNumber();
+            pieceState.lastTile = general->hasLastTerritory() ? toTile(general->getLastTerritory()) : NO_TILE;
+            pieceState.capturedBy = general->isCaptured() ? playerIndices.value(general->getCapturedBy(), NO_PLAYER) : NO_PLAYER;
+            for (int id : general->getLegion()) {
+                leaderOf[id] = general->getUniqueId();
+            }
+            playerState.pieces.write().push_back(pieceState);
+        }
+        for (GalleyPiece *galley : player->getGalleys()) {
+            PieceState pieceState = capturePiece(galley);
+            pieceState.lastTile = galley->hasLastTerritory() ? toTile(galley->getLastTerritory()) : NO_TILE;
+            for (int id : galley->getLegion()) {
+                galleyOf[id] = galley->getUniqueId();
+            }
+            playerState.pieces.write().push_back(pieceState);
+        }
+
+        // Troops
+        QList<GamePiece*> troops;
+        for (InfantryPiece *piece : player->getInfantry()) troops.append(piece);
+        for (CavalryPiece *piece : player->getCavalry()) troops.append(piece);
+        for (CatapultPiece *piece : player->getCatapults()) troops.append(piece);
+        for (GamePiece *troop : troops) {
+            PieceState pieceState = capturePiece(troop);
+            pieceState.leaderId = leaderOf.value(troop->getUniqueId(), 0);
+            playerState.pieces.write().push_back(pieceState);
+        }
+
+        // Pieces carried by a galley's legion count as embarked
+        for (PieceState &pieceState : playerState.pieces.write()) {
+            if (pieceState.galleyId == 0) {
+                pieceState.galleyId = galleyOf.value(pieceState.id, 0);
+            }
+        }
+
+        state.players.push_back(playerState);
+    }
+
+    // Continue numbering after the highest serial in play
+    for (const PlayerState &playerState : state.players) {
+        for (const PieceState &pieceState : *playerState.pieces) {
+            state.pieceCounter = qMax(state.pieceCounter, pieceState.id % 1000);
+        }
+    }
+
+    checkUniqueIds(state);
+    return state;
+}
+
+void GameStateBridge::checkUniqueIds(const GameState &state)
+{
+#ifdef QT_DEBUG
+    QSet<int> ids;
+    for (const PlayerState &playerState : state.players) {
+        for (const PieceState &pieceState : *playerState.pieces) {
+            if (ids.contains(pieceState.id)) {
+                qWarning() << "GameStateBridge: piece" << pieceState.id << "captured twice";
+                Q_ASSERT_X(false, "GameStateBridge::checkUniqueIds", "a piece is held in two lists");
+            }
+            ids.insert(pieceState.id);
+        }
+    }
+#else
+    Q_UNUSED(state);
+#endif
+}
+
+// ========== Restore ==========
+
+// Which list of which player holds a piece (prisoners sit in their captor's captured list)
+struct PieceSlot
+{
+    Player *holder = nullptr;
+    bool prisoner = false;
+};
+
+static void detachPiece(const PieceSlot &slot, GamePiece *piece)
+{
+    if (slot.prisoner) {
+        slot.holder->removeCapturedGeneral(static_cast<GeneralPiece*>(piece));
+        return;
+    }
+    switch (piece->getType()) {
+    case GamePiece::Type::Caesar: slot.holder->removeCaesar(static_cast<CaesarPiece*>(piece)); break;
+    case GamePiece::Type::General: slot.holder->removeGeneral(static_cast<GeneralPiece*>(piece)); break;
+    case GamePiece::Type::Infantry: slot.holder->removeInfantry(static_cast<InfantryPiece*>(piece)); break;
+    case GamePiece::Type::Cavalry: slot.holder->removeCavalry(static_cast<CavalryPiece*>(piece)); break;
+    case GamePiece::Type::Catapult: slot.holder->removeCatapult(static_cast<CatapultPiece*>(piece)); break;
+    case GamePiece::Type::Galley: slot.holder->removeGalley(static_cast<GalleyPiece*>(piece)); break;
+    }
+}
+
+static void attachPiece(const PieceSlot &slot, GamePiece *piece)
+{
+    if (slot.prisoner) {
+        slot.holder->addCapturedGeneral(static_cast<GeneralPiece*>(piece));
+        return;
+    }
+    switch (piece->getType()) {
+    case GamePiece::Type::Caesar: slot.holder->addCaesar(static_cast<CaesarPiece*>(piece)); break;
+    case GamePiece::Type::General: slot.holder->addGeneral(static_cast<GeneralPiece*>(piece)); break;
+    case GamePiece::Type::Infantry: slot.holder->addInfantry(static_cast<InfantryPiece*>(piece)); break;
+    case GamePiece::Type::Cavalry: slot.holder->addCavalry(static_cast<CavalryPiece*>(piece)); break;
+    case GamePiece::Type::Catapult: slot.holder->addCatapult(static_cast<CatapultPiece*>(piece)); break;
+    case GamePiece::Type::Galley: slot.holder->addGalley(static_cast<GalleyPiece*>(piece)); break;
+    }
+}
+
+static GamePiece *createPiece(Player *owner, const PieceState &pieceState)
+{
+    QChar id = owner->getId();
+    Position pos = territoryPosition(pieceState.tile);
+    GamePiece *piece = nullptr;
+    switch (pieceState.kind) {
+    case PieceKind::Caesar: piece = new CaesarPiece(id, pos, owner); break;
+    case PieceKind::General: piece = new GeneralPiece(id, pos, pieceState.generalNumber, owner); break;
+    case PieceKind::Infantry: piece = new InfantryPiece(id, pos, owner); break;
+    case PieceKind::Cavalry: piece = new CavalryPiece(id, pos, owner); break;
+    case PieceKind::Catapult: piece = new CatapultPiece(id, pos, owner); break;
+    case PieceKind::Galley: piece = new GalleyPiece(id, pos, owner); break;
+    }
+    piece->setUniqueId(pieceState.id);
+    return piece;
+}
+
+void GameStateBridge::restore(MapWidget *mapWidget, const QList<Player*> &players, const GameState &state)
+{
+    if (players.size() != state.playerCount()) {
+        return;
+    }
+
+    // Whose turn first: startTurn resets movement, which the pieces below then overwrite
+    for (int i = 0; i < players.size(); ++i) {
+        if (i == state.currentPlayer && !players[i]->isMyTurn()) {
+            players[i]->startTurn();
+        } else if (i != state.currentPlayer && players[i]->isMyTurn()) {
+            players[i]->endTurn();
+        }
+    }
+
+    // Every piece on the widget side, and where it is held
+    QHash<int, GamePiece*> pieces;
+    QHash<int, PieceSlot> pieceSlots;
+    for (Player *player : players) {
+        for (GamePiece *piece : player->getAllPieces()) {
+            pieces[piece->getUniqueId()] = piece;
+            pieceSlots[piece->getUniqueId()] = {player, false};
+        }
+        for (GeneralPiece *general : player->getCapturedGenerals()) {
+            pieces[general->getUniqueId()] = general;
+            pieceSlots[general->getUniqueId()] = {player, true};
+        }
+    }
+
+    // Pieces the state no longer has
+    QSet<int> wanted;
+    for (const PlayerState &playerState : state.players) {
+        for (const PieceState &pieceState : *playerState.pieces) {
+            wanted.insert(pieceState.id);
+        }
+    }
+    for (auto it = pieces.begin(); it != pieces.end(); ++it) {
+        if (!wanted.contains(it.key())) {
+            detachPiece(pieceSlots[it.key()], it.value());
+            delete it.value();
+        }
+    }
+
+    for (int i = 0; i < players.size(); ++i) {
+        Player *player = players[i];
+        const std::vector<PieceState> &pieceStates = *state.players[i].pieces;
+
+        // Legions point from each troop to its leader or galley; the Qt side keeps them on the leader
+        QHash<int, QList<int>> legions;
+        QHash<int, QList<int>> cargo;
+        for (const PieceState &pieceState : pieceStates) {
+            if (pieceState.leaderId != 0) {
+                legions[pieceState.leaderId].append(pieceState.id);
+            }
+            if (pieceState.galleyId != 0) {
+                cargo[pieceState.galleyId].append(pieceState.id);
+            }
+        }
+
+        for (const PieceState &pieceState : pieceStates) {
+            bool prisoner = pieceState.capturedBy != NO_PLAYER && pieceState.capturedBy < players.size();
+            PieceSlot slot = {prisoner ? players[pieceState.capturedBy] : player, prisoner};
+
+            // Detach before moving so the holder's per-tile index drops the old tile
+            GamePiece *piece = pieces.value(pieceState.id, nullptr);
+            bool attached = false;
+            if (!piece) {
+                piece = createPiece(player, pieceState);
+            } else if (pieceSlots[pieceState.id].holder != slot.holder || pieceSlots[pieceState.id].prisoner != prisoner) {
+                detachPiece(pieceSlots[pieceState.id], piece);
+            } else {
+                attached = true;
+            }
+
+            Position pos = territoryPosition(pieceState.tile);
+            piece->setPosition(pos);
+            piece->setTerritoryId(pieceState.tile);
+            piece->setMovesRemaining(pieceState.movesRemaining);
+            if (pieceState.galleyId != 0) {
+                piece->setOnGalley(QString::number(pieceState.galleyId));
+            } else {
+                piece->clearGalley();
+            }
+
+            Position lastPos = territoryPosition(pieceState.lastTile);
+            if (pieceState.kind == PieceKind::Caesar) {
+                CaesarPiece *caesar = static_cast<CaesarPiece*>(piece);
+                caesar->setLastTerritory(lastPos);
+                caesar->setLegion(legions.value(pieceState.id));
+            } else if (pieceState.kind == PieceKind::General) {
+                GeneralPiece *general = static_cast<GeneralPiece*>(piece);
+                general->setLastTerritory(lastPos);
+                general->setLegion(legions.value(pieceState.id));
+                if (prisoner) {
+                    general->setCapturedBy(players[pieceState.capturedBy]->getId());
+                } else {
+                    general->clearCaptured();
+                }
+            } else if (pieceState.kind == PieceKind::Galley) {
+                GalleyPiece *galley = static_cast<GalleyPiece*>(piece);
+                galley->setLastTerritory(lastPos);
+                galley->setLegion(cargo.value(pieceState.id));
+            }
+
+            if (!attached) {
+                attachPiece(slot, piece);
+            }
+        }
+    }
+
+    for (int i = 0; i < players.size(); ++i) {
+        Player *player = players[i];
+        const PlayerState &playerState = state.players[i];
+
+        // Territories: give up the lost ones everywhere before anyone claims them
+        (player->getOwnedTerritoryMask() & ~playerState.owned).forEach([player](int tile) {
+            player->unclaimTerritory(tile);
+        });
+
+        // Cities that fell or were destroyed
+        QList<City*> cities = player->getCities();
+        for (City *city : cities) {
+            Position pos = city->getPosition();
+            if (!playerState.cities.test(toTile(pos))) {
+                mapWidget->removeCityAt(pos.row, pos.col);
+                mapWidget->removeFortificationAt(pos.row, pos.col);
+                player->removeCity(city);
+                delete city;
+            }
+        }
+
+        player->setWallet(playerState.wallet);
+    }
+
+    for (int i = 0; i < players.size(); ++i) {
+        Player *player = players[i];
+        const PlayerState &playerState = state.players[i];
+
+        (playerState.owned & ~player->getOwnedTerritoryMask()).forEach([player](int tile) {
+            player->claimTerritory(tile);
+        });
+
+        (playerState.cities & ~player->getCityTiles()).forEach([player](int tile) {
+            City *city = new City(player->getId(), toPosition(tile), TerritoryNames::nameOf(tile), false, player);
+            player->addCity(city);
+        });
+        for (City *city : player->getCities()) {
+            city->setFortified(playerState.fortifiedCities.test(toTile(city->getPosition())));
+        }
+
+        // Roads: the map adds and drops them with cities, so this only catches any it missed
+        const RoadNetwork &roads = *playerState.roads;
+        QList<Road*> existingRoads = player->getRoads();
+        for (Road *road : existingRoads) {
+            if (!roads.hasRoad(toTile(road->getFromPosition()), toTile(road->getToPosition()))) {
+                player->removeRoad(road);
+                delete road;
+            }
+        }
+        for (int tile = 0; tile < BOARD_TILES; ++tile) {
+            (roads.neighbours(tile) & ~player->getRoadNetwork().neighbours(tile)).forEach([player, tile](int neighbour) {
+                if (neighbour > tile) {
+                    Road *road = new Road(player->getId(), toPosition(tile), TerritoryNames::nameOf(tile), player);
+                    road->setToPosition(toPosition(neighbour));
+                    player->addRoad(road);
+                }
+            });
+        }
+    }
+
+    GamePiece::setCounter(state.pieceCounter);
+    mapWidget->setCurrentPlayerIndex(state.currentPlayer);
+    mapWidget->update();
+}
@@ -0,0 +1,33 @@
+#ifndef GAMESTATEBRIDGE_H
+#define GAMESTATEBRIDGE_H
+
+#include <QList>
+#include "common.h"
+#include "gamestate.h"
+#include "gamepiece.h"
+
+class MapWidget;
+class Player;
+
+// Converts between the widget-side model (MapWidget, Player, GamePiece)
+// and the plain C++ GameState used by the rules engine
+class GameStateBridge
+{
+public:
+    // Snapshot the map, players, pieces and buildings into a GameState
+    static GameState capture(const MapWidget *mapWidget, const QList<Player*> &players, int currentPlayerIndex);
+
+    // Debug builds: warn and assert if two pieces of a captured state share an id
+    static void checkUniqueIds(const GameState &state);
+
+    // Bring the players back to a captured state (undo/redo): pieces are matched by id, moved,
+    // created or deleted as needed, then territories, cities, roads, wallets and whose turn
+    // it is are reconciled. The map itself is left alone.
+    static void restore(MapWidget *mapWidget, const QList<Player*> &players, const GameState &state);
+
+    static PieceKind toPieceKind(GamePiece::Type type) { return static_cast<PieceKind>(type); }
+    static int toTile(const Position &pos) { return tileIndex(pos.row, pos.col); }
+    static Position toPosition(int tile) { return {tileRow(tile), tileColumn(tile)}; }
+};
+
+#endif // GAMESTATEBRIDGE_H
@@ -3,6 +3,7 @@
  *********************************************************************************/
 
 #include "laurollingdiewidget.h"
+#include "gamerandom.h"
 #include <QPainter>
 #include <QPaintEvent>
 #include <QMouseEvent>
@@ -15,9 +16,10 @@ LAURollingDieWidget::LAURollingDieWidget(int numDice, QWidget *parent)
     setWindowTitle(QString("Rolling Dice"));
     diceValues.resize(numDice);
     diceOrientations.resize(numDice);
+    Xoshiro256 &animation = GameRandom::current().stream(GameRandom::Animation);
     for (int i = 0; i < numDice; ++i) {
-        diceValues[i] = QRandomGenerator::global()->bounded(1, 7);
-        diceOrientations[i] = QRandomGenerator::global()->bounded(0, 4);
+        diceValues[i] = animation.uniform(1, 6);
+        diceOrientations[i] = animation.uniform(0, 3);
     }
     int dieSize = 200, spacing = 20;
     resize(numDice * dieSize + (numDice + 1) * spacing, dieSize + 2 * spacing);
@@ -95,9 +97,12 @@ void LAURollingDieWidget::startRolling() {
 }
 
 void LAURollingDieWidget::onRollTimer() {
+    // Tumbling frames come from the animation stream; the value the die lands on is a combat roll
+    GameRandom &random = GameRandom::current();
+    bool finalFrame = rollCount + 1 >= maxRolls;
     for (int i = 0; i < numDice; ++i) {
-        diceValues[i] = QRandomGenerator::global()->bounded(1, 7);
-        diceOrientations[i] = QRandomGenerator::global()->bounded(0, 4);
+        diceValues[i] = finalFrame ? random.rollDie(GameRandom::Combat) : random.rollDie(GameRandom::Animation);
+        diceOrientations[i] = random.stream(GameRandom::Animation).uniform(0, 3);
     }
     QApplication::beep(); update(); rollCount++;
     if (rollCount > 10) rollTimer->setInterval(20 + (rollCount - 10) * 15);
@@ -35,7 +35,6 @@
 
 #include <QWidget>
 #include <QTimer>
-#include <QRandomGenerator>
 #include <QVector>
 
 class LAURollingDieWidget : public QWidget
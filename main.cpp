@@ -5,66 +5,121 @@
 #include "scorewindow.h"
 #include "walletwindow.h"
 #include "combatdialog.h"
+#include "gamerandom.h"
+#include "savegamejson.h"
+#include "gamejournal.h"
+#include "gamestatebridge.h"
 #include <QApplication>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QInputDialog>
 #include <QFileDialog>
 #include <QStandardPaths>
 #include <QSettings>
+#include <QDir>
 #include <QFile>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include <QSet>
+#include <algorithm>
 
-// Forward declaration
+// Forward declarations
 bool loadGameFromFile(const QString &fileName, MapWidget *&mapWidget, QList<Player*> &players, int &currentPlayerIndex);
+void restoreGame(const SaveGame &save, MapWidget *&mapWidget, QList<Player*> &players);
+
+// Crash-recovery journal for the game in progress
+static QString autosaveJournalPath()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    return QDir(dir).filePath("autosave.journal");
+}
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
-    // Show startup dialog: New Game or Load Game
-    QMessageBox startupDialog;
-    startupDialog.setWindowTitle("Conquest of the Empire");
-    startupDialog.setText("Welcome to Conquest of the Empire!");
-    startupDialog.setInformativeText("Would you like to start a new game or load a saved game?");
-    startupDialog.setIcon(QMessageBox::Question);
-
-    QPushButton *newGameButton = startupDialog.addButton("New Game", QMessageBox::AcceptRole);
-    QPushButton *loadGameButton = startupDialog.addButton("Load Game", QMessageBox::ActionRole);
-    QPushButton *exitButton = startupDialog.addButton("Exit", QMessageBox::RejectRole);
-
-    startupDialog.exec();
+    // Offer to continue a game the last session never closed (a crash or power cut)
+    QString journalPath = autosaveJournalPath();
+    GameState recoveredState;
+    GameJournal::Extras recoveredExtras;
+    bool recovering = false;
+    if (GameJournal::recover(journalPath.toStdString(), recoveredState, recoveredExtras)) {
+        QMessageBox::StandardButton reply = QMessageBox::question(nullptr, "Recover Game",
+                                                                  "The last game was not closed properly.\n\n"
+                                                                  "Would you like to continue it from the last action?",
+                                                                  QMessageBox::Yes | QMessageBox::No);
+        recovering = (reply == QMessageBox::Yes);
+        if (!recovering) {
+            QFile::remove(journalPath);
+        }
+    }
 
     QString loadFileName;
     bool loadGame = false;
+    GameReplay replay;
+    bool watchingReplay = false;
+
+    if (!recovering) {
+        // Show startup dialog: New Game, Load Game or Watch Replay
+        QMessageBox startupDialog;
+        startupDialog.setWindowTitle("Conquest of the Empire");
+        startupDialog.setText("Welcome to Conquest of the Empire!");
+        startupDialog.setInformativeText("Would you like to start a new game, load a saved game or watch a replay?");
+        startupDialog.setIcon(QMessageBox::Question);
+
+        QPushButton *newGameButton = startupDialog.addButton("New Game", QMessageBox::AcceptRole);
+        QPushButton *loadGameButton = startupDialog.addButton("Load Game", QMessageBox::ActionRole);
+        QPushButton *watchReplayButton = startupDialog.addButton("Watch Replay", QMessageBox::ActionRole);
+        QPushButton *exitButton = startupDialog.addButton("Exit", QMessageBox::RejectRole);
+
+        startupDialog.exec();
+
+        if (startupDialog.clickedButton() == loadGameButton) {
+            // Get last used directory from settings, default to Documents folder
+            QSettings settings("ConquestOfTheEmpire", "MapWidget");
+            QString lastDir = settings.value("lastSaveDirectory",
+                                             QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).toString();
+
+            loadFileName = QFileDialog::getOpenFileName(nullptr,
+                                                        "Load Game",
+                                                        lastDir,
+                                                        "Saved Games (*.ctes *.json);;Binary Saves (*.ctes);;JSON Files (*.json)");
+
+            if (loadFileName.isEmpty()) {
+                // User cancelled file dialog, exit application
+                return 0;
+            }
 
-    if (startupDialog.clickedButton() == loadGameButton) {
-        // Get last used directory from settings, default to Documents folder
-        QSettings settings("ConquestOfTheEmpire", "MapWidget");
-        QString lastDir = settings.value("lastSaveDirectory",
-                                         QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).toString();
-
-        loadFileName = QFileDialog::getOpenFileName(nullptr,
-                                                    "Load Game",
-                                                    lastDir,
-                                                    "JSON Files (*.json)");
+            // Save the directory for next time
+            QFileInfo fileInfo(loadFileName);
+            settings.setValue("lastSaveDirectory", fileInfo.absolutePath());
+
+            loadGame = true;
+        } else if (startupDialog.clickedButton() == watchReplayButton) {
+            QSettings settings("ConquestOfTheEmpire", "MapWidget");
+            QString lastDir = settings.value("lastSaveDirectory",
+                                             QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).toString();
+
+            QString replayFileName = QFileDialog::getOpenFileName(nullptr,
+                                                                  "Watch Replay",
+                                                                  lastDir,
+                                                                  QString("Replays (*.%1)").arg(GameReplay::FILE_EXTENSION));
+            if (replayFileName.isEmpty()) {
+                return 0;
+            }
+            settings.setValue("lastSaveDirectory", QFileInfo(replayFileName).absolutePath());
 
-        if (loadFileName.isEmpty()) {
-            // User cancelled file dialog, exit application
+            if (!replay.load(replayFileName.toStdString())) {
+                QMessageBox::critical(nullptr, "Watch Replay",
+                                      QString("Failed to read replay:\n%1").arg(replayFileName));
+                return 0;
+            }
+            watchingReplay = true;
+        } else if (startupDialog.clickedButton() == exitButton) {
+            // User chose to exit
             return 0;
         }
-
-        // Save the directory for next time
-        QFileInfo fileInfo(loadFileName);
-        settings.setValue("lastSaveDirectory", fileInfo.absolutePath());
-
-        loadGame = true;
-    } else if (startupDialog.clickedButton() == exitButton) {
-        // User chose to exit
-        return 0;
+        // else: New Game button was clicked, continue with normal initialization
     }
-    // else: New Game button was clicked, continue with normal initialization
 
     // Reset the piece counter for a fresh game
     GamePiece::resetCounter();
@@ -73,8 +128,56 @@ int main(int argc, char *argv[])
     QList<Player*> players;
     int currentPlayerIndex = 0;
 
+    // A replay opens on its starting position, built like a loaded save; the map then only views it
+    if (watchingReplay) {
+        GameState opening;
+        GameReplay::Extras openingExtras;
+        bool ok = replay.seek(0, opening, openingExtras);
+        SaveGame save = SaveGame::fromState(opening);
+        std::string error;
+        if (!ok || !save.validate(&error)) {
+            QMessageBox::critical(nullptr, "Watch Replay",
+                                  QString("The replay's starting position is invalid:\n%1").arg(QString::fromStdString(error)));
+            return 0;
+        }
+        restoreGame(save, mapWidget, players);
+        mapWidget->setPlayers(players);
+        mapWidget->updateScores(mapWidget->calculateScores());
+        QObject::connect(mapWidget, &MapWidget::scoresChanged, mapWidget, [mapWidget]() {
+            mapWidget->updateScores(mapWidget->calculateScores());
+        });
+        mapWidget->show();
+        mapWidget->startReplay(replay);
+
+        int result = a.exec();
+        qDeleteAll(players);
+        delete mapWidget;
+        return result;
+    }
+
+    // Rebuild a recovered game through the same path as a loaded save
+    if (recovering) {
+        SaveGame save = SaveGame::fromState(recoveredState);
+        for (size_t i = 0; i < save.players.size() && i < recoveredExtras.computer.size(); ++i) {
+            save.players[i].computer = recoveredExtras.computer[i];
+        }
+        save.hasRandomState = true;
+        save.randomSeed = recoveredExtras.randomSeed;
+        save.randomState.assign(recoveredExtras.randomState.begin(), recoveredExtras.randomState.end());
+
+        std::string error;
+        if (save.validate(&error)) {
+            restoreGame(save, mapWidget, players);
+            currentPlayerIndex = save.currentPlayerIndex;
+            loadGame = true;
+        } else {
+            qWarning() << "Cannot recover game:" << QString::fromStdString(error);
+            recovering = false;
+        }
+    }
+
     // If loading a game, load from file
-    if (loadGame) {
+    if (loadGame && !recovering) {
         if (!loadGameFromFile(loadFileName, mapWidget, players, currentPlayerIndex)) {
             QMessageBox::critical(nullptr, "Load Failed",
                                  "Failed to load game from file.\n\n"
@@ -85,6 +188,8 @@ int main(int argc, char *argv[])
 
     // If not loading or load failed, create new game
     if (!loadGame) {
+        qDebug() << "New game, random seed" << QString::number(GameRandom::current().seed(), 16);
+
         // Create the map widget first - it will initialize the random map
         mapWidget = new MapWidget();
 
@@ -103,6 +208,17 @@ int main(int argc, char *argv[])
             players.append(player);
         }
 
+        // The last players in turn order are played by the computer
+        bool ok = false;
+        int computerPlayers = QInputDialog::getInt(nullptr, "Computer Players",
+                                                   "How many players should the computer play?",
+                                                   0, 0, players.size(), 1, &ok);
+        if (ok) {
+            for (int i = players.size() - computerPlayers; i < players.size(); ++i) {
+                players[i]->setComputerControlled(true);
+            }
+        }
+
         currentPlayerIndex = 0;
     }
 
@@ -117,6 +233,12 @@ int main(int argc, char *argv[])
         mapWidget->setAtStartOfTurn(true);  // At the start of the turn
     }
 
+    // A recovered game can stop mid-turn: put back the moves already made this turn
+    if (recovering) {
+        GameStateBridge::restore(mapWidget, players, recoveredState);
+        mapWidget->setAtStartOfTurn(recoveredExtras.atStartOfTurn);
+    }
+
     // FOR TESTING: Move Player A's troops next to Player B for immediate combat testing
     // DISABLED - uncomment to enable combat testing setup
     /*
@@ -187,26 +309,10 @@ int main(int argc, char *argv[])
     // Don't show it by default since wallets are in player info widget now
     // walletWindow->show();
 
-    // Initialize scores and wallets
-    QMap<QChar, int> initialScores;
+    // Initialize scores and wallets (scores come from the map's running ledger)
+    QMap<QChar, int> initialScores = mapWidget->calculateScores();
     QMap<QChar, int> initialWallets;
     for (Player *player : players) {
-        // Calculate total tax value for owned territories
-        int totalTaxValue = 0;
-        const QList<QString> &territories = player->getOwnedTerritories();
-        for (const QString &territoryName : territories) {
-            for (int row = 0; row < 8; ++row) {
-                for (int col = 0; col < 12; ++col) {
-                    if (mapWidget->getTerritoryNameAt(row, col) == territoryName) {
-                        totalTaxValue += mapWidget->getTerritoryValueAt(row, col);
-                        break;
-                    }
-                }
-            }
-        }
-        // Add 5 for each city owned
-        totalTaxValue += player->getCityCount() * 5;
-        initialScores[player->getId()] = totalTaxValue;
         initialWallets[player->getId()] = player->getWallet();
     }
     mapWidget->updateScores(initialScores);  // Update scores in map widget
@@ -235,55 +341,30 @@ int main(int argc, char *argv[])
         });
     }
 
-    // Connect territory changes to score display
-    auto updateScores = [scoreWindow, &players, mapWidget]() {
-        QMap<QChar, int> scores;
-        for (Player *player : players) {
-            // Calculate total tax value for owned territories
-            int totalTaxValue = 0;
-            const QList<QString> &territories = player->getOwnedTerritories();
-            for (const QString &territoryName : territories) {
-                for (int row = 0; row < 8; ++row) {
-                    for (int col = 0; col < 12; ++col) {
-                        if (mapWidget->getTerritoryNameAt(row, col) == territoryName) {
-                            totalTaxValue += mapWidget->getTerritoryValueAt(row, col);
-                            break;
-                        }
-                    }
-                }
-            }
-            // Add 5 for each city owned
-            totalTaxValue += player->getCityCount() * 5;
-            scores[player->getId()] = totalTaxValue;
-        }
+    // Refresh the score displays whenever the ledger changes
+    QObject::connect(mapWidget, &MapWidget::scoresChanged, scoreWindow, [scoreWindow, mapWidget]() {
+        QMap<QChar, int> scores = mapWidget->calculateScores();
         mapWidget->updateScores(scores);  // Update scores in map widget
         scoreWindow->updateScores(scores);  // Also update separate window if shown
-    };
+    });
 
-    for (Player *player : players) {
-        QObject::connect(player, &Player::territoryClaimed, scoreWindow, updateScores);
-        QObject::connect(player, &Player::territoryUnclaimed, scoreWindow, updateScores);
-        QObject::connect(player, &Player::buildingAdded, scoreWindow, [updateScores, mapWidget](Building *building) {
-            Q_UNUSED(building);
-            updateScores();
-            mapWidget->updateRoads();  // Check for new roads when buildings added
-        });
-        QObject::connect(player, &Player::buildingRemoved, scoreWindow, [updateScores](Building *building) {
-            Q_UNUSED(building);
-            updateScores();
-        });
+    // Undo/redo from the Edit menu, starting from this position; every action is also
+    // journalled so a crash loses nothing, and kept for File > Save Replay
+    GameJournal journal(journalPath.toStdString());
+    infoWidget->setJournal(&journal);
+    QObject::connect(mapWidget, &MapWidget::undoRequested, infoWidget, &PlayerInfoWidget::undo);
+    QObject::connect(mapWidget, &MapWidget::redoRequested, infoWidget, &PlayerInfoWidget::redo);
+    QObject::connect(mapWidget, &MapWidget::saveReplayRequested, infoWidget, &PlayerInfoWidget::saveReplay);
+    infoWidget->resetHistory();
 
-        // Also update roads when territory ownership changes
-        QObject::connect(player, &Player::territoryClaimed, mapWidget, [mapWidget]() {
-            mapWidget->updateRoads();
-        });
-        QObject::connect(player, &Player::territoryUnclaimed, mapWidget, [mapWidget]() {
-            mapWidget->updateRoads();
-        });
-    }
+    // The computer opens the game if it plays the current player
+    infoWidget->scheduleComputerTurn();
 
     int result = a.exec();
 
+    // Closed normally, so there is nothing to recover next time
+    journal.discard();
+
     // Clean up
     qDeleteAll(players);
     delete infoWidget;
@@ -294,372 +375,160 @@ int main(int argc, char *argv[])
     return result;
 }
 
-bool loadGameFromFile(const QString &fileName, MapWidget *&mapWidget, QList<Player*> &players, int &currentPlayerIndex)
+// Copies the fields every saved piece has onto a newly created piece
+static void restorePiece(GamePiece *piece, const SavedPiece &saved)
 {
-    // Open and parse JSON file
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return false;
+    piece->setUniqueId(saved.serialNumber);
+    piece->setTerritoryName(QString::fromStdString(saved.territory));
+    piece->setMovesRemaining(saved.movesRemaining);
+    if (saved.onGalley != 0) {
+        piece->setOnGalley(QString::number(saved.onGalley));
     }
+}
 
-    QByteArray data = file.readAll();
-    file.close();
+// Leaders and galleys also carry a legion (by serial number) and a retreat tile
+template <typename Leader>
+static void restoreLeader(Leader *leader, const SavedPiece &saved)
+{
+    restorePiece(leader, saved);
 
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull() || !doc.isObject()) {
-        return false;
+    QList<int> legion;
+    legion.reserve(static_cast<int>(saved.legion.size()));
+    for (int pieceId : saved.legion) {
+        legion.append(pieceId);
     }
+    leader->setLegion(legion);
 
-    QJsonObject gameState = doc.object();
+    if (saved.lastRow != -1) {
+        leader->setLastTerritory({saved.lastRow, saved.lastCol});
+    }
+}
+
+bool loadGameFromFile(const QString &fileName, MapWidget *&mapWidget, QList<Player*> &players, int &currentPlayerIndex)
+{
+    // Decode straight from the mapped file (binary or JSON) and check it before creating any widgets
+    SaveGame save;
+    if (!SaveGameJson::readFile(fileName, save)) {
+        return false;
+    }
+    std::string error;
+    if (!save.validate(&error)) {
+        qWarning() << "Invalid save" << fileName << ":" << QString::fromStdString(error);
+        return false;
+    }
 
-    // Get current player index
-    currentPlayerIndex = gameState["currentPlayerIndex"].toInt(0);
+    currentPlayerIndex = save.currentPlayerIndex;
+    restoreGame(save, mapWidget, players);
+    return true;
+}
 
+// Creates the map and players of a validated save
+void restoreGame(const SaveGame &save, MapWidget *&mapWidget, QList<Player*> &players)
+{
     // Create map widget (will initialize with random map, but we'll override it)
     mapWidget = new MapWidget();
+    mapWidget->restoreMap(save);
 
-    // Clear the random map and restore territories from save file
-    mapWidget->clearMap();
-
-    QJsonArray territoriesArray = gameState["territories"].toArray();
-    for (const QJsonValue &territoryValue : territoriesArray) {
-        QJsonObject territoryObj = territoryValue.toObject();
-        int row = territoryObj["row"].toInt(0);
-        int col = territoryObj["col"].toInt(0);
-        QString name = territoryObj["name"].toString();
-        int value = territoryObj["value"].toInt(0);
-        bool isLand = territoryObj["isLand"].toBool(true);
-
-        mapWidget->setTerritoryAt(row, col, name, value, isLand);
+    // Restore the random streams (older saves have none and keep the fresh seed)
+    std::array<uint64_t, 4 * GameRandom::STREAM_COUNT> randomState;
+    if (save.hasRandomState && save.randomState.size() == randomState.size()) {
+        std::copy(save.randomState.begin(), save.randomState.end(), randomState.begin());
+        GameRandom::current().restoreState(save.randomSeed, randomState);
     }
 
-    // Load players
-    QJsonArray playersArray = gameState["players"].toArray();
-    for (const QJsonValue &playerValue : playersArray) {
-        QJsonObject playerObj = playerValue.toObject();
-
-        QChar playerId = playerObj["id"].toString().at(0);
-        int wallet = playerObj["wallet"].toInt(0);
-        Position homePos;
-        homePos.row = playerObj["homeRow"].toInt(0);
-        homePos.col = playerObj["homeCol"].toInt(0);
-        QString homeName = playerObj["homeName"].toString();
-
-        // Create player (this will auto-create Caesar, 5 generals, and home city)
-        Player *player = new Player(playerId, homePos, homeName);
-
-        // Set wallet
-        player->setWallet(wallet);
-
-        // Clear default pieces created by constructor - we'll recreate from save
-        // Remove the auto-created pieces
-        for (CaesarPiece *caesar : player->getCaesars()) {
-            player->removeCaesar(caesar);
-            delete caesar;
-        }
-        for (GeneralPiece *general : player->getGenerals()) {
-            player->removeGeneral(general);
-            delete general;
-        }
-        for (InfantryPiece *infantry : player->getInfantry()) {
-            player->removeInfantry(infantry);
-            delete infantry;
+    // Saved pieces keep their serial numbers, so legions and galley references stay valid;
+    // new pieces continue numbering after the highest instance in the save
+    int lastInstance = 0;
+    auto track = [&lastInstance](const std::vector<SavedPiece> &pieces) {
+        for (const SavedPiece &piece : pieces) {
+            lastInstance = std::max(lastInstance, piece.serialNumber % 1000);
         }
+    };
 
-        // Load owned territories
-        QJsonArray territoriesArray = playerObj["ownedTerritories"].toArray();
-        for (const QJsonValue &territoryValue : territoriesArray) {
-            player->claimTerritory(territoryValue.toString());
+    // Older saves list a prisoner under its owner's generals as well as its captor's
+    // captured generals; the captor's entry is the one that counts
+    QSet<int> prisoners;
+    for (const SavedPlayer &saved : save.players) {
+        for (const SavedPiece &piece : saved.capturedGenerals) {
+            prisoners.insert(piece.serialNumber);
         }
+    }
 
-        // Load Caesars
-        QJsonArray caesarsArray = playerObj["caesars"].toArray();
-        QMap<QString, CaesarPiece*> caesarMap;  // Track by old serial for legion restoration
-        for (const QJsonValue &caesarValue : caesarsArray) {
-            QJsonObject caesarObj = caesarValue.toObject();
-
-            Position pos;
-            pos.row = caesarObj["row"].toInt(0);
-            pos.col = caesarObj["col"].toInt(0);
-
-            CaesarPiece *caesar = new CaesarPiece(playerId, pos, player);
-            caesar->setTerritoryName(caesarObj["territory"].toString());
-            caesar->setMovesRemaining(caesarObj["movesRemaining"].toInt(0));
-            caesar->setOnGalley(caesarObj["onGalley"].toString());
-
-            if (caesarObj.contains("lastTerritoryRow")) {
-                Position lastPos;
-                lastPos.row = caesarObj["lastTerritoryRow"].toInt(0);
-                lastPos.col = caesarObj["lastTerritoryCol"].toInt(0);
-                caesar->setLastTerritory(lastPos);
-            }
+    for (const SavedPlayer &saved : save.players) {
+        QChar playerId(saved.id);
+        Position homePos = {saved.homeRow, saved.homeCol};
+
+        // Start empty: everything, home city included, comes from the save
+        Player *player = new Player(playerId, homePos, QString::fromStdString(saved.homeName), Player::Setup::Empty);
+        player->setWallet(saved.wallet);
+        player->setComputerControlled(saved.computer);
+
+        for (const std::string &territory : saved.ownedTerritories) {
+            player->claimTerritory(QString::fromStdString(territory));
+        }
 
-            caesarMap[caesarObj["serialNumber"].toString()] = caesar;
+        for (const SavedPiece &piece : saved.caesars) {
+            CaesarPiece *caesar = new CaesarPiece(playerId, {piece.row, piece.col}, player);
+            restoreLeader(caesar, piece);
             player->addCaesar(caesar);
         }
 
-        // Load Generals
-        QJsonArray generalsArray = playerObj["generals"].toArray();
-        QMap<QString, GeneralPiece*> generalMap;
-        for (const QJsonValue &generalValue : generalsArray) {
-            QJsonObject generalObj = generalValue.toObject();
-
-            Position pos;
-            pos.row = generalObj["row"].toInt(0);
-            pos.col = generalObj["col"].toInt(0);
-            int number = generalObj["number"].toInt(1);
-
-            GeneralPiece *general = new GeneralPiece(playerId, pos, number, player);
-            general->setTerritoryName(generalObj["territory"].toString());
-            general->setMovesRemaining(generalObj["movesRemaining"].toInt(0));
-            general->setOnGalley(generalObj["onGalley"].toString());
-
-            if (generalObj.contains("lastTerritoryRow")) {
-                Position lastPos;
-                lastPos.row = generalObj["lastTerritoryRow"].toInt(0);
-                lastPos.col = generalObj["lastTerritoryCol"].toInt(0);
-                general->setLastTerritory(lastPos);
+        for (const SavedPiece &piece : saved.generals) {
+            if (prisoners.contains(piece.serialNumber)) {
+                continue;
             }
-
-            generalMap[generalObj["serialNumber"].toString()] = general;
+            GeneralPiece *general = new GeneralPiece(playerId, {piece.row, piece.col}, piece.number, player);
+            restoreLeader(general, piece);
             player->addGeneral(general);
         }
 
-        // Load Captured Generals
-        QJsonArray capturedGeneralsArray = playerObj["capturedGenerals"].toArray();
-        for (const QJsonValue &generalValue : capturedGeneralsArray) {
-            QJsonObject generalObj = generalValue.toObject();
-
-            Position pos;
-            pos.row = generalObj["row"].toInt(0);
-            pos.col = generalObj["col"].toInt(0);
-            int number = generalObj["number"].toInt(1);
-            QChar originalPlayer = generalObj["originalPlayer"].toString().at(0);
-
-            GeneralPiece *general = new GeneralPiece(originalPlayer, pos, number, player);
-            general->setTerritoryName(generalObj["territory"].toString());
-            general->setMovesRemaining(generalObj["movesRemaining"].toInt(0));
-            general->setOnGalley(generalObj["onGalley"].toString());
+        // Captured generals keep their own player's colour and remember who holds them
+        for (const SavedPiece &piece : saved.capturedGenerals) {
+            GeneralPiece *general = new GeneralPiece(QChar(piece.originalPlayer), {piece.row, piece.col}, piece.number, player);
+            restorePiece(general, piece);
             general->setCapturedBy(playerId);
-
             player->addCapturedGeneral(general);
         }
 
-        // Load Infantry
-        QJsonArray infantryArray = playerObj["infantry"].toArray();
-        QMap<QString, InfantryPiece*> infantryMap;
-        for (const QJsonValue &infantryValue : infantryArray) {
-            QJsonObject infantryObj = infantryValue.toObject();
-
-            Position pos;
-            pos.row = infantryObj["row"].toInt(0);
-            pos.col = infantryObj["col"].toInt(0);
-
-            InfantryPiece *infantry = new InfantryPiece(playerId, pos, player);
-            infantry->setTerritoryName(infantryObj["territory"].toString());
-            infantry->setMovesRemaining(infantryObj["movesRemaining"].toInt(0));
-            infantry->setOnGalley(infantryObj["onGalley"].toString());
-
-            infantryMap[infantryObj["serialNumber"].toString()] = infantry;
+        for (const SavedPiece &piece : saved.infantry) {
+            InfantryPiece *infantry = new InfantryPiece(playerId, {piece.row, piece.col}, player);
+            restorePiece(infantry, piece);
             player->addInfantry(infantry);
         }
 
-        // Load Cavalry
-        QJsonArray cavalryArray = playerObj["cavalry"].toArray();
-        QMap<QString, CavalryPiece*> cavalryMap;
-        for (const QJsonValue &cavalryValue : cavalryArray) {
-            QJsonObject cavalryObj = cavalryValue.toObject();
-
-            Position pos;
-            pos.row = cavalryObj["row"].toInt(0);
-            pos.col = cavalryObj["col"].toInt(0);
-
-            CavalryPiece *cavalry = new CavalryPiece(playerId, pos, player);
-            cavalry->setTerritoryName(cavalryObj["territory"].toString());
-            cavalry->setMovesRemaining(cavalryObj["movesRemaining"].toInt(0));
-            cavalry->setOnGalley(cavalryObj["onGalley"].toString());
-
-            cavalryMap[cavalryObj["serialNumber"].toString()] = cavalry;
+        for (const SavedPiece &piece : saved.cavalry) {
+            CavalryPiece *cavalry = new CavalryPiece(playerId, {piece.row, piece.col}, player);
+            restorePiece(cavalry, piece);
             player->addCavalry(cavalry);
         }
 
-        // Load Catapults
-        QJsonArray catapultsArray = playerObj["catapults"].toArray();
-        QMap<QString, CatapultPiece*> catapultMap;
-        for (const QJsonValue &catapultValue : catapultsArray) {
-            QJsonObject catapultObj = catapultValue.toObject();
-
-            Position pos;
-            pos.row = catapultObj["row"].toInt(0);
-            pos.col = catapultObj["col"].toInt(0);
-
-            CatapultPiece *catapult = new CatapultPiece(playerId, pos, player);
-            catapult->setTerritoryName(catapultObj["territory"].toString());
-            catapult->setMovesRemaining(catapultObj["movesRemaining"].toInt(0));
-            catapult->setOnGalley(catapultObj["onGalley"].toString());
-
-            catapultMap[catapultObj["serialNumber"].toString()] = catapult;
+        for (const SavedPiece &piece : saved.catapults) {
+            CatapultPiece *catapult = new CatapultPiece(playerId, {piece.row, piece.col}, player);
+            restorePiece(catapult, piece);
             player->addCatapult(catapult);
         }
 
-        // Load Galleys
-        QJsonArray galleysArray = playerObj["galleys"].toArray();
-        QMap<QString, GalleyPiece*> galleyMap;
-        for (const QJsonValue &galleyValue : galleysArray) {
-            QJsonObject galleyObj = galleyValue.toObject();
-
-            Position pos;
-            pos.row = galleyObj["row"].toInt(0);
-            pos.col = galleyObj["col"].toInt(0);
-
-            GalleyPiece *galley = new GalleyPiece(playerId, pos, player);
-            galley->setTerritoryName(galleyObj["territory"].toString());
-            galley->setMovesRemaining(galleyObj["movesRemaining"].toInt(0));
-
-            if (galleyObj.contains("lastTerritoryRow")) {
-                Position lastPos;
-                lastPos.row = galleyObj["lastTerritoryRow"].toInt(0);
-                lastPos.col = galleyObj["lastTerritoryCol"].toInt(0);
-                galley->setLastTerritory(lastPos);
-            }
-
-            galleyMap[galleyObj["serialNumber"].toString()] = galley;
+        for (const SavedPiece &piece : saved.galleys) {
+            GalleyPiece *galley = new GalleyPiece(playerId, {piece.row, piece.col}, player);
+            restoreLeader(galley, piece);
             player->addGalley(galley);
         }
 
-        // Restore legions for Caesars (note: we can't use saved piece IDs since pieces have new IDs)
-        // We need to rebuild legions based on position matching
-        // This is a limitation - we'll restore legion composition by finding pieces at the same location
-        for (const QJsonValue &caesarValue : caesarsArray) {
-            QJsonObject caesarObj = caesarValue.toObject();
-            CaesarPiece *caesar = caesarMap[caesarObj["serialNumber"].toString()];
-
-            if (caesar) {
-                // Find all troops at same position as Caesar
-                Position caesarPos = caesar->getPosition();
-                QList<int> legion;
-
-                for (InfantryPiece *troop : player->getInfantry()) {
-                    if (troop->getPosition().row == caesarPos.row && troop->getPosition().col == caesarPos.col) {
-                        legion.append(troop->getUniqueId());
-                    }
-                }
-                for (CavalryPiece *troop : player->getCavalry()) {
-                    if (troop->getPosition().row == caesarPos.row && troop->getPosition().col == caesarPos.col) {
-                        legion.append(troop->getUniqueId());
-                    }
-                }
-                for (CatapultPiece *troop : player->getCatapults()) {
-                    if (troop->getPosition().row == caesarPos.row && troop->getPosition().col == caesarPos.col) {
-                        legion.append(troop->getUniqueId());
-                    }
-                }
-
-                caesar->setLegion(legion);
-            }
-        }
-
-        // Restore legions for Generals
-        for (const QJsonValue &generalValue : generalsArray) {
-            QJsonObject generalObj = generalValue.toObject();
-            GeneralPiece *general = generalMap[generalObj["serialNumber"].toString()];
-
-            if (general) {
-                Position generalPos = general->getPosition();
-                QList<int> legion;
-
-                for (InfantryPiece *troop : player->getInfantry()) {
-                    if (troop->getPosition().row == generalPos.row && troop->getPosition().col == generalPos.col) {
-                        legion.append(troop->getUniqueId());
-                    }
-                }
-                for (CavalryPiece *troop : player->getCavalry()) {
-                    if (troop->getPosition().row == generalPos.row && troop->getPosition().col == generalPos.col) {
-                        legion.append(troop->getUniqueId());
-                    }
-                }
-                for (CatapultPiece *troop : player->getCatapults()) {
-                    if (troop->getPosition().row == generalPos.row && troop->getPosition().col == generalPos.col) {
-                        legion.append(troop->getUniqueId());
-                    }
-                }
-
-                general->setLegion(legion);
-            }
+        for (const std::vector<SavedPiece> *pieces : {&saved.caesars, &saved.generals, &saved.capturedGenerals,
+                                                      &saved.infantry, &saved.cavalry, &saved.catapults,
+                                                      &saved.galleys}) {
+            track(*pieces);
         }
 
-        // Restore legions for Galleys
-        for (const QJsonValue &galleyValue : galleysArray) {
-            QJsonObject galleyObj = galleyValue.toObject();
-            GalleyPiece *galley = galleyMap[galleyObj["serialNumber"].toString()];
-
-            if (galley) {
-                Position galleyPos = galley->getPosition();
-                QList<int> legion;
-
-                // Add all pieces on this galley
-                for (CaesarPiece *piece : player->getCaesars()) {
-                    if (piece->getPosition().row == galleyPos.row && piece->getPosition().col == galleyPos.col &&
-                        !piece->getOnGalley().isEmpty()) {
-                        legion.append(piece->getUniqueId());
-                    }
-                }
-                for (GeneralPiece *piece : player->getGenerals()) {
-                    if (piece->getPosition().row == galleyPos.row && piece->getPosition().col == galleyPos.col &&
-                        !piece->getOnGalley().isEmpty()) {
-                        legion.append(piece->getUniqueId());
-                    }
-                }
-                for (InfantryPiece *troop : player->getInfantry()) {
-                    if (troop->getPosition().row == galleyPos.row && troop->getPosition().col == galleyPos.col &&
-                        !troop->getOnGalley().isEmpty()) {
-                        legion.append(troop->getUniqueId());
-                    }
-                }
-                for (CavalryPiece *troop : player->getCavalry()) {
-                    if (troop->getPosition().row == galleyPos.row && troop->getPosition().col == galleyPos.col &&
-                        !troop->getOnGalley().isEmpty()) {
-                        legion.append(troop->getUniqueId());
-                    }
-                }
-                for (CatapultPiece *troop : player->getCatapults()) {
-                    if (troop->getPosition().row == galleyPos.row && troop->getPosition().col == galleyPos.col &&
-                        !troop->getOnGalley().isEmpty()) {
-                        legion.append(troop->getUniqueId());
-                    }
-                }
-
-                galley->setLegion(legion);
-            }
-        }
-
-        // Load Cities
-        QJsonArray citiesArray = playerObj["cities"].toArray();
-        for (const QJsonValue &cityValue : citiesArray) {
-            QJsonObject cityObj = cityValue.toObject();
-
-            Position pos;
-            pos.row = cityObj["row"].toInt(0);
-            pos.col = cityObj["col"].toInt(0);
-            QString territory = cityObj["territory"].toString();
-            bool isFortified = cityObj["isFortified"].toBool(false);
-
-            City *city = new City(playerId, pos, territory, isFortified, player);
+        for (const SavedCity &savedCity : saved.cities) {
+            City *city = new City(playerId, {savedCity.row, savedCity.col}, QString::fromStdString(savedCity.territory),
+                                  savedCity.fortified, player);
             player->addCity(city);
         }
 
-        // Load Roads
-        QJsonArray roadsArray = playerObj["roads"].toArray();
-        for (const QJsonValue &roadValue : roadsArray) {
-            QJsonObject roadObj = roadValue.toObject();
-
-            Position fromPos;
-            fromPos.row = roadObj["fromRow"].toInt(0);
-            fromPos.col = roadObj["fromCol"].toInt(0);
-
-            Position toPos;
-            toPos.row = roadObj["toRow"].toInt(0);
-            toPos.col = roadObj["toCol"].toInt(0);
+        for (const SavedRoad &savedRoad : saved.roads) {
+            Position fromPos = {savedRoad.fromRow, savedRoad.fromCol};
+            Position toPos = {savedRoad.toRow, savedRoad.toCol};
 
             // Validate that neither endpoint is a sea territory
             if (mapWidget->isSeaTerritory(fromPos.row, fromPos.col) ||
@@ -678,5 +547,5 @@ bool loadGameFromFile(const QString &fileName, MapWidget *&mapWidget, QList<Play
         players.append(player);
     }
 
-    return true;
+    GamePiece::setCounter(lastInstance);
 }
@@ -1,8 +1,15 @@
 #include "mapwidget.h"
 #include "gamepiece.h"
 #include "player.h"
+#include "building.h"
+#include "rulesengine.h"
+#include "scoreledger.h"
+#include "gamerandom.h"
+#include "savegamejson.h"
+#include "savewriter.h"
+#include "gamestatebridge.h"
+#include "zobrist.h"
 #include <QPainter>
-#include <QRandomGenerator>
 #include <QMouseEvent>
 #include <QContextMenuEvent>
 #include <QMenu>
@@ -16,11 +23,10 @@
 #include <QMimeData>
 #include <QDebug>
 #include <QFileDialog>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
 #include <QFile>
 #include <QMessageBox>
+#include <QProgressDialog>
+#include <QInputDialog>
 #include <QVBoxLayout>
 #include <QApplication>
 #include <QStyle>
@@ -32,6 +38,11 @@
 MapWidget::MapWidget(QWidget *parent)
     : QWidget(parent)
     , m_menuBar(nullptr)
+    , m_undoAction(nullptr)
+    , m_redoAction(nullptr)
+    , m_saveWriter(nullptr)
+    , m_replayStep(-1)
+    , m_replayMenu(nullptr)
     , m_tileWidth(60)
     , m_tileHeight(60)
     , m_dragging(false)
@@ -41,6 +52,10 @@ MapWidget::MapWidget(QWidget *parent)
     , m_currentPlayerIndex(0)
     , m_isAtStartOfTurn(true)
 {
+    // Scores are kept incrementally from player events
+    m_scoreLedger = new ScoreLedger(this, this);
+    connect(m_scoreLedger, &ScoreLedger::scoresChanged, this, &MapWidget::scoresChanged);
+
     // Create menu bar
     createMenuBar();
 
@@ -73,12 +88,9 @@ MapWidget::MapWidget(QWidget *parent)
         }
     }
 
-    // Initialize the map with random land/sea tiles
+    // Initialize the map with random land/sea tiles, names and values
     initializeMap();
 
-    // Assign names and values to territories
-    assignTerritoryNames();
-
     // Place caesars on land tiles
     placeCaesars();
 
@@ -100,12 +112,18 @@ void MapWidget::initializeMap()
         m_hasFortification[row].resize(COLUMNS);
     }
 
-    // Randomly assign each tile as land or sea
-    QRandomGenerator *random = QRandomGenerator::global();
+    // Random land/sea layout, names and tax values come from the rules engine
+    MapState map;
+    RulesEngine::generateMap(map, GameRandom::current().stream(GameRandom::MapGeneration));
+
+    m_territories.resize(ROWS);
     for (int row = 0; row < ROWS; ++row) {
+        m_territories[row].resize(COLUMNS);
         for (int col = 0; col < COLUMNS; ++col) {
-            // 75% chance of land (green), 25% chance of sea (blue)
-            m_tiles[row][col] = (random->bounded(100) < 75) ? TileType::Land : TileType::Sea;
+            int tile = tileIndex(row, col);
+            m_tiles[row][col] = map.isLand(tile) ? TileType::Land : TileType::Sea;
+            m_territories[row][col].name = QString::fromStdString(map.names[tile]);
+            m_territories[row][col].value = map.value[tile];
             // Initialize as unowned
             m_ownership[row][col] = '\0';
             // No cities or fortifications yet
@@ -113,6 +131,36 @@ void MapWidget::initializeMap()
             m_hasFortification[row][col] = false;
         }
     }
+
+    rebuildTerritoryIndex();
+    rebuildReachability();
+}
+
+void MapWidget::rebuildTerritoryIndex()
+{
+    // Intern every territory name under its tile index and bucket tiles by tax value
+    TerritoryNames::clear();
+    m_tilesByValue.clear();
+    for (int row = 0; row < ROWS; ++row) {
+        for (int col = 0; col < COLUMNS; ++col) {
+            int tile = tileIndex(row, col);
+            TerritoryNames::registerName(tile, m_territories[row][col].name);
+            m_tilesByValue[m_territories[row][col].value].set(tile);
+            m_tileValues[tile] = m_territories[row][col].value;
+        }
+    }
+}
+
+void MapWidget::rebuildReachability()
+{
+    TileMask land;
+    for (int row = 0; row < ROWS; ++row) {
+        for (int col = 0; col < COLUMNS; ++col) {
+            land.assign(tileIndex(row, col), m_tiles[row][col] == TileType::Land);
+        }
+    }
+    m_reachability.rebuild(land);
+    m_landTiles = land;
 }
 
 void MapWidget::paintEvent(QPaintEvent *event)
@@ -130,6 +178,9 @@ void MapWidget::paintEvent(QPaintEvent *event)
     m_tileWidth = width() / COLUMNS;
     m_tileHeight = (height() - menuBarHeight - scoreBarHeight) / ROWS;
 
+    // Tiles shared by more than one player get a red X
+    TileMask disputedTiles = getDisputedTiles();
+
     // Draw each tile (offset by menu bar height)
     for (int row = 0; row < ROWS; ++row) {
         for (int col = 0; col < COLUMNS; ++col) {
@@ -159,24 +210,8 @@ void MapWidget::paintEvent(QPaintEvent *event)
                 painter.drawRect(x + 4, y + 4, m_tileWidth - 8, m_tileHeight - 8);
             }
 
-            // Check if this territory is disputed (has pieces from multiple players)
-            bool isDisputed = false;
-            QChar firstPlayer = '\0';
-            ::Position pos = {row, col};  // Use global Position type
-            for (Player *player : m_players) {
-                QList<GamePiece*> pieces = player->getPiecesAtPosition(pos);
-                if (!pieces.isEmpty()) {
-                    if (firstPlayer == '\0') {
-                        firstPlayer = player->getId();
-                    } else if (firstPlayer != player->getId()) {
-                        isDisputed = true;
-                        break;
-                    }
-                }
-            }
-
-            // Draw disputed territory indicator (diagonal stripes)
-            if (isDisputed) {
+            // Draw disputed territory indicator if pieces from multiple players share this tile
+            if (disputedTiles.test(tileIndex(row, col))) {
                 painter.save();
                 painter.setPen(QPen(QColor(255, 0, 0), 3));  // Red, thick line
 
@@ -337,8 +372,15 @@ void MapWidget::paintEvent(QPaintEvent *event)
     for (Player *player : m_players) {
         QChar playerId = player->getId();
 
-        // Get all pieces for this player
+        // Get all pieces for this player, and its generals held prisoner (drawn where they are held)
         QList<GamePiece*> allPieces = player->getAllPieces();
+        for (Player *holder : m_players) {
+            for (GeneralPiece *general : holder->getCapturedGenerals()) {
+                if (general->getPlayer() == playerId) {
+                    allPieces.append(general);
+                }
+            }
+        }
 
         // Group pieces by position
         QMap<Position, QVector<GamePiece*>> piecesAtPosition;
@@ -490,8 +532,6 @@ void MapWidget::paintEvent(QPaintEvent *event)
 
 void MapWidget::placeCaesars()
 {
-    QRandomGenerator *random = QRandomGenerator::global();
-
     // Collect all land tiles
     QVector<Position> landTiles;
     for (int row = 0; row < ROWS; ++row) {
@@ -509,7 +549,7 @@ void MapWidget::placeCaesars()
     }
 
     // Shuffle the land tiles and pick the first 6
-    std::shuffle(landTiles.begin(), landTiles.end(), *random);
+    GameRandom::current().stream(GameRandom::MapGeneration).shuffle(landTiles.begin(), landTiles.end());
 
     // Create pieces for each player (A-F)
     const QString playerLetters = "ABCDEF";
@@ -552,75 +592,6 @@ void MapWidget::placeCaesars()
     }
 }
 
-void MapWidget::assignTerritoryNames()
-{
-    // Large list of animal names for land territories
-    QStringList animalNames = {
-        "Lion", "Tiger", "Bear", "Wolf", "Eagle", "Hawk", "Falcon", "Owl",
-        "Fox", "Deer", "Moose", "Elk", "Bison", "Buffalo", "Zebra", "Giraffe",
-        "Elephant", "Rhino", "Hippo", "Crocodile", "Alligator", "Snake", "Cobra", "Viper",
-        "Panther", "Leopard", "Cheetah", "Jaguar", "Cougar", "Lynx", "Bobcat", "Ocelot",
-        "Monkey", "Gorilla", "Chimp", "Orangutan", "Lemur", "Baboon", "Mandrill", "Gibbon",
-        "Rabbit", "Hare", "Squirrel", "Chipmunk", "Raccoon", "Badger", "Weasel", "Ferret",
-        "Raven", "Crow", "Parrot", "Peacock", "Swan", "Goose", "Duck", "Crane",
-        "Horse", "Stallion", "Mare", "Donkey", "Mule", "Camel", "Llama", "Alpaca",
-        "Panda", "Koala", "Sloth", "Armadillo", "Anteater", "Platypus", "Echidna", "Wombat",
-        "Kangaroo", "Wallaby", "Opossum", "Skunk", "Porcupine", "Hedgehog", "Mole", "Shrew",
-        "Bat", "Condor", "Vulture", "Kite", "Osprey", "Harrier", "Buzzard", "Kestrel"
-    };
-
-    // List of fish names for sea territories
-    QStringList fishNames = {
-        "Salmon", "Tuna", "Bass", "Trout", "Pike", "Carp", "Catfish", "Perch",
-        "Cod", "Haddock", "Halibut", "Flounder", "Sole", "Mackerel", "Herring", "Sardine",
-        "Anchovy", "Barracuda", "Marlin", "Swordfish", "Sailfish", "Mahi", "Grouper", "Snapper",
-        "Sturgeon", "Eel", "Lamprey", "Pufferfish", "Angelfish", "Clownfish", "Tang", "Wrasse",
-        "Seahorse", "Stingray", "Manta", "Jellyfish", "Octopus", "Squid", "Cuttlefish", "Nautilus",
-        "Lobster", "Crab", "Shrimp", "Krill", "Starfish", "Urchin", "Anemone", "Coral"
-    };
-
-    // Shuffle both lists
-    QRandomGenerator *random = QRandomGenerator::global();
-    std::shuffle(animalNames.begin(), animalNames.end(), *random);
-    std::shuffle(fishNames.begin(), fishNames.end(), *random);
-
-    // Resize territories array
-    m_territories.resize(ROWS);
-    for (int row = 0; row < ROWS; ++row) {
-        m_territories[row].resize(COLUMNS);
-    }
-
-    // Assign names and values
-    int animalIndex = 0;
-    int fishIndex = 0;
-    for (int row = 0; row < ROWS; ++row) {
-        for (int col = 0; col < COLUMNS; ++col) {
-            if (m_tiles[row][col] == TileType::Land) {
-                // Assign unique animal name
-                if (animalIndex < animalNames.size()) {
-                    m_territories[row][col].name = animalNames[animalIndex++];
-                } else {
-                    // Fallback if we run out of names (shouldn't happen with 96 names)
-                    m_territories[row][col].name = QString("Territory%1").arg(animalIndex++);
-                }
-
-                // Randomly assign value of 5 or 10 for land territories only
-                m_territories[row][col].value = (random->bounded(2) == 0) ? 5 : 10;
-            } else {
-                // Sea tiles get fish names
-                if (fishIndex < fishNames.size()) {
-                    m_territories[row][col].name = fishNames[fishIndex++];
-                } else {
-                    // Fallback if we run out of names
-                    m_territories[row][col].name = QString("Sea%1").arg(fishIndex++);
-                }
-                // Sea territories have no tax value
-                m_territories[row][col].value = 0;
-            }
-        }
-    }
-}
-
 bool MapWidget::isInsidePiece(const QPoint &pos, const Position &piecePos, int radius) const
 {
     int tileWidth = width() / COLUMNS;
@@ -837,73 +808,11 @@ bool MapWidget::event(QEvent *event)
 
 bool MapWidget::isValidMove(const Position &from, const Position &to) const
 {
-    // Must be on a land tile (not sea)
-    if (m_tiles[to.row][to.col] != TileType::Land) {
-        return false;
-    }
-
-    // Calculate differences
-    int rowDiff = to.row - from.row;
-    int colDiff = to.col - from.col;
-    int absRowDiff = qAbs(rowDiff);
-    int absColDiff = qAbs(colDiff);
-
-    // Total Manhattan distance must be <= 2
-    int totalDistance = absRowDiff + absColDiff;
-    if (totalDistance > 2) {
+    if (!isOnBoard(from.row, from.col) || !isOnBoard(to.row, to.col)) {
         return false;
     }
 
-    // No movement (staying in same square) is valid
-    if (totalDistance == 0) {
-        return true;
-    }
-
-    // If moving in only one direction (horizontal or vertical), check all intermediate squares
-    if (absRowDiff == 0 || absColDiff == 0) {
-        // Moving horizontally
-        if (absRowDiff == 0) {
-            int start = qMin(from.col, to.col);
-            int end = qMax(from.col, to.col);
-            for (int c = start + 1; c < end; ++c) {
-                if (m_tiles[from.row][c] != TileType::Land) {
-                    return false;  // Path blocked by sea
-                }
-            }
-            return true;
-        }
-        // Moving vertically
-        else {
-            int start = qMin(from.row, to.row);
-            int end = qMax(from.row, to.row);
-            for (int r = start + 1; r < end; ++r) {
-                if (m_tiles[r][from.col] != TileType::Land) {
-                    return false;  // Path blocked by sea
-                }
-            }
-            return true;
-        }
-    }
-
-    // If moving diagonally (both row and col change), need to check if there's
-    // a valid path through land tiles. We can go either:
-    // 1. Horizontal first, then vertical
-    // 2. Vertical first, then horizontal
-
-    // Check path 1: horizontal first, then vertical
-    Position intermediate1 = {from.row, to.col};
-    if (m_tiles[intermediate1.row][intermediate1.col] == TileType::Land) {
-        return true;
-    }
-
-    // Check path 2: vertical first, then horizontal
-    Position intermediate2 = {to.row, from.col};
-    if (m_tiles[intermediate2.row][intermediate2.col] == TileType::Land) {
-        return true;
-    }
-
-    // No valid path found
-    return false;
+    return m_reachability.landReach(tileIndex(from.row, from.col)).test(tileIndex(to.row, to.col));
 }
 
 QColor MapWidget::getPlayerColor(QChar player) const
@@ -921,24 +830,62 @@ QColor MapWidget::getPlayerColor(QChar player) const
 
 QMap<QChar, int> MapWidget::calculateScores() const
 {
-    QMap<QChar, int> scores;
+    return m_scoreLedger->getScores();
+}
 
-    // Initialize all scores to 0
-    for (char c = 'A'; c <= 'F'; ++c) {
-        scores[QChar(c)] = 0;
+void MapWidget::setPlayers(const QList<Player*> &players)
+{
+    for (Player *player : m_players) {
+        disconnect(player, nullptr, this, nullptr);
     }
+    m_players = players;
+    m_scoreLedger->setPlayers(players);
 
-    // Sum up territory values for each player
-    for (int row = 0; row < ROWS; ++row) {
-        for (int col = 0; col < COLUMNS; ++col) {
-            QChar owner = m_ownership[row][col];
-            if (owner != '\0') {
-                scores[owner] += m_territories[row][col].value;
+    // Keep roads in step with the events that can create or break them
+    for (Player *player : m_players) {
+        connect(player, &Player::buildingAdded, this, [this, player](Building *building) {
+            if (building->getType() == Building::Type::City) {
+                addRoadsAround(player, territoryIdAt(building->getPosition()));
+                update();
             }
-        }
+        });
+        connect(player, &Player::buildingRemoved, this, [this, player](Building *building) {
+            if (building->getType() == Building::Type::City) {
+                removeRoadsAround(player, territoryIdAt(building->getPosition()));
+                update();
+            }
+        });
+        connect(player, &Player::territoryClaimed, this, [this, player](TerritoryId territory) {
+            addRoadsAround(player, territory);
+            update();
+        });
+    }
+
+    updateRoads();
+}
+
+uint64_t MapWidget::getGameHash() const
+{
+    // Each player keeps its own share up to date; the player to move is in the mover's share
+    uint64_t hash = 0;
+    for (Player *player : m_players) {
+        hash += player->getZobristHash();
     }
+    return hash;
+}
 
-    return scores;
+void MapWidget::verifyGameHash(const GameState &state) const
+{
+#ifdef QT_DEBUG
+    uint64_t expected = Zobrist::hash(state);
+    uint64_t actual = getGameHash();
+    if (expected != actual) {
+        qWarning() << "Game hash out of sync - incremental" << actual << "expected" << expected;
+        Q_ASSERT_X(false, "MapWidget::verifyGameHash", "incremental hash disagrees with full recompute");
+    }
+#else
+    Q_UNUSED(state);
+#endif
 }
 
 QString MapWidget::getTerritoryNameAt(int row, int col) const
@@ -959,6 +906,30 @@ int MapWidget::getTerritoryValueAt(int row, int col) const
     return m_territories[row][col].value;
 }
 
+Position MapWidget::getTerritoryPosition(const QString &name) const
+{
+    return territoryPosition(TerritoryNames::idOf(name));
+}
+
+int MapWidget::getTerritoryValue(TerritoryId territory) const
+{
+    if (territory < 0 || territory >= ROWS * COLUMNS) {
+        return 0;
+    }
+
+    return m_territories[tileRow(territory)][tileColumn(territory)].value;
+}
+
+int MapWidget::getTerritoryValue(const TileMask &territories) const
+{
+    // One popcount per distinct tax value instead of a lookup per territory
+    int total = 0;
+    for (auto it = m_tilesByValue.constBegin(); it != m_tilesByValue.constEnd(); ++it) {
+        total += it.key() * (territories & it.value()).count();
+    }
+    return total;
+}
+
 bool MapWidget::isSeaTerritory(int row, int col) const
 {
     if (row < 0 || row >= ROWS || col < 0 || col >= COLUMNS) {
@@ -971,20 +942,17 @@ bool MapWidget::isSeaTerritory(int row, int col) const
 QList<Position> MapWidget::getAdjacentSeaTerritories(const Position &pos) const
 {
     QList<Position> seaTerritories;
+    if (!isOnBoard(pos.row, pos.col)) {
+        return seaTerritories;
+    }
 
-    // Check all 4 adjacent positions (up, down, left, right)
-    QVector<Position> adjacentPositions = {
-        {pos.row - 1, pos.col},     // up
-        {pos.row + 1, pos.col},     // down
-        {pos.row, pos.col - 1},     // left
-        {pos.row, pos.col + 1}      // right
+    // Adjacent tiles minus land, listed up, down, left, right
+    TileMask sea = m_reachability.neighbours(tileIndex(pos.row, pos.col)) & ~m_reachability.land();
+    const Position adjacentPositions[4] = {
+        {pos.row - 1, pos.col}, {pos.row + 1, pos.col}, {pos.row, pos.col - 1}, {pos.row, pos.col + 1}
     };
-
     for (const Position &adjPos : adjacentPositions) {
-        // Check if position is valid and is a sea territory
-        if (adjPos.row >= 0 && adjPos.row < ROWS &&
-            adjPos.col >= 0 && adjPos.col < COLUMNS &&
-            isSeaTerritory(adjPos.row, adjPos.col)) {
+        if (isOnBoard(adjPos.row, adjPos.col) && sea.test(tileIndex(adjPos.row, adjPos.col))) {
             seaTerritories.append(adjPos);
         }
     }
@@ -995,32 +963,19 @@ QList<Position> MapWidget::getAdjacentSeaTerritories(const Position &pos) const
 QVector<MapWidget::HomeProvinceInfo> MapWidget::getRandomHomeProvinces()
 {
     QVector<HomeProvinceInfo> homeProvinces;
-    QRandomGenerator *random = QRandomGenerator::global();
 
-    // Collect all land tiles that are adjacent to at least one sea territory
-    QVector<Position> coastalLandTiles;
-    for (int row = 0; row < ROWS; ++row) {
-        for (int col = 0; col < COLUMNS; ++col) {
-            if (m_tiles[row][col] == TileType::Land) {
-                Position pos = {row, col};
-                // Check if this land tile is adjacent to any sea territory
-                QList<Position> adjacentSeas = getAdjacentSeaTerritories(pos);
-                if (!adjacentSeas.isEmpty()) {
-                    coastalLandTiles.append(pos);
-                }
-            }
-        }
-    }
+    MapState map = getMapState();
 
-    // Shuffle and select first 6 as home provinces
-    std::shuffle(coastalLandTiles.begin(), coastalLandTiles.end(), *random);
+    // Random coastal land tiles (adjacent to at least one sea territory)
+    std::vector<int> coastalLandTiles =
+        RulesEngine::chooseHomeProvinces(map, GameRandom::current().stream(GameRandom::MapGeneration), 6);
 
-    for (int i = 0; i < 6 && i < coastalLandTiles.size(); ++i) {
+    for (int i = 0; i < static_cast<int>(coastalLandTiles.size()); ++i) {
         HomeProvinceInfo info;
         // Use Position from common.h
-        info.position.row = coastalLandTiles[i].row;
-        info.position.col = coastalLandTiles[i].col;
-        info.name = m_territories[coastalLandTiles[i].row][coastalLandTiles[i].col].name;
+        info.position.row = tileRow(coastalLandTiles[i]);
+        info.position.col = tileColumn(coastalLandTiles[i]);
+        info.name = m_territories[info.position.row][info.position.col].name;
         homeProvinces.append(info);
 
         qDebug() << "Selected home province for player" << (char)('A' + i) << "at"
@@ -1029,13 +984,27 @@ QVector<MapWidget::HomeProvinceInfo> MapWidget::getRandomHomeProvinces()
     }
 
     if (coastalLandTiles.size() < 6) {
-        qWarning() << "Warning: Only found" << coastalLandTiles.size()
+        qWarning() << "Warning: Only found" << static_cast<int>(coastalLandTiles.size())
                    << "coastal land tiles for home provinces. Need 6 for all players!";
     }
 
     return homeProvinces;
 }
 
+MapState MapWidget::getMapState() const
+{
+    MapState map;
+    for (int row = 0; row < ROWS; ++row) {
+        for (int col = 0; col < COLUMNS; ++col) {
+            int tile = tileIndex(row, col);
+            map.land.assign(tile, m_tiles[row][col] == TileType::Land);
+            map.names[tile] = m_territories[row][col].name.toStdString();
+            map.value[tile] = m_territories[row][col].value;
+        }
+    }
+    return map;
+}
+
 QChar MapWidget::getTerritoryOwnerAt(int row, int col) const
 {
     if (row < 0 || row >= ROWS || col < 0 || col >= COLUMNS) {
@@ -1043,9 +1012,9 @@ QChar MapWidget::getTerritoryOwnerAt(int row, int col) const
     }
 
     // Query players to find who owns this territory
-    QString territoryName = m_territories[row][col].name;
+    TerritoryId territory = tileIndex(row, col);
     for (Player *player : m_players) {
-        if (player->ownsTerritory(territoryName)) {
+        if (player->ownsTerritory(territory)) {
             return player->getId();
         }
     }
@@ -1059,20 +1028,10 @@ bool MapWidget::hasEnemyPiecesAt(int row, int col, QChar currentPlayer) const
         return false;
     }
 
-    // Create Position from common.h
-    ::Position pos;
-    pos.row = row;
-    pos.col = col;
-
     // Check all players except the current player
+    int tile = tileIndex(row, col);
     for (Player *player : m_players) {
-        if (player->getId() == currentPlayer) {
-            continue;
-        }
-
-        // Check if this player has any pieces at this position
-        QList<GamePiece*> pieces = player->getPiecesAtPosition(pos);
-        if (!pieces.isEmpty()) {
+        if (player->getId() != currentPlayer && player->getOccupiedTiles().test(tile)) {
             return true;
         }
     }
@@ -1080,10 +1039,36 @@ bool MapWidget::hasEnemyPiecesAt(int row, int col, QChar currentPlayer) const
     return false;
 }
 
+TileMask MapWidget::getDisputedTiles() const
+{
+    TileMask seen;
+    TileMask disputed;
+    for (Player *player : m_players) {
+        const TileMask &occupied = player->getOccupiedTiles();
+        disputed |= seen & occupied;
+        seen |= occupied;
+    }
+    return disputed;
+}
+
+TileMask MapWidget::getCombatTiles(QChar player) const
+{
+    TileMask own;
+    TileMask enemy;
+    for (Player *p : m_players) {
+        if (p->getId() == player) {
+            own = p->getOccupiedTiles();
+        } else {
+            enemy |= p->getOccupiedTiles();
+        }
+    }
+    return own & enemy;
+}
+
 void MapWidget::dragEnterEvent(QDragEnterEvent *event)
 {
-    // Accept if we have text data (item type from placement dialog)
-    if (event->mimeData()->hasText()) {
+    // Accept if we have text data (item type from placement dialog), unless viewing a replay
+    if (event->mimeData()->hasText() && !isReplaying()) {
         event->acceptProposedAction();
     }
 }
@@ -1214,6 +1199,9 @@ void MapWidget::createMenuBar()
     );
     connect(saveAction, &QAction::triggered, this, &MapWidget::saveGame);
 
+    QAction *saveReplayAction = fileMenu->addAction("Save &Replay...");
+    connect(saveReplayAction, &QAction::triggered, this, &MapWidget::saveReplayRequested);
+
     QAction *loadAction = fileMenu->addAction(
         QApplication::style()->standardIcon(QStyle::SP_DialogOpenButton),
         "&Load Game..."
@@ -1228,6 +1216,66 @@ void MapWidget::createMenuBar()
     );
     connect(exitAction, &QAction::triggered, qApp, &QApplication::quit);
 
+    // Edit menu (enabled by the player info widget as its history changes)
+    QMenu *editMenu = m_menuBar->addMenu("&Edit");
+
+    m_undoAction = editMenu->addAction("&Undo");
+    m_undoAction->setShortcut(QKeySequence::Undo);
+    m_undoAction->setEnabled(false);
+    connect(m_undoAction, &QAction::triggered, this, &MapWidget::undoRequested);
+
+    m_redoAction = editMenu->addAction("&Redo");
+    m_redoAction->setShortcut(QKeySequence::Redo);
+    m_redoAction->setEnabled(false);
+    connect(m_redoAction, &QAction::triggered, this, &MapWidget::redoRequested);
+
+    // Replay menu (only shown while viewing a replay)
+    m_replayMenu = m_menuBar->addMenu("&Replay");
+    m_replayMenu->menuAction()->setVisible(false);
+
+    QAction *firstAction = m_replayMenu->addAction("&Start of Game");
+    firstAction->setShortcut(Qt::Key_Home);
+    connect(firstAction, &QAction::triggered, this, [this]() { showReplayStep(0); });
+
+    QAction *previousTurnAction = m_replayMenu->addAction("Previous &Turn");
+    previousTurnAction->setShortcut(Qt::Key_PageUp);
+    connect(previousTurnAction, &QAction::triggered, this, [this]() {
+        // Back to the start of this turn, or of the one before if already there
+        int turn = m_replay.turnOf(m_replayStep);
+        int start = m_replay.firstStepOfTurn(turn);
+        showReplayStep(start < m_replayStep || turn == 0 ? start : m_replay.firstStepOfTurn(turn - 1));
+    });
+
+    QAction *previousAction = m_replayMenu->addAction("&Previous Action");
+    previousAction->setShortcut(Qt::Key_Left);
+    connect(previousAction, &QAction::triggered, this, [this]() { showReplayStep(m_replayStep - 1); });
+
+    QAction *nextAction = m_replayMenu->addAction("&Next Action");
+    nextAction->setShortcut(Qt::Key_Right);
+    connect(nextAction, &QAction::triggered, this, [this]() { showReplayStep(m_replayStep + 1); });
+
+    QAction *nextTurnAction = m_replayMenu->addAction("Next T&urn");
+    nextTurnAction->setShortcut(Qt::Key_PageDown);
+    connect(nextTurnAction, &QAction::triggered, this, [this]() {
+        int turn = m_replay.turnOf(m_replayStep);
+        showReplayStep(turn + 1 < m_replay.turns() ? m_replay.firstStepOfTurn(turn + 1) : m_replay.steps() - 1);
+    });
+
+    QAction *lastAction = m_replayMenu->addAction("&End of Game");
+    lastAction->setShortcut(Qt::Key_End);
+    connect(lastAction, &QAction::triggered, this, [this]() { showReplayStep(m_replay.steps() - 1); });
+
+    m_replayMenu->addSeparator();
+
+    QAction *goToAction = m_replayMenu->addAction("&Go to Turn...");
+    goToAction->setShortcut(QKeySequence("Ctrl+G"));
+    connect(goToAction, &QAction::triggered, this, &MapWidget::goToReplayTurn);
+
+    // Enabled by startReplay, so the arrow keys do nothing in a normal game
+    for (QAction *action : m_replayMenu->actions()) {
+        action->setEnabled(false);
+    }
+
     // Help menu
     QMenu *helpMenu = m_menuBar->addMenu("&Help");
 
@@ -1242,6 +1290,71 @@ void MapWidget::createMenuBar()
     m_menuBar->show();
 }
 
+void MapWidget::setUndoRedoState(bool canUndo, const QString &undoLabel, bool canRedo, const QString &redoLabel)
+{
+    if (!m_undoAction || !m_redoAction) {
+        return;
+    }
+
+    m_undoAction->setEnabled(canUndo);
+    m_undoAction->setText(canUndo ? QString("&Undo %1").arg(undoLabel) : QString("&Undo"));
+    m_redoAction->setEnabled(canRedo);
+    m_redoAction->setText(canRedo ? QString("&Redo %1").arg(redoLabel) : QString("&Redo"));
+}
+
+// ========== Replay Viewer ==========
+
+void MapWidget::startReplay(const GameReplay &replay)
+{
+    m_replay = replay;
+    m_replayMenu->menuAction()->setVisible(true);
+    for (QAction *action : m_replayMenu->actions()) {
+        action->setEnabled(true);
+    }
+    m_undoAction->setEnabled(false);
+    m_redoAction->setEnabled(false);
+    showReplayStep(0);
+}
+
+void MapWidget::showReplayStep(int step)
+{
+    if (step < 0 || step >= m_replay.steps() || step == m_replayStep) {
+        return;
+    }
+
+    // Seeking only rebuilds the state; no dialogs, combat or dice are involved
+    GameState state;
+    GameReplay::Extras extras;
+    if (!m_replay.seek(step, state, extras) || state.players.size() != static_cast<size_t>(m_players.size()) ||
+        state.currentPlayer < 0 || state.currentPlayer >= state.playerCount()) {
+        QMessageBox::warning(this, "Replay", QString("Action %1 of the replay could not be read.").arg(step));
+        return;
+    }
+
+    m_replayStep = step;
+    GameStateBridge::restore(this, m_players, state);
+    m_isAtStartOfTurn = extras.atStartOfTurn;
+
+    QString action = step == 0 ? QString("Start of game") : QString::fromStdString(m_replay.label(step));
+    setWindowTitle(QString("Replay - Turn %1 of %2, Player %3 - Action %4 of %5: %6")
+                   .arg(m_replay.turnOf(step) + 1)
+                   .arg(m_replay.turns())
+                   .arg(QChar(state.players[state.currentPlayer].id))
+                   .arg(step)
+                   .arg(m_replay.steps() - 1)
+                   .arg(action));
+}
+
+void MapWidget::goToReplayTurn()
+{
+    bool ok = false;
+    int turn = QInputDialog::getInt(this, "Go to Turn", QString("Turn (1-%1):").arg(m_replay.turns()),
+                                    m_replay.turnOf(m_replayStep) + 1, 1, m_replay.turns(), 1, &ok);
+    if (ok) {
+        showReplayStep(m_replay.firstStepOfTurn(turn - 1));
+    }
+}
+
 void MapWidget::resizeEvent(QResizeEvent *event)
 {
     QWidget::resizeEvent(event);
@@ -1254,6 +1367,13 @@ void MapWidget::resizeEvent(QResizeEvent *event)
 
 void MapWidget::closeEvent(QCloseEvent *event)
 {
+    // Nothing to lose when viewing a replay
+    if (isReplaying()) {
+        event->accept();
+        qApp->quit();
+        return;
+    }
+
     // Warn user about losing game progress
     QMessageBox::StandardButton reply;
     reply = QMessageBox::warning(this, "Exit Game",
@@ -1263,8 +1383,9 @@ void MapWidget::closeEvent(QCloseEvent *event)
                                 QMessageBox::Save | QMessageBox::Discard | QMessageBox::Cancel);
 
     if (reply == QMessageBox::Save) {
-        // Try to save the game
+        // Try to save the game, and let it finish writing before the app goes away
         saveGame();
+        finishSave();
         // Only exit if we're at start of turn (save would have succeeded)
         if (m_isAtStartOfTurn) {
             event->accept();
@@ -1284,7 +1405,8 @@ void MapWidget::closeEvent(QCloseEvent *event)
             }
         }
     } else if (reply == QMessageBox::Discard) {
-        // Exit without saving
+        // Exit without saving (an earlier save still in progress is completed)
+        finishSave();
         event->accept();
         qApp->quit();
     } else {
@@ -1295,6 +1417,11 @@ void MapWidget::closeEvent(QCloseEvent *event)
 
 void MapWidget::saveGame()
 {
+    if (isReplaying()) {
+        QMessageBox::information(this, "Cannot Save", "A replay can't be saved as a game.");
+        return;
+    }
+
     // Check if we're at the start of a turn
     if (!m_isAtStartOfTurn) {
         QMessageBox::warning(this, "Cannot Save",
@@ -1303,6 +1430,13 @@ void MapWidget::saveGame()
         return;
     }
 
+    if (m_saveWriter) {
+        QMessageBox::information(this, "Save In Progress",
+                                 "The last save is still being written.\n"
+                                 "Please try again in a moment.");
+        return;
+    }
+
     // Get last used directory from settings, default to Documents folder
     QSettings settings("ConquestOfTheEmpire", "MapWidget");
     QString lastDir = settings.value("lastSaveDirectory",
@@ -1311,7 +1445,7 @@ void MapWidget::saveGame()
     QString fileName = QFileDialog::getSaveFileName(this,
                                                     "Save Game",
                                                     lastDir,
-                                                    "JSON Files (*.json)");
+                                                    "Binary Saves (*.ctes);;JSON Files (*.json)");
 
     if (fileName.isEmpty()) {
         return;
@@ -1321,225 +1455,164 @@ void MapWidget::saveGame()
     QFileInfo fileInfo(fileName);
     settings.setValue("lastSaveDirectory", fileInfo.absolutePath());
 
-    QJsonObject gameState;
+    // Copy the game out now; encoding and writing happen on the writer's thread
+    m_saveWriter = new SaveWriter(captureSaveGame(), fileName, this);
+
+    // Only appears if the save is still running after the minimum duration
+    QProgressDialog *progress = new QProgressDialog("Saving game...", QString(), 0, 100, this);
+    progress->setWindowTitle("Save Game");
+    progress->setMinimumDuration(500);
+    connect(m_saveWriter, &SaveWriter::progress, progress, &QProgressDialog::setValue);
+    connect(m_saveWriter, &QThread::finished, progress, &QObject::deleteLater);
+    connect(m_saveWriter, &SaveWriter::saved, this, &MapWidget::saveFinished);
+    m_saveWriter->start();
+}
+
+void MapWidget::saveFinished(bool ok, const QString &error)
+{
+    if (!m_saveWriter) {
+        return;
+    }
+
+    // saved() is the writer's last act, so this returns at once
+    QString fileName = m_saveWriter->fileName();
+    m_saveWriter->wait();
+    m_saveWriter->deleteLater();
+    m_saveWriter = nullptr;
+
+    if (ok) {
+        QMessageBox::information(this, "Game Saved",
+                               QString("Game saved successfully to:\n%1").arg(fileName));
+    } else {
+        QMessageBox::critical(this, "Save Failed",
+                            QString("Failed to save game to:\n%1\n\n%2").arg(fileName, error));
+    }
+}
+
+void MapWidget::finishSave()
+{
+    if (m_saveWriter) {
+        m_saveWriter->wait();
+        // Deliver the queued saved() now rather than from an event loop that is about to stop
+        QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    }
+}
+
+// Fields shared by every piece type; the caller fills in the type-specific ones
+static SavedPiece savedPiece(const GamePiece *piece)
+{
+    SavedPiece saved;
+    saved.serialNumber = piece->getUniqueId();
+    saved.row = piece->getPosition().row;
+    saved.col = piece->getPosition().col;
+    saved.territory = piece->getTerritoryName().toStdString();
+    saved.movesRemaining = piece->getMovesRemaining();
+    saved.onGalley = piece->getOnGalley().toInt();
+    return saved;
+}
+
+template <typename Leader>
+static SavedPiece savedLeader(const Leader *leader)
+{
+    SavedPiece saved = savedPiece(leader);
+    for (int pieceId : leader->getLegion()) {
+        saved.legion.push_back(pieceId);
+    }
+    if (leader->hasLastTerritory()) {
+        saved.lastRow = leader->getLastTerritory().row;
+        saved.lastCol = leader->getLastTerritory().col;
+    }
+    return saved;
+}
+
+SaveGame MapWidget::captureSaveGame() const
+{
+    SaveGame save;
 
     // Save current player index
-    gameState["currentPlayerIndex"] = m_currentPlayerIndex;
+    save.currentPlayerIndex = m_currentPlayerIndex;
+
+    // Save the random seed and stream positions so rolls continue after loading
+    GameRandom &random = GameRandom::current();
+    save.hasRandomState = true;
+    save.randomSeed = random.seed();
+    for (uint64_t word : random.saveState()) {
+        save.randomState.push_back(word);
+    }
 
     // Save map state (territories with their names and values)
-    QJsonArray territoriesArray;
     for (int row = 0; row < ROWS; ++row) {
         for (int col = 0; col < COLUMNS; ++col) {
-            QJsonObject territoryObj;
-            territoryObj["row"] = row;
-            territoryObj["col"] = col;
-            territoryObj["name"] = m_territories[row][col].name;
-            territoryObj["value"] = m_territories[row][col].value;
-            territoryObj["isLand"] = (m_tiles[row][col] == TileType::Land);
-            territoriesArray.append(territoryObj);
+            SavedTerritory &territory = save.territories[tileIndex(row, col)];
+            territory.name = m_territories[row][col].name.toStdString();
+            territory.value = m_territories[row][col].value;
+            territory.isLand = (m_tiles[row][col] == TileType::Land);
         }
     }
-    gameState["territories"] = territoriesArray;
 
     // Save all players
-    QJsonArray playersArray;
     for (Player *player : m_players) {
-        QJsonObject playerObj;
-        playerObj["id"] = QString(player->getId());
-        playerObj["wallet"] = player->getWallet();
-        playerObj["homeRow"] = player->getHomeProvince().row;
-        playerObj["homeCol"] = player->getHomeProvince().col;
-        playerObj["homeName"] = player->getHomeProvinceName();
-
-        // Save owned territories
-        QJsonArray territoriesArray;
+        SavedPlayer saved;
+        saved.id = player->getId().toLatin1();
+        saved.wallet = player->getWallet();
+        saved.computer = player->isComputerControlled();
+        saved.homeRow = player->getHomeProvince().row;
+        saved.homeCol = player->getHomeProvince().col;
+        saved.homeName = player->getHomeProvinceName().toStdString();
+
         for (const QString &territory : player->getOwnedTerritories()) {
-            territoriesArray.append(territory);
+            saved.ownedTerritories.push_back(territory.toStdString());
         }
-        playerObj["ownedTerritories"] = territoriesArray;
 
-        // Save Caesar
-        QJsonArray caesarsArray;
         for (CaesarPiece *caesar : player->getCaesars()) {
-            QJsonObject caesarObj;
-            caesarObj["serialNumber"] = caesar->getSerialNumber();
-            caesarObj["row"] = caesar->getPosition().row;
-            caesarObj["col"] = caesar->getPosition().col;
-            caesarObj["territory"] = caesar->getTerritoryName();
-            caesarObj["movesRemaining"] = caesar->getMovesRemaining();
-            caesarObj["onGalley"] = caesar->getOnGalley();
-
-            // Save legion
-            QJsonArray legionArray;
-            for (int pieceId : caesar->getLegion()) {
-                legionArray.append(pieceId);
-            }
-            caesarObj["legion"] = legionArray;
-
-            // Save last territory
-            if (caesar->hasLastTerritory()) {
-                caesarObj["lastTerritoryRow"] = caesar->getLastTerritory().row;
-                caesarObj["lastTerritoryCol"] = caesar->getLastTerritory().col;
-            }
-
-            caesarsArray.append(caesarObj);
+            saved.caesars.push_back(savedLeader(caesar));
         }
-        playerObj["caesars"] = caesarsArray;
-
-        // Save Generals
-        QJsonArray generalsArray;
         for (GeneralPiece *general : player->getGenerals()) {
-            QJsonObject generalObj;
-            generalObj["serialNumber"] = general->getSerialNumber();
-            generalObj["number"] = general->getNumber();
-            generalObj["row"] = general->getPosition().row;
-            generalObj["col"] = general->getPosition().col;
-            generalObj["territory"] = general->getTerritoryName();
-            generalObj["movesRemaining"] = general->getMovesRemaining();
-            generalObj["onGalley"] = general->getOnGalley();
-
-            // Save legion
-            QJsonArray legionArray;
-            for (int pieceId : general->getLegion()) {
-                legionArray.append(pieceId);
-            }
-            generalObj["legion"] = legionArray;
-
-            // Save last territory
-            if (general->hasLastTerritory()) {
-                generalObj["lastTerritoryRow"] = general->getLastTerritory().row;
-                generalObj["lastTerritoryCol"] = general->getLastTerritory().col;
-            }
-
-            generalsArray.append(generalObj);
+            SavedPiece piece = savedLeader(general);
+            piece.number = general->getNumber();
+            saved.generals.push_back(piece);
         }
-        playerObj["generals"] = generalsArray;
-
-        // Save Captured Generals
-        QJsonArray capturedGeneralsArray;
         for (GeneralPiece *general : player->getCapturedGenerals()) {
-            QJsonObject generalObj;
-            generalObj["serialNumber"] = general->getSerialNumber();
-            generalObj["originalPlayer"] = QString(general->getPlayer());
-            generalObj["number"] = general->getNumber();
-            generalObj["row"] = general->getPosition().row;
-            generalObj["col"] = general->getPosition().col;
-            generalObj["territory"] = general->getTerritoryName();
-            generalObj["movesRemaining"] = general->getMovesRemaining();
-            generalObj["onGalley"] = general->getOnGalley();
-            capturedGeneralsArray.append(generalObj);
+            SavedPiece piece = savedPiece(general);
+            piece.number = general->getNumber();
+            piece.originalPlayer = general->getPlayer().toLatin1();
+            saved.capturedGenerals.push_back(piece);
         }
-        playerObj["capturedGenerals"] = capturedGeneralsArray;
-
-        // Save Infantry
-        QJsonArray infantryArray;
         for (InfantryPiece *infantry : player->getInfantry()) {
-            QJsonObject infantryObj;
-            infantryObj["serialNumber"] = infantry->getSerialNumber();
-            infantryObj["row"] = infantry->getPosition().row;
-            infantryObj["col"] = infantry->getPosition().col;
-            infantryObj["territory"] = infantry->getTerritoryName();
-            infantryObj["movesRemaining"] = infantry->getMovesRemaining();
-            infantryObj["onGalley"] = infantry->getOnGalley();
-            infantryArray.append(infantryObj);
+            saved.infantry.push_back(savedPiece(infantry));
         }
-        playerObj["infantry"] = infantryArray;
-
-        // Save Cavalry
-        QJsonArray cavalryArray;
         for (CavalryPiece *cavalry : player->getCavalry()) {
-            QJsonObject cavalryObj;
-            cavalryObj["serialNumber"] = cavalry->getSerialNumber();
-            cavalryObj["row"] = cavalry->getPosition().row;
-            cavalryObj["col"] = cavalry->getPosition().col;
-            cavalryObj["territory"] = cavalry->getTerritoryName();
-            cavalryObj["movesRemaining"] = cavalry->getMovesRemaining();
-            cavalryObj["onGalley"] = cavalry->getOnGalley();
-            cavalryArray.append(cavalryObj);
+            saved.cavalry.push_back(savedPiece(cavalry));
         }
-        playerObj["cavalry"] = cavalryArray;
-
-        // Save Catapults
-        QJsonArray catapultsArray;
         for (CatapultPiece *catapult : player->getCatapults()) {
-            QJsonObject catapultObj;
-            catapultObj["serialNumber"] = catapult->getSerialNumber();
-            catapultObj["row"] = catapult->getPosition().row;
-            catapultObj["col"] = catapult->getPosition().col;
-            catapultObj["territory"] = catapult->getTerritoryName();
-            catapultObj["movesRemaining"] = catapult->getMovesRemaining();
-            catapultObj["onGalley"] = catapult->getOnGalley();
-            catapultsArray.append(catapultObj);
+            saved.catapults.push_back(savedPiece(catapult));
         }
-        playerObj["catapults"] = catapultsArray;
-
-        // Save Galleys
-        QJsonArray galleysArray;
         for (GalleyPiece *galley : player->getGalleys()) {
-            QJsonObject galleyObj;
-            galleyObj["serialNumber"] = galley->getSerialNumber();
-            galleyObj["row"] = galley->getPosition().row;
-            galleyObj["col"] = galley->getPosition().col;
-            galleyObj["territory"] = galley->getTerritoryName();
-            galleyObj["movesRemaining"] = galley->getMovesRemaining();
-
-            // Save legion
-            QJsonArray legionArray;
-            for (int pieceId : galley->getLegion()) {
-                legionArray.append(pieceId);
-            }
-            galleyObj["legion"] = legionArray;
-
-            // Save last territory
-            if (galley->hasLastTerritory()) {
-                galleyObj["lastTerritoryRow"] = galley->getLastTerritory().row;
-                galleyObj["lastTerritoryCol"] = galley->getLastTerritory().col;
-            }
-
-            galleysArray.append(galleyObj);
+            saved.galleys.push_back(savedLeader(galley));
         }
-        playerObj["galleys"] = galleysArray;
 
-        // Save Cities
-        QJsonArray citiesArray;
         for (City *city : player->getCities()) {
-            QJsonObject cityObj;
-            cityObj["row"] = city->getPosition().row;
-            cityObj["col"] = city->getPosition().col;
-            cityObj["territory"] = city->getTerritoryName();
-            cityObj["isFortified"] = city->isFortified();
-            citiesArray.append(cityObj);
+            SavedCity savedCity;
+            savedCity.row = city->getPosition().row;
+            savedCity.col = city->getPosition().col;
+            savedCity.territory = city->getTerritoryName().toStdString();
+            savedCity.fortified = city->isFortified();
+            saved.cities.push_back(savedCity);
         }
-        playerObj["cities"] = citiesArray;
 
-        // Save Roads
-        QJsonArray roadsArray;
         for (Road *road : player->getRoads()) {
-            QJsonObject roadObj;
-            roadObj["fromRow"] = road->getFromPosition().row;
-            roadObj["fromCol"] = road->getFromPosition().col;
-            roadObj["toRow"] = road->getToPosition().row;
-            roadObj["toCol"] = road->getToPosition().col;
-            roadsArray.append(roadObj);
+            SavedRoad savedRoad;
+            savedRoad.fromRow = road->getFromPosition().row;
+            savedRoad.fromCol = road->getFromPosition().col;
+            savedRoad.toRow = road->getToPosition().row;
+            savedRoad.toCol = road->getToPosition().col;
+            saved.roads.push_back(savedRoad);
         }
-        playerObj["roads"] = roadsArray;
 
-        playersArray.append(playerObj);
+        save.players.push_back(saved);
     }
-    gameState["players"] = playersArray;
 
-    // Write to file
-    QJsonDocument doc(gameState);
-    QFile file(fileName);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        file.close();
-        QMessageBox::information(this, "Game Saved",
-                               QString("Game saved successfully to:\n%1").arg(fileName));
-    } else {
-        QMessageBox::critical(this, "Save Failed",
-                            QString("Failed to save game to:\n%1").arg(fileName));
-    }
+    return save;
 }
 
 void MapWidget::loadGame()
@@ -1552,7 +1625,7 @@ void MapWidget::loadGame()
     QString fileName = QFileDialog::getOpenFileName(this,
                                                     "Load Game",
                                                     lastDir,
-                                                    "JSON Files (*.json)");
+                                                    "Saved Games (*.ctes *.json);;Binary Saves (*.ctes);;JSON Files (*.json)");
 
     if (fileName.isEmpty()) {
         return;
@@ -1562,20 +1635,17 @@ void MapWidget::loadGame()
     QFileInfo fileInfo(fileName);
     settings.setValue("lastSaveDirectory", fileInfo.absolutePath());
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly)) {
+    SaveGame save;
+    if (!SaveGameJson::readFile(fileName, save)) {
         QMessageBox::critical(this, "Load Failed",
-                            QString("Failed to open file:\n%1").arg(fileName));
+                            QString("Failed to read save file:\n%1").arg(fileName));
         return;
     }
 
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull() || !doc.isObject()) {
+    std::string error;
+    if (!save.validate(&error)) {
         QMessageBox::critical(this, "Load Failed",
-                            "Invalid save file format.");
+                            QString("Invalid save file:\n%1").arg(QString::fromStdString(error)));
         return;
     }
 
@@ -1623,9 +1693,28 @@ void MapWidget::setTerritoryAt(int row, int col, const QString &name, int value,
         return;
     }
 
+    // Keep the interned name and value bucket for this tile in step
+    int tile = tileIndex(row, col);
+    TerritoryNames::registerName(tile, name);
+    bool valueChanged = m_territories[row][col].value != value;
+    m_tilesByValue[m_territories[row][col].value].reset(tile);
+    m_tilesByValue[value].set(tile);
+    m_tileValues[tile] = value;
+
     m_territories[row][col].name = name;
     m_territories[row][col].value = value;
+    bool terrainChanged = (m_tiles[row][col] == TileType::Land) != isLand;
     m_tiles[row][col] = isLand ? TileType::Land : TileType::Sea;
+
+    // Movement tables only depend on the land/sea layout
+    if (terrainChanged) {
+        rebuildReachability();
+    }
+
+    // Owned territories may now be worth something else
+    if (valueChanged && !m_players.isEmpty()) {
+        m_scoreLedger->rebuild();
+    }
 }
 
 void MapWidget::removeCityAt(int row, int col)
@@ -1661,6 +1750,30 @@ void MapWidget::clearMap()
             m_hasFortification[row][col] = false;
         }
     }
+
+    TerritoryNames::clear();
+    m_tilesByValue.clear();
+    m_tileValues.fill(0);
+    rebuildReachability();
+}
+
+void MapWidget::restoreMap(const SaveGame &save)
+{
+    for (int row = 0; row < ROWS; ++row) {
+        for (int col = 0; col < COLUMNS; ++col) {
+            const SavedTerritory &territory = save.territories[tileIndex(row, col)];
+            m_territories[row][col].name = QString::fromStdString(territory.name);
+            m_territories[row][col].value = territory.value;
+            m_tiles[row][col] = territory.isLand ? TileType::Land : TileType::Sea;
+            m_ownership[row][col] = '\0';
+            m_hasCity[row][col] = false;
+            m_hasFortification[row][col] = false;
+        }
+    }
+
+    // Index and movement tables are rebuilt once rather than per tile
+    rebuildTerritoryIndex();
+    rebuildReachability();
 }
 
 void MapWidget::updateScores(const QMap<QChar, int> &scores)
@@ -1669,7 +1782,7 @@ void MapWidget::updateScores(const QMap<QChar, int> &scores)
     update();  // Trigger repaint to show updated scores
 }
 
-QList<Position> MapWidget::getTerritoriesConnectedByRoad(const Position &startPos, QChar playerId)
+QList<Position> MapWidget::getTerritoriesConnectedByRoad(const Position &startPos, QChar playerId) const
 {
     QList<Position> connectedTerritories;
 
@@ -1682,125 +1795,65 @@ QList<Position> MapWidget::getTerritoriesConnectedByRoad(const Position &startPo
         }
     }
 
-    if (!player) {
+    TerritoryId start = territoryIdAt(startPos);
+    if (!player || start == NO_TERRITORY) {
         return connectedTerritories;
     }
 
-    // Use breadth-first search to find all territories connected by roads
-    QList<Position> toVisit;
-    QSet<QString> visited;  // Use position string as key (row,col)
-
-    toVisit.append(startPos);
-    visited.insert(QString("%1,%2").arg(startPos.row).arg(startPos.col));
-
-    while (!toVisit.isEmpty()) {
-        Position current = toVisit.takeFirst();
-
-        // Look through all roads for this player
-        for (Road *road : player->getRoads()) {
-            ::Position from = road->getFromPosition();  // Road uses global Position
-            ::Position to = road->getToPosition();
-
-            Position next;
-            bool foundNext = false;
-
-            // Check if current position matches one end of the road
-            if (from.row == current.row && from.col == current.col) {
-                next.row = to.row;
-                next.col = to.col;
-                foundNext = true;
-            } else if (to.row == current.row && to.col == current.col) {
-                next.row = from.row;
-                next.col = from.col;
-                foundNext = true;
-            }
-
-            if (foundNext) {
-                QString nextKey = QString("%1,%2").arg(next.row).arg(next.col);
-                if (!visited.contains(nextKey)) {
-                    visited.insert(nextKey);
-                    toVisit.append(next);
-                    connectedTerritories.append(next);
-                }
-            }
-        }
-    }
+    // Everything in the start tile's road component, except the start itself
+    TileMask connected = player->getRoadNetwork().connectedTiles(start);
+    connected.reset(start);
+    connected.forEach([&connectedTerritories](int tile) {
+        connectedTerritories.append(territoryPosition(tile));
+    });
 
     return connectedTerritories;
 }
 
 void MapWidget::updateRoads()
 {
-    if (m_players.isEmpty()) {
-        return;
-    }
-
-    // For each player, check all their cities and create roads to adjacent cities
+    // Full resync; normally roads follow the city and ownership events one tile at a time
     for (Player *player : m_players) {
-        QList<City*> cities = player->getCities();
-
-        // Check each pair of cities to see if they're adjacent
-        for (int i = 0; i < cities.size(); ++i) {
-            City *city1 = cities[i];
-            ::Position pos1 = city1->getPosition();  // City uses global Position
-            QString territory1 = city1->getTerritoryName();
-
-            for (int j = i + 1; j < cities.size(); ++j) {
-                City *city2 = cities[j];
-                ::Position pos2 = city2->getPosition();  // City uses global Position
-                QString territory2 = city2->getTerritoryName();
-
-                // Check if territories are different (roads connect different territories)
-                if (territory1 == territory2) {
-                    continue;
-                }
-
-                // Check if positions are adjacent (horizontally or vertically, not diagonally)
-                bool isAdjacent = false;
-                if ((qAbs(pos1.row - pos2.row) == 1 && pos1.col == pos2.col) ||  // Vertical
-                    (qAbs(pos1.col - pos2.col) == 1 && pos1.row == pos2.row)) {  // Horizontal
-                    isAdjacent = true;
-                }
+        player->getCityTiles().forEach([this, player](int tile) {
+            addRoadsAround(player, tile);
+        });
+    }
 
-                if (!isAdjacent) {
-                    continue;
-                }
+    update();  // Redraw map to show roads
+}
 
-                // Check if both territories are owned by this player
-                if (!player->ownsTerritory(territory1) || !player->ownsTerritory(territory2)) {
-                    continue;
-                }
+void MapWidget::addRoadsAround(Player *player, TerritoryId territory)
+{
+    // The rule is RulesEngine's, so what the replay verifier re-executes is what builds roads here too
+    TileMask joins = RulesEngine::roadNeighbours(m_landTiles, player->getOwnedTerritoryMask(),
+                                                 player->getCityTiles(), territory);
+    joins.forEach([player, territory](int neighbour) {
+        if (player->getRoadNetwork().hasRoad(territory, neighbour)) {
+            return;
+        }
 
-                // Check if either position is a sea territory - roads can't be built in sea
-                if (isSeaTerritory(pos1.row, pos1.col) || isSeaTerritory(pos2.row, pos2.col)) {
-                    continue;
-                }
+        // Roads run from the upper/left tile to the lower/right one
+        TerritoryId from = qMin(territory, neighbour);
+        TerritoryId to = qMax(territory, neighbour);
+        Road *road = new Road(player->getId(), territoryPosition(from), TerritoryNames::nameOf(from), player);
+        road->setToPosition(territoryPosition(to));
+        player->addRoad(road);
+    });
+}
 
-                // Check if road already exists between these two positions
-                bool roadExists = false;
-                for (Road *road : player->getRoads()) {
-                    ::Position from = road->getFromPosition();  // Road uses global Position
-                    ::Position to = road->getToPosition();
-
-                    // Check both directions
-                    if ((from.row == pos1.row && from.col == pos1.col &&
-                         to.row == pos2.row && to.col == pos2.col) ||
-                        (from.row == pos2.row && from.col == pos2.col &&
-                         to.row == pos1.row && to.col == pos1.col)) {
-                        roadExists = true;
-                        break;
-                    }
-                }
+void MapWidget::removeRoadsAround(Player *player, TerritoryId territory)
+{
+    // Roads need a city at both ends; keep them if another city still stands here
+    if (territory == NO_TERRITORY || player->hasCityAt(territory)) {
+        return;
+    }
 
-                if (!roadExists) {
-                    // Create a new road
-                    Road *road = new Road(player->getId(), pos1, territory1, player);
-                    road->setToPosition(pos2);
-                    player->addRoad(road);
-                }
-            }
+    ::Position pos = territoryPosition(territory);
+    QList<Road*> roads = player->getRoads();
+    for (Road *road : roads) {
+        if (road->getFromPosition() == pos || road->getToPosition() == pos) {
+            player->removeRoad(road);
+            delete road;
         }
     }
-
-    update();  // Redraw map to show roads
 }
@@ -5,10 +5,18 @@
 #include <QVector>
 #include <QMap>
 #include <QMenuBar>
+#include <QMenu>
+#include <QAction>
 #include "common.h"
+#include "gamestate.h"
+#include "gamereplay.h"
+#include "reachability.h"
 
 // Forward declarations
 class Player;
+class ScoreLedger;
+class SaveWriter;
+struct SaveGame;
 
 class MapWidget : public QWidget
 {
@@ -44,7 +52,7 @@ public:
         int movesRemaining;  // 0-2
     };
 
-    QMap<QChar, int> calculateScores() const;
+    QMap<QChar, int> calculateScores() const;  // From the score ledger
 
     // Get territory name at position
     QString getTerritoryNameAt(int row, int col) const;
@@ -55,15 +63,35 @@ public:
     // Get territory tax value at position
     int getTerritoryValueAt(int row, int col) const;
 
+    // Name lookups through the interned TerritoryId table ({-1, -1} / 0 if the name is not on the map)
+    bool hasTerritory(const QString &name) const { return TerritoryNames::idOf(name) != NO_TERRITORY; }
+    Position getTerritoryPosition(const QString &name) const;
+    int getTerritoryValue(TerritoryId territory) const;
+    int getTerritoryValue(const QString &name) const { return getTerritoryValue(TerritoryNames::idOf(name)); }
+    int getTerritoryValue(const TileMask &territories) const;  // Total tax value of a set of territories
+    const std::array<int, BOARD_TILES>& getTileValues() const { return m_tileValues; }  // Tax value of every tile
+
     // Check if a tile is sea
     bool isSeaTerritory(int row, int col) const;
 
+    // Terrain, names and tax values as a rules-engine MapState
+    MapState getMapState() const;
+
+    // Precomputed land/galley reach per tile, rebuilt whenever the terrain changes
+    const ReachabilityTable& getReachability() const { return m_reachability; }
+
     // Get adjacent sea territories for a given position
     QList<Position> getAdjacentSeaTerritories(const Position &pos) const;
 
     // Check if there are enemy pieces at position
     bool hasEnemyPiecesAt(int row, int col, QChar currentPlayer) const;
 
+    // Tiles holding pieces of more than one player (bitwise over each player's occupancy)
+    TileMask getDisputedTiles() const;
+
+    // Tiles where the given player's pieces share a tile with enemy pieces
+    TileMask getCombatTiles(QChar player) const;
+
     // Get player color
     QColor getPlayerColor(QChar player) const;
 
@@ -75,7 +103,16 @@ public:
     QVector<HomeProvinceInfo> getRandomHomeProvinces();
 
     // Set player list for querying pieces and ownership
-    void setPlayers(const QList<Player*> &players) { m_players = players; }
+    void setPlayers(const QList<Player*> &players);
+
+    // Running per-player score/tax income, updated as ownership and cities change
+    ScoreLedger* getScoreLedger() const { return m_scoreLedger; }
+
+    // Zobrist hash of the whole position (equals Zobrist::hash of a GameStateBridge capture)
+    uint64_t getGameHash() const;
+
+    // Debug builds: check getGameHash() against a full hash of state, a capture of this map
+    void verifyGameHash(const GameState &state) const;
 
     // Set current player turn index
     void setCurrentPlayerIndex(int index) { m_currentPlayerIndex = index; }
@@ -84,6 +121,7 @@ public:
     // Set territory data (for loading saved games)
     void setTerritoryAt(int row, int col, const QString &name, int value, bool isLand);
     void clearMap();  // Clear existing map before loading
+    void restoreMap(const SaveGame &save);  // Replace every tile with the saved map in one pass
 
     // Remove city and fortification at specific position
     void removeCityAt(int row, int col);
@@ -92,16 +130,24 @@ public:
     // Update scores display
     void updateScores(const QMap<QChar, int> &scores);
 
-    // Check and create roads between adjacent cities owned by the same player
+    // Create any missing roads between adjacent cities owned by the same player (full resync;
+    // setPlayers also hooks city and ownership events so roads update one tile at a time)
     void updateRoads();
 
     // Get all territories reachable via roads from a starting position for a player
-    QList<Position> getTerritoriesConnectedByRoad(const Position &startPos, QChar playerId);
+    QList<Position> getTerritoriesConnectedByRoad(const Position &startPos, QChar playerId) const;
 
     // Check if we're at the start of a turn (no moves made yet)
     bool isAtStartOfTurn() const { return m_isAtStartOfTurn; }
     void setAtStartOfTurn(bool atStart) { m_isAtStartOfTurn = atStart; }
 
+    // Enable the Edit menu's Undo/Redo and name the action each would take back or replay
+    void setUndoRedoState(bool canUndo, const QString &undoLabel, bool canRedo, const QString &redoLabel);
+
+    // Replay viewer: the map only shows the replay's positions, stepped from the Replay menu
+    void startReplay(const GameReplay &replay);
+    bool isReplaying() const { return m_replayStep >= 0; }
+
 public slots:
     void saveGame();
     void loadGame();
@@ -112,6 +158,9 @@ signals:
     void taxesCollected(QChar player, int amount);
     void purchasePhaseNeeded(QChar player, int availableMoney, int inflationMultiplier);
     void itemPlaced(QString itemType);  // Notify placement dialog that an item was placed
+    void undoRequested();
+    void redoRequested();
+    void saveReplayRequested();
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -130,20 +179,39 @@ protected:
 
 private:
     void initializeMap();
+    void rebuildTerritoryIndex();
+    void rebuildReachability();
+    void addRoadsAround(Player *player, TerritoryId territory);
+    void removeRoadsAround(Player *player, TerritoryId territory);
     void placeCaesars();
-    void assignTerritoryNames();
     bool isInsidePiece(const QPoint &pos, const Position &piecePos, int radius) const;
     bool isValidMove(const Position &from, const Position &to) const;
     Piece* getPieceAt(const QPoint &pos, QChar player);
     QVector<Piece*> getPiecesAtPosition(const Position &pos, QChar player);
     void createMenuBar();
+    SaveGame captureSaveGame() const;  // Everything saveGame() writes, in either format
+    void saveFinished(bool ok, const QString &error);
+    void finishSave();  // Wait for a running save and report it (before the app exits)
+    void showReplayStep(int step);
+    void goToReplayTurn();
 
     QMenuBar *m_menuBar;
+    QAction *m_undoAction;
+    QAction *m_redoAction;
     QVector<QVector<TileType>> m_tiles;
     QMap<QChar, QVector<Piece>> m_playerPieces;  // Maps 'A'-'F' to their 6 pieces (1 caesar + 5 generals) - DEPRECATED, use m_players
     QVector<QVector<TerritoryInfo>> m_territories;  // Territory info for each tile
+    QMap<int, TileMask> m_tilesByValue;  // Tax value -> tiles with that value, for mask-based tax totals
+    std::array<int, BOARD_TILES> m_tileValues;  // Tax value per tile, for RulesEngine's income formula
+    ReachabilityTable m_reachability;  // Movement tables for the current terrain
+    TileMask m_landTiles;  // Land tiles of the current terrain, for the road rule
     QVector<QVector<QChar>> m_ownership;  // Which player owns each square ('\0' if none) - DEPRECATED, query m_players
     QList<Player*> m_players;  // Reference to player objects for querying pieces and ownership
+    ScoreLedger *m_scoreLedger;  // Incremental scores for m_players
+    SaveWriter *m_saveWriter;  // Save being written in the background, null when idle
+    GameReplay m_replay;  // Replay being viewed
+    int m_replayStep;  // Position shown from m_replay, -1 when playing a game
+    QMenu *m_replayMenu;
     int m_tileWidth;
     int m_tileHeight;
     int m_currentPlayerIndex;  // Index of current player in m_players list
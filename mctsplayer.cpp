@@ -0,0 +1,491 @@
+#include "mctsplayer.h"
+#include "fastrng.h"
+#include "gamerandom.h"
+#include "threadpool.h"
+#include "transpositiontable.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <memory>
+
+// A Move with pieceId 0 stands for "end the movement phase" (no piece has id 0)
+static bool isEndMovement(const Move &move)
+{
+    return move.pieceId == 0;
+}
+
+static bool sameMove(const Move &a, const Move &b)
+{
+    return a.kind == b.kind && a.pieceId == b.pieceId && a.fromTile == b.fromTile && a.toTile == b.toTile &&
+           a.galleyId == b.galleyId;
+}
+
+// Transposition key of a tree node: the position, whether movement has ended, the
+// moves the player has left (so a long way round doesn't share a short cut's statistics)
+// and how many pieces are aboard galleys (boarding moves nothing the Zobrist key sees)
+static uint64_t searchKey(const GameState &state, int player, bool ended)
+{
+    uint64_t movesLeft = 0;
+    uint64_t aboard = 0;
+    for (const PieceState &piece : *state.players[player].pieces) {
+        movesLeft += static_cast<uint64_t>(std::max(piece.movesRemaining, 0));
+        aboard += piece.galleyId != 0 ? 1 : 0;
+    }
+    return Zobrist::hash(state) + (ended ? Zobrist::endMovement() : 0) + movesLeft * 0x9E3779B97F4A7C15ULL +
+           aboard * 0xC2B2AE3D27D4EB4FULL;
+}
+
+// Table entries pack a visit count (low 24 bits) and a reward sum in 1/65536ths (high 40 bits)
+static constexpr int TABLE_VISIT_BITS = 24;
+static constexpr double TABLE_REWARD_SCALE = 65536.0;
+
+static void tableStats(uint64_t data, int64_t &visits, double &reward)
+{
+    visits = static_cast<int64_t>(data & ((1ULL << TABLE_VISIT_BITS) - 1));
+    reward = static_cast<double>(data >> TABLE_VISIT_BITS) / TABLE_REWARD_SCALE;
+}
+
+static uint64_t tableData(int64_t visits, double reward)
+{
+    return (static_cast<uint64_t>(reward * TABLE_REWARD_SCALE + 0.5) << TABLE_VISIT_BITS) |
+           static_cast<uint64_t>(visits);
+}
+
+// Per-thread scratch for move generation (MoveList is too big for the stack of every caller)
+struct MctsScratch {
+    MoveGenerator generator;
+    MoveList moves;
+    std::vector<Move> candidates;
+};
+
+static void legalMoves(const GameState &state, int player, bool galleys, MctsScratch &scratch)
+{
+    scratch.generator.generate(state, player, scratch.moves);
+    scratch.candidates.clear();
+    for (const Move &move : scratch.moves) {
+        if (galleys || (move.kind != Move::Kind::Galley && move.kind != Move::Kind::Embark)) {
+            scratch.candidates.push_back(move);
+        }
+    }
+}
+
+// Rollout policy: random moves, stopping early a quarter of the time
+static void playRandomMovement(GameState &state, int player, int movesLeft, bool galleys,
+                               MctsScratch &scratch, Xoshiro256 &random)
+{
+    for (int i = 0; i < movesLeft; ++i) {
+        legalMoves(state, player, galleys, scratch);
+        if (scratch.candidates.empty() || random.bounded(4) == 0) {
+            return;
+        }
+        const Move &move = scratch.candidates[random.bounded(static_cast<uint32_t>(scratch.candidates.size()))];
+        MoveGenerator::apply(state, player, move);
+    }
+}
+
+// Combats, purchases and taxes after the movement phase, then hand over the turn
+static void finishTurn(GameState &state, int player, Xoshiro256 &random)
+{
+    RulesEngine::resolveAllCombats(state, player, random);
+    if (!state.players[player].eliminated) {
+        RulesEngine::purchase(state, player, MctsPlayer::choosePurchase(state, player));
+    }
+    RulesEngine::endTurn(state);
+}
+
+// ========== Construction ==========
+
+MctsPlayer::MctsPlayer(const Settings &settings)
+    : m_settings(settings)
+    , m_pool(ThreadPool::shared())
+{
+    if (m_settings.tableMb > 0) {
+        m_table.reset(new TranspositionTable(static_cast<size_t>(m_settings.tableMb)));
+    }
+}
+
+MctsPlayer::MctsPlayer(const Settings &settings, ThreadPool &pool)
+    : m_settings(settings)
+    , m_pool(pool)
+{
+    if (m_settings.tableMb > 0) {
+        m_table.reset(new TranspositionTable(static_cast<size_t>(m_settings.tableMb)));
+    }
+}
+
+MctsPlayer::~MctsPlayer() = default;
+
+// ========== Planning ==========
+
+MctsPlayer::TurnPlan MctsPlayer::planMovement(const GameState &state, int player)
+{
+    TurnPlan plan;
+    GameState current = state;
+    plan.legions = formLegions(current, player);
+    if (m_table) {
+        m_table->clear();
+    }
+
+    uint64_t seed = m_settings.seed != 0 ? m_settings.seed : GameRandom::freshSeed();
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(m_settings.timeBudgetMs);
+    int64_t iterationsLeft = m_settings.iterations;
+    MctsScratch scratch;
+
+    for (int step = 0; step < m_settings.maxMovesPerTurn; ++step) {
+        legalMoves(current, player, m_settings.galleys, scratch);
+        if (scratch.candidates.empty()) {
+            break;
+        }
+
+        // Root actions: every legal move, then ending the movement phase
+        std::vector<Move> rootMoves = scratch.candidates;
+        rootMoves.push_back(Move());
+
+        // Share the remaining budget between the pieces that can still move (plus the final decision)
+        int movablePieces = 1;
+        int lastPiece = 0;
+        for (const Move &move : scratch.candidates) {
+            if (move.pieceId != lastPiece) {
+                lastPiece = move.pieceId;
+                ++movablePieces;
+            }
+        }
+        Clock::time_point now = Clock::now();
+        Clock::time_point sliceDeadline = now >= deadline ? now : now + (deadline - now) / movablePieces;
+        int64_t sliceIterations = m_settings.iterations > 0 ? std::max<int64_t>(1, iterationsLeft / movablePieces) : 0;
+
+        SearchResult result = search(current, player, rootMoves, sliceDeadline, sliceIterations,
+                                     seed + static_cast<uint64_t>(step));
+        plan.iterations += result.iterations;
+        iterationsLeft -= result.iterations;
+
+        int best = static_cast<int>(rootMoves.size()) - 1;
+        for (int i = 0; i < static_cast<int>(rootMoves.size()); ++i) {
+            if (result.visits[i] > result.visits[best]) {
+                best = i;
+            }
+        }
+        if (isEndMovement(rootMoves[best])) {
+            break;
+        }
+
+        MoveGenerator::apply(current, player, rootMoves[best]);
+        plan.moves.push_back(rootMoves[best]);
+    }
+
+    return plan;
+}
+
+MctsPlayer::SearchResult MctsPlayer::search(const GameState &root, int player, const std::vector<Move> &rootMoves,
+                                            Clock::time_point deadline, int64_t iterations, uint64_t seed) const
+{
+    int trees = m_settings.threads > 0 ? m_settings.threads : m_pool.threadCount();
+    int64_t treeIterations = iterations > 0 ? std::max<int64_t>(1, iterations / trees) : 0;
+    const Settings &settings = m_settings;
+    TranspositionTable *table = m_table.get();
+
+    // Root parallelisation: independent trees, merged by visit count
+    std::vector<std::future<SearchResult>> futures;
+    for (int tree = 0; tree < trees; ++tree) {
+        futures.push_back(m_pool.submit([&root, &rootMoves, &settings, table, player, deadline, treeIterations, seed, tree]() {
+            struct Node {
+                int parent = -1;
+                int rootAction = -1;       // Index into rootMoves for the root's children
+                int depth = 0;             // Moves made since the root
+                Move move;
+                bool expanded = false;
+                std::vector<Move> untried;
+                std::vector<int> children;
+                int64_t visits = 0;
+                double reward = 0.0;
+                uint64_t key = 0;          // Transposition key (with a table only)
+            };
+
+            Xoshiro256 random(seed);
+            for (int i = 0; i < tree; ++i) {
+                random.jump();
+            }
+            auto scratch = std::make_unique<MctsScratch>();
+
+            std::vector<Node> nodes(1);
+            nodes[0].expanded = true;
+            nodes[0].untried = rootMoves;
+
+            SearchResult result;
+            result.visits.assign(rootMoves.size(), 0);
+
+            do {
+                GameState state = root;
+                int current = 0;
+
+                // Selection and expansion
+                while (!isEndMovement(nodes[current].move) || current == 0) {
+                    if (!nodes[current].expanded) {
+                        nodes[current].expanded = true;
+                        if (nodes[current].depth < settings.maxMovesPerTurn) {
+                            legalMoves(state, player, settings.galleys, *scratch);
+                            nodes[current].untried = scratch->candidates;
+                        }
+                        nodes[current].untried.push_back(Move());
+                    }
+
+                    if (!nodes[current].untried.empty()) {
+                        std::vector<Move> &untried = nodes[current].untried;
+                        int pick = static_cast<int>(random.bounded(static_cast<uint32_t>(untried.size())));
+                        Node child;
+                        child.parent = current;
+                        child.depth = nodes[current].depth + 1;
+                        child.move = untried[pick];
+                        if (current == 0) {
+                            child.rootAction = static_cast<int>(std::find_if(rootMoves.begin(), rootMoves.end(),
+                                [&](const Move &move) { return sameMove(move, child.move); }) - rootMoves.begin());
+                        }
+                        untried[pick] = untried.back();
+                        untried.pop_back();
+
+                        if (!isEndMovement(child.move)) {
+                            MoveGenerator::apply(state, player, child.move);
+                        }
+                        if (table) {
+                            child.key = searchKey(state, player, isEndMovement(child.move));
+                        }
+                        nodes.push_back(std::move(child));
+                        int index = static_cast<int>(nodes.size()) - 1;
+                        nodes[current].children.push_back(index);
+                        current = index;
+                        break;
+                    }
+
+                    // UCT over the fully expanded children, preferring the pooled statistics when richer
+                    double logVisits = std::log(static_cast<double>(nodes[current].visits));
+                    int best = -1;
+                    double bestScore = -1.0;
+                    for (int child : nodes[current].children) {
+                        const Node &node = nodes[child];
+                        int64_t visits = node.visits;
+                        double reward = node.reward;
+                        uint64_t data;
+                        if (table && table->probe(node.key, data)) {
+                            int64_t pooledVisits;
+                            double pooledReward;
+                            tableStats(data, pooledVisits, pooledReward);
+                            if (pooledVisits > visits) {
+                                visits = pooledVisits;
+                                reward = pooledReward;
+                            }
+                        }
+                        double score = reward / visits +
+                                       settings.exploration * std::sqrt(logVisits / visits);
+                        if (score > bestScore) {
+                            bestScore = score;
+                            best = child;
+                        }
+                    }
+                    current = best;
+                    if (!isEndMovement(nodes[current].move)) {
+                        MoveGenerator::apply(state, player, nodes[current].move);
+                    }
+                }
+
+                // Rollout: finish our movement, then let everybody play a few turns
+                if (!isEndMovement(nodes[current].move)) {
+                    playRandomMovement(state, player, settings.maxMovesPerTurn - nodes[current].depth,
+                                       settings.galleys, *scratch, random);
+                }
+                finishTurn(state, player, random);
+                for (int turn = 0; turn < settings.rolloutTurns && RulesEngine::winner(state) == NO_PLAYER; ++turn) {
+                    int mover = state.currentPlayer;
+                    formLegions(state, mover);
+                    playRandomMovement(state, mover, settings.maxMovesPerTurn, settings.galleys, *scratch, random);
+                    finishTurn(state, mover, random);
+                }
+                double reward = evaluate(state, player);
+
+                // Backpropagation
+                for (int node = current; node != -1; node = nodes[node].parent) {
+                    nodes[node].visits++;
+                    nodes[node].reward += reward;
+                    if (table && node != 0) {
+                        uint64_t data;
+                        int64_t visits = 0;
+                        double pooled = 0.0;
+                        if (table->probe(nodes[node].key, data)) {
+                            tableStats(data, visits, pooled);
+                        }
+                        if (visits + 1 < (1LL << TABLE_VISIT_BITS)) {
+                            table->store(nodes[node].key, tableData(visits + 1, pooled + reward));
+                        }
+                    }
+                }
+                result.iterations++;
+            } while (treeIterations > 0 ? result.iterations < treeIterations : Clock::now() < deadline);
+
+            for (int child : nodes[0].children) {
+                result.visits[nodes[child].rootAction] += nodes[child].visits;
+            }
+            return result;
+        }));
+    }
+
+    SearchResult merged;
+    merged.visits.assign(rootMoves.size(), 0);
+    for (std::future<SearchResult> &future : futures) {
+        SearchResult result = future.get();
+        merged.iterations += result.iterations;
+        for (size_t i = 0; i < rootMoves.size(); ++i) {
+            merged.visits[i] += result.visits[i];
+        }
+    }
+    return merged;
+}
+
+// ========== Heuristics ==========
+
+std::vector<std::pair<int, int>> MctsPlayer::formLegions(GameState &state, int player)
+{
+    std::vector<std::pair<int, int>> assigned;
+    const GameState &view = state;   // Read-only until the assignments are made (keeps the pieces shared)
+    const PlayerState &owner = view.players[player];
+
+    // Free leader with the most moves left on each tile
+    std::array<const PieceState *, BOARD_TILES> leaders {};
+    for (const PieceState &piece : *owner.pieces) {
+        if (isLeaderKind(piece.kind) && piece.capturedBy == NO_PLAYER && piece.galleyId == 0 && piece.tile != NO_TILE) {
+            const PieceState *&best = leaders[piece.tile];
+            if (!best || piece.movesRemaining > best->movesRemaining) {
+                best = &piece;
+            }
+        }
+    }
+
+    for (const PieceState &piece : *owner.pieces) {
+        if (!isTroopKind(piece.kind) || piece.galleyId != 0 || piece.tile == NO_TILE || !leaders[piece.tile]) {
+            continue;
+        }
+        if (piece.leaderId != 0) {
+            const PieceState *leader = view.findPiece(piece.leaderId);
+            if (leader && leader->tile == piece.tile && leader->capturedBy == NO_PLAYER) {
+                continue;
+            }
+        }
+        assigned.emplace_back(piece.id, leaders[piece.tile]->id);
+    }
+
+    for (const std::pair<int, int> &assignment : assigned) {
+        RulesEngine::assignToLegion(state, player, assignment.first, assignment.second);
+    }
+    return assigned;
+}
+
+RulesEngine::PurchaseOrder MctsPlayer::choosePurchase(const GameState &state, int player)
+{
+    RulesEngine::PurchaseOrder order;
+    const PlayerState &buyer = state.players[player];
+    int multiplier = state.inflationMultiplier;
+    int infantryPrice = RulesEngine::price(RulesEngine::INFANTRY_BASE_COST, multiplier);
+    int cavalryPrice = RulesEngine::price(RulesEngine::CAVALRY_BASE_COST, multiplier);
+    int catapultPrice = RulesEngine::price(RulesEngine::CATAPULT_BASE_COST, multiplier);
+    int cityPrice = RulesEngine::price(RulesEngine::CITY_BASE_COST, multiplier);
+
+    int infantry = 0;
+    int cavalry = 0;
+    int catapults = 0;
+    for (const PieceState &piece : *buyer.pieces) {
+        infantry += piece.kind == PieceKind::Infantry;
+        cavalry += piece.kind == PieceKind::Cavalry;
+        catapults += piece.kind == PieceKind::Catapult;
+    }
+    int budget = buyer.wallet;
+
+    // With an army in the field, a city on the richest unbuilt territory (next to an own city for a road)
+    if (infantry + cavalry + catapults >= 6 && budget >= cityPrice + 2 * infantryPrice) {
+        int bestTile = NO_TILE;
+        int bestScore = 0;
+        TileMask candidates = buyer.owned & ~buyer.cities;
+        candidates.forEach([&](int tile) {
+            int score = state.map->value[tile];
+            for (int neighbour : RulesEngine::adjacentTiles(tile)) {
+                if (buyer.cities.test(neighbour)) {
+                    score += RulesEngine::CITY_TAX;
+                    break;
+                }
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                bestTile = tile;
+            }
+        });
+        if (bestTile != NO_TILE) {
+            order.cities.push_back(bestTile);
+            budget -= cityPrice;
+        }
+    }
+
+    // The rest on troops: mostly infantry, a cavalry per two infantry, a catapult per six troops
+    int infantryLeft = RulesEngine::TOTAL_INFANTRY_PIECES - state.countInPlay(PieceKind::Infantry);
+    int cavalryLeft = RulesEngine::TOTAL_CAVALRY_PIECES - state.countInPlay(PieceKind::Cavalry);
+    int catapultsLeft = RulesEngine::TOTAL_CATAPULT_PIECES - state.countInPlay(PieceKind::Catapult);
+    while (true) {
+        int troops = infantry + cavalry + catapults;
+        if (catapults * 6 < troops && budget >= catapultPrice && order.catapults < catapultsLeft) {
+            order.catapults++;
+            catapults++;
+            budget -= catapultPrice;
+        } else if (cavalry * 2 < infantry && budget >= cavalryPrice && order.cavalry < cavalryLeft) {
+            order.cavalry++;
+            cavalry++;
+            budget -= cavalryPrice;
+        } else if (budget >= infantryPrice && order.infantry < infantryLeft) {
+            order.infantry++;
+            infantry++;
+            budget -= infantryPrice;
+        } else if (budget >= cavalryPrice && order.cavalry < cavalryLeft) {
+            order.cavalry++;
+            cavalry++;
+            budget -= cavalryPrice;
+        } else {
+            break;
+        }
+    }
+
+    if (!RulesEngine::canPurchase(state, player, order)) {
+        return RulesEngine::PurchaseOrder();
+    }
+    return order;
+}
+
+double MctsPlayer::evaluate(const GameState &state, int player)
+{
+    if (state.players[player].eliminated) {
+        return 0.0;
+    }
+    if (RulesEngine::winner(state) == player) {
+        return 1.0;
+    }
+
+    // Income, savings and army (troops at about half their price)
+    auto strength = [&state](int index) {
+        const PlayerState &owner = state.players[index];
+        double value = RulesEngine::taxIncome(state, index) + owner.wallet / 4.0;
+        for (const PieceState &piece : *owner.pieces) {
+            switch (piece.kind) {
+                case PieceKind::Infantry: value += 5.0; break;
+                case PieceKind::Cavalry: value += 8.0; break;
+                case PieceKind::Catapult: value += 10.0; break;
+                case PieceKind::Galley: value += 4.0; break;
+                default: break;
+            }
+        }
+        return value;
+    };
+
+    double own = strength(player);
+    double strongestRival = 0.0;
+    for (int i = 0; i < state.playerCount(); ++i) {
+        if (i != player && !state.players[i].eliminated) {
+            strongestRival = std::max(strongestRival, strength(i));
+        }
+    }
+    return own + strongestRival > 0.0 ? own / (own + strongestRival) : 0.5;
+}
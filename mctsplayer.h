@@ -0,0 +1,81 @@
+#ifndef MCTSPLAYER_H
+#define MCTSPLAYER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "gamestate.h"
+#include "movegenerator.h"
+#include "rulesengine.h"
+
+class ThreadPool;
+class TranspositionTable;
+
+// Computer player using Monte Carlo Tree Search over a headless GameState.
+// The movement phase is planned one move at a time: each decision gets a
+// slice of the turn's budget (time, or a playout count for reproducible
+// play), during which every pool thread grows
+// its own UCT tree from the same root (root parallelisation) and the visit
+// counts are merged to pick the move. The trees also pool their statistics
+// in a shared transposition table keyed by the Zobrist hash, so move orders
+// reaching the same position are scored together. Rollouts finish the turn
+// with random moves, then play a few turns of every player with the same
+// light policy (random moves, combats, heuristic purchases) and score the
+// position.
+class MctsPlayer
+{
+public:
+    struct Settings {
+        int timeBudgetMs = 2000;     // Whole movement phase
+        int64_t iterations = 0;      // Playouts for the whole phase instead of a time budget; 0 = use time.
+                                     // With a fixed seed and one thread, the plan is then reproducible
+        int threads = 0;             // Trees per decision; 0 = one per pool thread
+        double exploration = 0.7;    // UCT constant (rewards are in [0, 1])
+        int rolloutTurns = 6;        // Player turns simulated after ours
+        int maxMovesPerTurn = 40;    // Safety cap on the planned moves
+        bool galleys = true;         // Consider boarding and sailing galleys
+        uint64_t seed = 0;           // 0 = a fresh seed per plan
+        int tableMb = 8;             // Shared transposition table; 0 = none
+    };
+
+    struct TurnPlan {
+        std::vector<std::pair<int, int>> legions;   // (troop id, leader id) assignments made before moving
+        std::vector<Move> moves;                     // In order
+        int64_t iterations = 0;                      // Playouts run across all threads
+    };
+
+    explicit MctsPlayer(const Settings &settings);
+    MctsPlayer(const Settings &settings, ThreadPool &pool);
+    ~MctsPlayer();
+
+    // Plan the movement phase of player (state.currentPlayer should be player)
+    TurnPlan planMovement(const GameState &state, int player);
+
+    // Put every unled troop under a leader on its tile; returns the assignments made
+    static std::vector<std::pair<int, int>> formLegions(GameState &state, int player);
+
+    // What to buy with the current wallet: cities on rich turns, otherwise an army
+    static RulesEngine::PurchaseOrder choosePurchase(const GameState &state, int player);
+
+    // Position value for player in [0, 1] (1 = won, 0 = eliminated)
+    static double evaluate(const GameState &state, int player);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct SearchResult {
+        std::vector<int64_t> visits;   // Per root action
+        int64_t iterations = 0;
+    };
+
+    SearchResult search(const GameState &root, int player, const std::vector<Move> &rootMoves,
+                        Clock::time_point deadline, int64_t iterations, uint64_t seed) const;
+
+    Settings m_settings;
+    ThreadPool &m_pool;
+    std::unique_ptr<TranspositionTable> m_table;
+};
+
+#endif // MCTSPLAYER_H
@@ -0,0 +1,113 @@
+#include "movegenerator.h"
+
+MoveGenerator::MoveGenerator()
+{
+    m_tables.rebuild(m_tablesLand);
+}
+
+void MoveGenerator::updateTables(const MapState &map)
+{
+    if (map.land != m_tablesLand) {
+        m_tablesLand = map.land;
+        m_tables.rebuild(m_tablesLand);
+    }
+}
+
+void MoveGenerator::generate(const GameState &state, int player, MoveList &moves)
+{
+    moves.clear();
+    if (player < 0 || player >= state.playerCount()) {
+        return;
+    }
+    updateTables(*state.map);
+
+    const PlayerState &owner = state.players[player];
+
+    // Enemy occupancy once for the whole player instead of per destination
+    TileMask enemyTiles;
+    for (int other = 0; other < state.playerCount(); ++other) {
+        if (other != player) {
+            enemyTiles |= state.occupiedTiles(other);
+        }
+    }
+
+    for (const PieceState &leader : *owner.pieces) {
+        if (!isLeaderKind(leader.kind) || leader.capturedBy != NO_PLAYER || leader.galleyId != 0 ||
+            leader.movesRemaining <= 0 || leader.tile == NO_TILE) {
+            continue;
+        }
+
+        // A General/Caesar cannot fight alone: enemy tiles need a legion troop that can still move
+        bool hasEscort = false;
+        for (const PieceState &piece : *owner.pieces) {
+            if (piece.leaderId == leader.id && piece.tile == leader.tile && piece.movesRemaining > 0) {
+                hasEscort = true;
+                break;
+            }
+        }
+        TileMask allowed = hasEscort ? TileMask::all() : ~enemyTiles;
+
+        const TileMask &steps = m_tables.landStep(leader.tile);
+        TileMask stepMoves = steps & allowed;
+        stepMoves.forEach([&moves, &leader](int tile) {
+            moves.append(Move::Kind::LeaderStep, leader.id, leader.tile, tile);
+        });
+
+        // Road moves: step into a land neighbour, then anywhere on its road component
+        TileMask roadReach;
+        steps.forEach([&roadReach, &owner](int step) {
+            roadReach |= owner.roads->connectedTiles(step);
+        });
+        roadReach &= ~steps;
+        roadReach.reset(leader.tile);
+        roadReach &= allowed & m_tables.land();
+        roadReach.forEach([&moves, &leader](int tile) {
+            moves.append(Move::Kind::LeaderRoad, leader.id, leader.tile, tile);
+        });
+
+        // Board any of our galleys on the same tile
+        for (const PieceState &galley : *owner.pieces) {
+            if (galley.kind == PieceKind::Galley && galley.tile == leader.tile) {
+                moves.append(Move::Kind::Embark, leader.id, leader.tile, leader.tile, galley.id);
+            }
+        }
+    }
+
+    for (const PieceState &galley : *owner.pieces) {
+        if (galley.kind != PieceKind::Galley || galley.movesRemaining <= 0 || galley.tile == NO_TILE) {
+            continue;
+        }
+
+        // Landing on enemy pieces needs troops aboard
+        bool carriesTroops = false;
+        for (const PieceState &piece : *owner.pieces) {
+            if (piece.galleyId == galley.id && isTroopKind(piece.kind)) {
+                carriesTroops = true;
+                break;
+            }
+        }
+
+        TileMask destinations = m_tables.seaStep(galley.tile);
+        if (!carriesTroops) {
+            destinations &= ~(enemyTiles & m_tables.land());
+        }
+        destinations.forEach([&moves, &galley](int tile) {
+            moves.append(Move::Kind::Galley, galley.id, galley.tile, tile);
+        });
+    }
+}
+
+bool MoveGenerator::apply(GameState &state, int player, const Move &move)
+{
+    switch (move.kind) {
+        case Move::Kind::LeaderStep:
+            return RulesEngine::moveLeader(state, player, move.pieceId, move.toTile, false);
+        case Move::Kind::LeaderRoad:
+            return RulesEngine::moveLeader(state, player, move.pieceId, move.toTile, true);
+        case Move::Kind::Galley:
+            return RulesEngine::moveGalley(state, player, move.pieceId, move.toTile);
+        case Move::Kind::Embark:
+            return RulesEngine::embarkLegion(state, player, move.pieceId, move.galleyId);
+    }
+    return false;
+}
@@ -0,0 +1,85 @@
+#ifndef MOVEGENERATOR_H
+#define MOVEGENERATOR_H
+
+#include <array>
+#include <cstdint>
+#include "gamestate.h"
+#include "reachability.h"
+#include "rulesengine.h"
+
+// One movement action for the player to move
+struct Move
+{
+    enum class Kind : uint8_t {
+        LeaderStep,   // Leader and legion into an adjacent land territory
+        LeaderRoad,   // Leader and legion one step, then along the player's roads
+        Galley,       // Galley (and anything embarked) one step onto sea, or ashore
+        Embark        // Leader and legion board the galley galleyId on their tile (toTile == fromTile)
+    };
+
+    Kind kind = Kind::LeaderStep;
+    uint8_t fromTile = 0;
+    uint8_t toTile = 0;
+    int32_t pieceId = 0;
+    int32_t galleyId = 0;   // Embark only
+};
+
+// Fixed-capacity move buffer; sized for the worst case so generation never allocates
+class MoveList
+{
+public:
+    // Every leader in the game box reaching every other tile or boarding each of its player's
+    // galleys, plus every galley's four neighbours
+    static constexpr int MAX_LEADERS = MAX_PLAYERS * (1 + RulesEngine::STARTING_GENERALS);
+    static constexpr int CAPACITY = MAX_LEADERS * (BOARD_TILES - 1 + RulesEngine::MAX_GALLEYS_PER_PLAYER) +
+                                    RulesEngine::TOTAL_GALLEY_PIECES * 4;
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    void clear() { m_size = 0; }
+
+    void append(Move::Kind kind, int pieceId, int fromTile, int toTile, int galleyId = 0)
+    {
+        Move &move = m_moves[m_size++];
+        move.kind = kind;
+        move.pieceId = pieceId;
+        move.fromTile = static_cast<uint8_t>(fromTile);
+        move.toTile = static_cast<uint8_t>(toTile);
+        move.galleyId = galleyId;
+    }
+
+    const Move &operator[](int index) const { return m_moves[index]; }
+    const Move *begin() const { return m_moves.data(); }
+    const Move *end() const { return m_moves.data() + m_size; }
+
+private:
+    std::array<Move, CAPACITY> m_moves;
+    int m_size = 0;
+};
+
+// Enumerates every legal movement action of a player: leader moves with
+// their legions, road moves, boarding a galley and galley moves with
+// embarked pieces. The result matches RulesEngine::canMoveLeader /
+// canEmbarkLegion / canMoveGalley; each
+// destination of a piece is listed once (a plain step is preferred over a
+// road move to the same tile). Keep one generator around and reuse it: the
+// reachability tables are only rebuilt when the map's terrain changes.
+class MoveGenerator
+{
+public:
+    MoveGenerator();
+
+    // Replace the contents of moves with the legal moves of player
+    void generate(const GameState &state, int player, MoveList &moves);
+
+    // Play a generated move through the rules engine
+    static bool apply(GameState &state, int player, const Move &move);
+
+private:
+    void updateTables(const MapState &map);
+
+    ReachabilityTable m_tables;
+    TileMask m_tablesLand;
+};
+
+#endif // MOVEGENERATOR_H
@@ -1,41 +1,77 @@
 #include "player.h"
 #include "mapwidget.h"
+#include "scoreledger.h"
+#include "rulesengine.h"
+#include "zobrist.h"
+#include <QDebug>
 
 Player::Player(QChar id, const Position &homeProvince, const QString &homeProvinceName, QObject *parent)
+    : Player(id, homeProvince, homeProvinceName, Setup::StartingForces, parent)
+{
+}
+
+Player::Player(QChar id, const Position &homeProvince, const QString &homeProvinceName, Setup setup, QObject *parent)
     : QObject(parent)
     , m_id(id)
     , m_color(getColorForPlayer(id))
+    , m_piecesByTile(BOARD_TILES)
     , m_wallet(100)  // Start each player with 100 talents
     , m_homeProvince(homeProvince)
     , m_homeProvinceName(homeProvinceName)
     , m_hasHomeFortifiedCity(true)  // Every player starts with a fortified city
     , m_isMyTurn(false)  // Starts as false, first player's turn is set in main()
+    , m_isComputerControlled(false)
+    , m_zobristHash(0)
 {
+    m_zobristHash += Zobrist::wallet(seat(), m_wallet);
+
+    if (setup == Setup::StartingForces) {
+        createStartingForces();
+    }
+}
+
+void Player::createStartingForces()
+{
+    TerritoryId homeTerritory = territoryIdAt(m_homeProvince);
+
     // Create Caesar at home province
     CaesarPiece *caesar = new CaesarPiece(m_id, m_homeProvince, this);
-    caesar->setTerritoryName(m_homeProvinceName);
+    caesar->setTerritoryId(homeTerritory);
     m_caesars.append(caesar);
 
     // Create 6 Generals at home province (per 1984 rules)
     for (int i = 1; i <= 6; ++i) {
         GeneralPiece *general = new GeneralPiece(m_id, m_homeProvince, i, this);
-        general->setTerritoryName(m_homeProvinceName);
+        general->setTerritoryId(homeTerritory);
         m_generals.append(general);
     }
 
     // Create 4 Infantry at home province (per 1984 rules)
     for (int i = 1; i <= 4; ++i) {
         InfantryPiece *infantry = new InfantryPiece(m_id, m_homeProvince, this);
-        infantry->setTerritoryName(m_homeProvinceName);
+        infantry->setTerritoryId(homeTerritory);
         m_infantry.append(infantry);
     }
 
     // Create fortified city at home province
     City *homeCity = new City(m_id, m_homeProvince, m_homeProvinceName, true, this);
     m_cities.append(homeCity);
+    connect(homeCity, &City::fortificationChanged, this, &Player::onCityFortificationChanged);
+    if (homeTerritory != NO_TERRITORY) {
+        m_cityTiles.set(homeTerritory);
+        m_zobristHash += Zobrist::city(seat(), homeTerritory) + Zobrist::fortification(seat(), homeTerritory);
+    }
 
     // Claim the home province territory
-    m_ownedTerritories.append(m_homeProvinceName);
+    if (homeTerritory != NO_TERRITORY) {
+        m_ownedTerritories.set(homeTerritory);
+        m_zobristHash += Zobrist::owner(seat(), homeTerritory);
+    }
+
+    // Index the starting pieces by tile
+    for (GamePiece *piece : getAllPieces()) {
+        indexPiece(piece);
+    }
 
     // Note: m_hasHomeFortifiedCity flag is also set to true for quick checking
 }
@@ -131,6 +167,7 @@ void Player::addCaesar(CaesarPiece *piece)
 {
     if (piece && piece->getPlayer() == m_id) {
         m_caesars.append(piece);
+        indexPiece(piece);
         emit pieceAdded(piece);
     }
 }
@@ -139,6 +176,7 @@ void Player::addGeneral(GeneralPiece *piece)
 {
     if (piece && piece->getPlayer() == m_id) {
         m_generals.append(piece);
+        indexPiece(piece);
         emit pieceAdded(piece);
     }
 }
@@ -156,6 +194,7 @@ void Player::addInfantry(InfantryPiece *piece)
 {
     if (piece && piece->getPlayer() == m_id) {
         m_infantry.append(piece);
+        indexPiece(piece);
         emit pieceAdded(piece);
     }
 }
@@ -164,6 +203,7 @@ void Player::addCavalry(CavalryPiece *piece)
 {
     if (piece && piece->getPlayer() == m_id) {
         m_cavalry.append(piece);
+        indexPiece(piece);
         emit pieceAdded(piece);
     }
 }
@@ -172,6 +212,7 @@ void Player::addCatapult(CatapultPiece *piece)
 {
     if (piece && piece->getPlayer() == m_id) {
         m_catapults.append(piece);
+        indexPiece(piece);
         emit pieceAdded(piece);
     }
 }
@@ -180,6 +221,7 @@ void Player::addGalley(GalleyPiece *piece)
 {
     if (piece && piece->getPlayer() == m_id) {
         m_galleys.append(piece);
+        indexPiece(piece);
         emit pieceAdded(piece);
     }
 }
@@ -190,6 +232,17 @@ void Player::addCity(City *city)
 {
     if (city && city->getOwner() == m_id) {
         m_cities.append(city);
+        connect(city, &City::fortificationChanged, this, &Player::onCityFortificationChanged, Qt::UniqueConnection);
+        TerritoryId territory = territoryIdAt(city->getPosition());
+        if (territory != NO_TERRITORY) {
+            if (!m_cityTiles.test(territory)) {
+                m_zobristHash += Zobrist::city(seat(), territory);
+            }
+            m_cityTiles.set(territory);
+            if (city->isFortified()) {
+                m_zobristHash += Zobrist::fortification(seat(), territory);
+            }
+        }
         emit buildingAdded(city);
     }
 }
@@ -198,6 +251,7 @@ void Player::addRoad(Road *road)
 {
     if (road && road->getOwner() == m_id) {
         m_roads.append(road);
+        m_roadNetwork.addRoad(territoryIdAt(road->getFromPosition()), territoryIdAt(road->getToPosition()));
         emit buildingAdded(road);
     }
 }
@@ -207,6 +261,7 @@ void Player::addRoad(Road *road)
 bool Player::removeCaesar(CaesarPiece *piece)
 {
     if (m_caesars.removeOne(piece)) {
+        unindexPiece(piece);
         emit pieceRemoved(piece);
         return true;
     }
@@ -216,6 +271,7 @@ bool Player::removeCaesar(CaesarPiece *piece)
 bool Player::removeGeneral(GeneralPiece *piece)
 {
     if (m_generals.removeOne(piece)) {
+        unindexPiece(piece);
         emit pieceRemoved(piece);
         return true;
     }
@@ -234,6 +290,7 @@ bool Player::removeCapturedGeneral(GeneralPiece *piece)
 bool Player::removeInfantry(InfantryPiece *piece)
 {
     if (m_infantry.removeOne(piece)) {
+        unindexPiece(piece);
         emit pieceRemoved(piece);
         return true;
     }
@@ -243,6 +300,7 @@ bool Player::removeInfantry(InfantryPiece *piece)
 bool Player::removeCavalry(CavalryPiece *piece)
 {
     if (m_cavalry.removeOne(piece)) {
+        unindexPiece(piece);
         emit pieceRemoved(piece);
         return true;
     }
@@ -252,6 +310,7 @@ bool Player::removeCavalry(CavalryPiece *piece)
 bool Player::removeCatapult(CatapultPiece *piece)
 {
     if (m_catapults.removeOne(piece)) {
+        unindexPiece(piece);
         emit pieceRemoved(piece);
         return true;
     }
@@ -261,6 +320,7 @@ bool Player::removeCatapult(CatapultPiece *piece)
 bool Player::removeGalley(GalleyPiece *piece)
 {
     if (m_galleys.removeOne(piece)) {
+        unindexPiece(piece);
         emit pieceRemoved(piece);
         return true;
     }
@@ -272,6 +332,15 @@ bool Player::removeGalley(GalleyPiece *piece)
 bool Player::removeCity(City *city)
 {
     if (m_cities.removeOne(city)) {
+        disconnect(city, &City::fortificationChanged, this, &Player::onCityFortificationChanged);
+        TerritoryId territory = territoryIdAt(city->getPosition());
+        if (territory != NO_TERRITORY && city->isFortified()) {
+            m_zobristHash -= Zobrist::fortification(seat(), territory);
+        }
+        if (territory != NO_TERRITORY && !getCityAtPosition(city->getPosition())) {
+            m_cityTiles.reset(territory);
+            m_zobristHash -= Zobrist::city(seat(), territory);
+        }
         emit buildingRemoved(city);
         return true;
     }
@@ -281,51 +350,66 @@ bool Player::removeCity(City *city)
 bool Player::removeRoad(Road *road)
 {
     if (m_roads.removeOne(road)) {
+        // Drop the graph edge unless another Road object still covers it
+        Position from = road->getFromPosition();
+        Position to = road->getToPosition();
+        bool stillConnected = false;
+        for (Road *other : m_roads) {
+            if ((other->getFromPosition() == from && other->getToPosition() == to) ||
+                (other->getFromPosition() == to && other->getToPosition() == from)) {
+                stillConnected = true;
+                break;
+            }
+        }
+        if (!stillConnected) {
+            m_roadNetwork.removeRoad(territoryIdAt(from), territoryIdAt(to));
+        }
+
         emit buildingRemoved(road);
         return true;
     }
     return false;
 }
 
-// ========== Query Pieces by Territory Name ==========
+// ========== Query Pieces by Territory ==========
 
-QList<GamePiece*> Player::getPiecesAtTerritory(const QString &territoryName) const
+QList<GamePiece*> Player::getPiecesAtTerritory(TerritoryId territory) const
 {
     QList<GamePiece*> pieces;
 
     // Check all piece types
     for (CaesarPiece *piece : m_caesars) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
 
     for (GeneralPiece *piece : m_generals) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
 
     for (InfantryPiece *piece : m_infantry) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
 
     for (CavalryPiece *piece : m_cavalry) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
 
     for (CatapultPiece *piece : m_catapults) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
 
     for (GalleyPiece *piece : m_galleys) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
@@ -333,88 +417,88 @@ QList<GamePiece*> Player::getPiecesAtTerritory(const QString &territoryName) con
     return pieces;
 }
 
-QList<CaesarPiece*> Player::getCaesarsAtTerritory(const QString &territoryName) const
+QList<CaesarPiece*> Player::getCaesarsAtTerritory(TerritoryId territory) const
 {
     QList<CaesarPiece*> pieces;
     for (CaesarPiece *piece : m_caesars) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
     return pieces;
 }
 
-QList<GeneralPiece*> Player::getGeneralsAtTerritory(const QString &territoryName) const
+QList<GeneralPiece*> Player::getGeneralsAtTerritory(TerritoryId territory) const
 {
     QList<GeneralPiece*> pieces;
     for (GeneralPiece *piece : m_generals) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
     return pieces;
 }
 
-QList<InfantryPiece*> Player::getInfantryAtTerritory(const QString &territoryName) const
+QList<InfantryPiece*> Player::getInfantryAtTerritory(TerritoryId territory) const
 {
     QList<InfantryPiece*> pieces;
     for (InfantryPiece *piece : m_infantry) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
     return pieces;
 }
 
-QList<CavalryPiece*> Player::getCavalryAtTerritory(const QString &territoryName) const
+QList<CavalryPiece*> Player::getCavalryAtTerritory(TerritoryId territory) const
 {
     QList<CavalryPiece*> pieces;
     for (CavalryPiece *piece : m_cavalry) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
     return pieces;
 }
 
-QList<CatapultPiece*> Player::getCatapultsAtTerritory(const QString &territoryName) const
+QList<CatapultPiece*> Player::getCatapultsAtTerritory(TerritoryId territory) const
 {
     QList<CatapultPiece*> pieces;
     for (CatapultPiece *piece : m_catapults) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
     return pieces;
 }
 
-QList<GalleyPiece*> Player::getGalleysAtTerritory(const QString &territoryName) const
+QList<GalleyPiece*> Player::getGalleysAtTerritory(TerritoryId territory) const
 {
     QList<GalleyPiece*> pieces;
     for (GalleyPiece *piece : m_galleys) {
-        if (piece->getTerritoryName() == territoryName) {
+        if (piece->getTerritoryId() == territory) {
             pieces.append(piece);
         }
     }
     return pieces;
 }
 
-// ========== Query Buildings by Territory Name ==========
+// ========== Query Buildings by Territory ==========
 
-QList<Building*> Player::getBuildingsAtTerritory(const QString &territoryName) const
+QList<Building*> Player::getBuildingsAtTerritory(TerritoryId territory) const
 {
     QList<Building*> buildings;
 
     // Check cities
     for (City *city : m_cities) {
-        if (city->getTerritoryName() == territoryName) {
+        if (city->getTerritoryId() == territory) {
             buildings.append(city);
         }
     }
 
     // Check roads
     for (Road *road : m_roads) {
-        if (road->getTerritoryName() == territoryName) {
+        if (road->getTerritoryId() == territory) {
             buildings.append(road);
         }
     }
@@ -422,32 +506,32 @@ QList<Building*> Player::getBuildingsAtTerritory(const QString &territoryName) c
     return buildings;
 }
 
-QList<City*> Player::getCitiesAtTerritory(const QString &territoryName) const
+QList<City*> Player::getCitiesAtTerritory(TerritoryId territory) const
 {
     QList<City*> cities;
     for (City *city : m_cities) {
-        if (city->getTerritoryName() == territoryName) {
+        if (city->getTerritoryId() == territory) {
             cities.append(city);
         }
     }
     return cities;
 }
 
-QList<Road*> Player::getRoadsAtTerritory(const QString &territoryName) const
+QList<Road*> Player::getRoadsAtTerritory(TerritoryId territory) const
 {
     QList<Road*> roads;
     for (Road *road : m_roads) {
-        if (road->getTerritoryName() == territoryName) {
+        if (road->getTerritoryId() == territory) {
             roads.append(road);
         }
     }
     return roads;
 }
 
-City* Player::getCityAtTerritory(const QString &territoryName) const
+City* Player::getCityAtTerritory(TerritoryId territory) const
 {
     for (City *city : m_cities) {
-        if (city->getTerritoryName() == territoryName) {
+        if (city->getTerritoryId() == territory) {
             return city;  // Return first city found
         }
     }
@@ -456,48 +540,108 @@ City* Player::getCityAtTerritory(const QString &territoryName) const
 
 // ========== Query Pieces by Position ==========
 
-QList<GamePiece*> Player::getPiecesAtPosition(const Position &pos) const
+const QList<GamePiece*>& Player::getPiecesAtPosition(const Position &pos) const
 {
-    QList<GamePiece*> pieces;
+    static const QList<GamePiece*> noPieces;
+    if (!isOnBoard(pos.row, pos.col)) {
+        return noPieces;
+    }
+    return m_piecesByTile[tileIndex(pos.row, pos.col)];
+}
 
-    // Check all piece types
-    for (CaesarPiece *piece : m_caesars) {
-        if (piece->getPosition() == pos) {
-            pieces.append(piece);
-        }
+// ========== Per-Tile Piece Index ==========
+
+static bool isPrisoner(const GamePiece *piece)
+{
+    return piece->getType() == GamePiece::Type::General && static_cast<const GeneralPiece*>(piece)->isCaptured();
+}
+
+void Player::indexPiece(GamePiece *piece)
+{
+    if (connect(piece, &GamePiece::positionChanged, this, &Player::onPiecePositionChanged, Qt::UniqueConnection)) {
+        m_zobristHash += pieceKey(piece, piece->getPosition());
     }
+    insertAtTile(piece, piece->getPosition());
+}
 
-    for (GeneralPiece *piece : m_generals) {
-        if (piece->getPosition() == pos) {
-            pieces.append(piece);
-        }
+void Player::unindexPiece(GamePiece *piece)
+{
+    if (disconnect(piece, &GamePiece::positionChanged, this, &Player::onPiecePositionChanged)) {
+        m_zobristHash -= pieceKey(piece, piece->getPosition());
     }
+    removeFromTile(piece, piece->getPosition());
+}
 
-    for (InfantryPiece *piece : m_infantry) {
-        if (piece->getPosition() == pos) {
-            pieces.append(piece);
-        }
+void Player::onPiecePositionChanged(GamePiece *piece, const Position &oldPosition, const Position &newPosition)
+{
+    removeFromTile(piece, oldPosition);
+    insertAtTile(piece, newPosition);
+    m_zobristHash += pieceKey(piece, newPosition) - pieceKey(piece, oldPosition);
+}
+
+// ========== Zobrist Hash ==========
+
+int Player::seat() const
+{
+    return Zobrist::seat(m_id.toLatin1());
+}
+
+uint64_t Player::pieceKey(const GamePiece *piece, const Position &pos) const
+{
+    // Prisoners are off the board for the hash too (Zobrist::hash(PlayerState) skips them)
+    if (!isOnBoard(pos.row, pos.col) || isPrisoner(piece)) {
+        return 0;
     }
+    return Zobrist::piece(seat(), static_cast<PieceKind>(piece->getType()), tileIndex(pos.row, pos.col));
+}
 
-    for (CavalryPiece *piece : m_cavalry) {
-        if (piece->getPosition() == pos) {
-            pieces.append(piece);
-        }
+void Player::updateWalletHash(int oldAmount)
+{
+    m_zobristHash += Zobrist::wallet(seat(), m_wallet) - Zobrist::wallet(seat(), oldAmount);
+}
+
+void Player::onCityFortificationChanged(City *city, bool fortified)
+{
+    TerritoryId territory = territoryIdAt(city->getPosition());
+    if (territory == NO_TERRITORY) {
+        return;
     }
+    uint64_t key = Zobrist::fortification(seat(), territory);
+    m_zobristHash += fortified ? key : 0 - key;
+}
 
-    for (CatapultPiece *piece : m_catapults) {
-        if (piece->getPosition() == pos) {
-            pieces.append(piece);
-        }
+void Player::insertAtTile(GamePiece *piece, const Position &pos)
+{
+    // A prisoner never fights for its owner, so it doesn't occupy the tile
+    if (!isOnBoard(pos.row, pos.col) || isPrisoner(piece)) {
+        return;
     }
 
-    for (GalleyPiece *piece : m_galleys) {
-        if (piece->getPosition() == pos) {
-            pieces.append(piece);
-        }
+    QList<GamePiece*> &pieces = m_piecesByTile[tileIndex(pos.row, pos.col)];
+    if (pieces.contains(piece)) {
+        return;
     }
 
-    return pieces;
+    // Keep the same type order the old list-by-list scan produced
+    int index = pieces.size();
+    while (index > 0 && pieces[index - 1]->getType() > piece->getType()) {
+        --index;
+    }
+    pieces.insert(index, piece);
+    m_occupiedTiles.set(tileIndex(pos.row, pos.col));
+}
+
+void Player::removeFromTile(GamePiece *piece, const Position &pos)
+{
+    if (!isOnBoard(pos.row, pos.col)) {
+        return;
+    }
+
+    int tile = tileIndex(pos.row, pos.col);
+    QList<GamePiece*> &pieces = m_piecesByTile[tile];
+    if (pieces.removeOne(piece) && pieces.isEmpty()) {
+        m_occupiedTiles.reset(tile);
+    }
 }
 
 // ========== Query Buildings by Position ==========
@@ -546,14 +690,14 @@ int Player::getTotalBuildingCount() const
     return m_cities.size() + m_roads.size();
 }
 
-int Player::getPieceCountAtTerritory(const QString &territoryName) const
+int Player::getPieceCountAtTerritory(TerritoryId territory) const
 {
-    return getPiecesAtTerritory(territoryName).size();
+    return getPiecesAtTerritory(territory).size();
 }
 
-int Player::getBuildingCountAtTerritory(const QString &territoryName) const
+int Player::getBuildingCountAtTerritory(TerritoryId territory) const
 {
-    return getBuildingsAtTerritory(territoryName).size();
+    return getBuildingsAtTerritory(territory).size();
 }
 
 // ========== Money/Wallet Management ==========
@@ -565,6 +709,7 @@ void Player::addMoney(int amount)
     }
 
     m_wallet += amount;
+    updateWalletHash(m_wallet - amount);
     emit walletChanged(m_wallet);
     emit moneyAdded(amount, m_wallet);
 }
@@ -582,6 +727,7 @@ bool Player::spendMoney(int amount)
     }
 
     m_wallet -= amount;
+    updateWalletHash(m_wallet + amount);
     emit walletChanged(m_wallet);
     emit moneySpent(amount, m_wallet);
     return true;
@@ -593,30 +739,46 @@ void Player::setWallet(int amount)
         amount = 0;  // Don't allow negative wallet
     }
 
+    int oldAmount = m_wallet;
     m_wallet = amount;
+    updateWalletHash(oldAmount);
     emit walletChanged(m_wallet);
 }
 
 // ========== Territory Ownership Management ==========
 
-bool Player::ownsTerritory(const QString &territoryName) const
+QList<TerritoryId> Player::getOwnedTerritoryIds() const
 {
-    return m_ownedTerritories.contains(territoryName);
+    QList<TerritoryId> territories;
+    territories.reserve(m_ownedTerritories.count());
+    m_ownedTerritories.forEach([&territories](int tile) { territories.append(tile); });
+    return territories;
 }
 
-void Player::claimTerritory(const QString &territoryName)
+QList<QString> Player::getOwnedTerritories() const
 {
-    // Don't add duplicates
-    if (!m_ownedTerritories.contains(territoryName)) {
-        m_ownedTerritories.append(territoryName);
-        emit territoryClaimed(territoryName);
+    QList<QString> names;
+    names.reserve(m_ownedTerritories.count());
+    m_ownedTerritories.forEach([&names](int tile) { names.append(TerritoryNames::nameOf(tile)); });
+    return names;
+}
+
+void Player::claimTerritory(TerritoryId territory)
+{
+    // Don't add duplicates or unknown territories
+    if (territory != NO_TERRITORY && !m_ownedTerritories.test(territory)) {
+        m_ownedTerritories.set(territory);
+        m_zobristHash += Zobrist::owner(seat(), territory);
+        emit territoryClaimed(territory);
     }
 }
 
-void Player::unclaimTerritory(const QString &territoryName)
+void Player::unclaimTerritory(TerritoryId territory)
 {
-    if (m_ownedTerritories.removeOne(territoryName)) {
-        emit territoryUnclaimed(territoryName);
+    if (ownsTerritory(territory)) {
+        m_ownedTerritories.reset(territory);
+        m_zobristHash -= Zobrist::owner(seat(), territory);
+        emit territoryUnclaimed(territory);
     }
 }
 
@@ -629,6 +791,7 @@ void Player::claimTerritories(const QList<QString> &territoryNames)
 
 void Player::clearAllTerritories()
 {
+    m_ownedTerritories.forEach([this](int tile) { m_zobristHash -= Zobrist::owner(seat(), tile); });
     m_ownedTerritories.clear();
     emit territoriesCleared();
 }
@@ -637,6 +800,9 @@ void Player::clearAllTerritories()
 
 void Player::startTurn()
 {
+    if (!m_isMyTurn) {
+        m_zobristHash += Zobrist::toMove(seat());
+    }
     m_isMyTurn = true;
 
     // Reset movement for all pieces to their default values
@@ -675,6 +841,9 @@ void Player::startTurn()
 
 void Player::endTurn()
 {
+    if (m_isMyTurn) {
+        m_zobristHash -= Zobrist::toMove(seat());
+    }
     m_isMyTurn = false;
     // Future: Could add end-of-turn logic here (cleanup, etc.)
     emit turnEnded();
@@ -686,25 +855,16 @@ int Player::collectTaxes(MapWidget *mapWidget)
         return 0;
     }
 
-    int totalTaxes = 0;
-
-    // Iterate through all owned territories and sum their tax values
-    for (const QString &territoryName : m_ownedTerritories) {
-        // Find the territory on the map and get its value
-        for (int row = 0; row < 8; ++row) {
-            for (int col = 0; col < 12; ++col) {
-                if (mapWidget->getTerritoryNameAt(row, col) == territoryName) {
-                    int territoryValue = mapWidget->getTerritoryValueAt(row, col);
-                    totalTaxes += territoryValue;
-                    break; // Found the territory, move to next one
-                }
-            }
-        }
+    // Kept up to date by the map's score ledger, whose entries follow RulesEngine's income
+    // formula; debug builds check the amount paid is what the replay verifier re-executes
+    int totalTaxes = mapWidget->getScoreLedger()->getTaxIncome(m_id);
+#ifdef QT_DEBUG
+    int expected = RulesEngine::taxIncome(mapWidget->getTileValues(), m_ownedTerritories, m_cityTiles);
+    if (totalTaxes != expected) {
+        qWarning() << "Taxes for player" << m_id << "- ledger" << totalTaxes << "expected" << expected;
+        Q_ASSERT_X(false, "Player::collectTaxes", "score ledger disagrees with RulesEngine::taxIncome");
     }
-
-    // Add 5 talents for each city owned (cities are worth 5 each)
-    int cityTaxes = m_cities.size() * 5;
-    totalTaxes += cityTaxes;
+#endif
 
     // Add taxes to wallet
     if (totalTaxes > 0) {
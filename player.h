@@ -3,19 +3,26 @@
 
 #include <QObject>
 #include <QList>
+#include <QVector>
 #include <QColor>
 #include <QString>
 #include "common.h"
 #include "gamepiece.h"
 #include "building.h"
+#include "tilemask.h"
+#include "roadnetwork.h"
 
 class Player : public QObject
 {
     Q_OBJECT
 
 public:
+    // Empty players start with no pieces, buildings or territories and are filled in by the caller (loading a save)
+    enum class Setup { StartingForces, Empty };
+
     // Constructor - automatically creates Caesar, 5 Generals, and fortified city at home province
     explicit Player(QChar id, const Position &homeProvince, const QString &homeProvinceName, QObject *parent = nullptr);
+    Player(QChar id, const Position &homeProvince, const QString &homeProvinceName, Setup setup, QObject *parent = nullptr);
     ~Player();
 
     // Player identification
@@ -34,6 +41,7 @@ public:
     // Building inventory management
     const QList<City*>& getCities() const { return m_cities; }
     const QList<Road*>& getRoads() const { return m_roads; }
+    const RoadNetwork& getRoadNetwork() const { return m_roadNetwork; }  // Road graph, kept in sync with m_roads
 
     // Get all pieces (combined from all lists)
     QList<GamePiece*> getAllPieces() const;
@@ -67,27 +75,42 @@ public:
     bool removeCity(City *city);
     bool removeRoad(Road *road);
 
-    // Query pieces by location (territory name)
-    QList<GamePiece*> getPiecesAtTerritory(const QString &territoryName) const;
-    QList<CaesarPiece*> getCaesarsAtTerritory(const QString &territoryName) const;
-    QList<GeneralPiece*> getGeneralsAtTerritory(const QString &territoryName) const;
-    QList<InfantryPiece*> getInfantryAtTerritory(const QString &territoryName) const;
-    QList<CavalryPiece*> getCavalryAtTerritory(const QString &territoryName) const;
-    QList<CatapultPiece*> getCatapultsAtTerritory(const QString &territoryName) const;
-    QList<GalleyPiece*> getGalleysAtTerritory(const QString &territoryName) const;
-
-    // Query buildings by location (territory name)
-    QList<Building*> getBuildingsAtTerritory(const QString &territoryName) const;
-    QList<City*> getCitiesAtTerritory(const QString &territoryName) const;
-    QList<Road*> getRoadsAtTerritory(const QString &territoryName) const;
-    City* getCityAtTerritory(const QString &territoryName) const;  // Returns first city found or nullptr
-
-    // Query pieces by position
-    QList<GamePiece*> getPiecesAtPosition(const Position &pos) const;
+    // Query pieces by location (interned territory id; the name overloads convert once)
+    QList<GamePiece*> getPiecesAtTerritory(TerritoryId territory) const;
+    QList<CaesarPiece*> getCaesarsAtTerritory(TerritoryId territory) const;
+    QList<GeneralPiece*> getGeneralsAtTerritory(TerritoryId territory) const;
+    QList<InfantryPiece*> getInfantryAtTerritory(TerritoryId territory) const;
+    QList<CavalryPiece*> getCavalryAtTerritory(TerritoryId territory) const;
+    QList<CatapultPiece*> getCatapultsAtTerritory(TerritoryId territory) const;
+    QList<GalleyPiece*> getGalleysAtTerritory(TerritoryId territory) const;
+    QList<GamePiece*> getPiecesAtTerritory(const QString &territoryName) const { return getPiecesAtTerritory(TerritoryNames::idOf(territoryName)); }
+    QList<CaesarPiece*> getCaesarsAtTerritory(const QString &territoryName) const { return getCaesarsAtTerritory(TerritoryNames::idOf(territoryName)); }
+    QList<GeneralPiece*> getGeneralsAtTerritory(const QString &territoryName) const { return getGeneralsAtTerritory(TerritoryNames::idOf(territoryName)); }
+    QList<InfantryPiece*> getInfantryAtTerritory(const QString &territoryName) const { return getInfantryAtTerritory(TerritoryNames::idOf(territoryName)); }
+    QList<CavalryPiece*> getCavalryAtTerritory(const QString &territoryName) const { return getCavalryAtTerritory(TerritoryNames::idOf(territoryName)); }
+    QList<CatapultPiece*> getCatapultsAtTerritory(const QString &territoryName) const { return getCatapultsAtTerritory(TerritoryNames::idOf(territoryName)); }
+    QList<GalleyPiece*> getGalleysAtTerritory(const QString &territoryName) const { return getGalleysAtTerritory(TerritoryNames::idOf(territoryName)); }
+
+    // Query buildings by location (interned territory id; the name overloads convert once)
+    QList<Building*> getBuildingsAtTerritory(TerritoryId territory) const;
+    QList<City*> getCitiesAtTerritory(TerritoryId territory) const;
+    QList<Road*> getRoadsAtTerritory(TerritoryId territory) const;
+    City* getCityAtTerritory(TerritoryId territory) const;  // Returns first city found or nullptr
+    QList<Building*> getBuildingsAtTerritory(const QString &territoryName) const { return getBuildingsAtTerritory(TerritoryNames::idOf(territoryName)); }
+    QList<City*> getCitiesAtTerritory(const QString &territoryName) const { return getCitiesAtTerritory(TerritoryNames::idOf(territoryName)); }
+    QList<Road*> getRoadsAtTerritory(const QString &territoryName) const { return getRoadsAtTerritory(TerritoryNames::idOf(territoryName)); }
+    City* getCityAtTerritory(const QString &territoryName) const { return getCityAtTerritory(TerritoryNames::idOf(territoryName)); }
+
+    // Query pieces by position (per-tile index, ordered Caesar → Galley, no allocation)
+    const QList<GamePiece*>& getPiecesAtPosition(const Position &pos) const;
+    // Tiles holding at least one of this player's pieces, updated on every move
+    const TileMask& getOccupiedTiles() const { return m_occupiedTiles; }
 
     // Query buildings by position
     QList<Building*> getBuildingsAtPosition(const Position &pos) const;
     City* getCityAtPosition(const Position &pos) const;  // Returns first city found or nullptr
+    bool hasCityAt(TerritoryId territory) const { return territory != NO_TERRITORY && m_cityTiles.test(territory); }
+    const TileMask& getCityTiles() const { return m_cityTiles; }
 
     // Count pieces
     int getTotalPieceCount() const;
@@ -105,10 +128,12 @@ public:
     int getRoadCount() const { return m_roads.size(); }
 
     // Count pieces at a specific location
-    int getPieceCountAtTerritory(const QString &territoryName) const;
+    int getPieceCountAtTerritory(TerritoryId territory) const;
+    int getPieceCountAtTerritory(const QString &territoryName) const { return getPieceCountAtTerritory(TerritoryNames::idOf(territoryName)); }
 
     // Count buildings at a specific location
-    int getBuildingCountAtTerritory(const QString &territoryName) const;
+    int getBuildingCountAtTerritory(TerritoryId territory) const;
+    int getBuildingCountAtTerritory(const QString &territoryName) const { return getBuildingCountAtTerritory(TerritoryNames::idOf(territoryName)); }
 
     // Economic data - Money/Wallet management
     int getWallet() const { return m_wallet; }
@@ -138,14 +163,19 @@ public:
     bool hasCity() const { return m_hasHomeFortifiedCity; }
     bool hasFortification() const { return m_hasHomeFortifiedCity; }
 
-    // Territory ownership (icon markers) - territories claimed by this player
-    const QList<QString>& getOwnedTerritories() const { return m_ownedTerritories; }
-    bool ownsTerritory(const QString &territoryName) const;
-    int getOwnedTerritoryCount() const { return m_ownedTerritories.size(); }
+    // Territory ownership (icon markers) - territories claimed by this player, one bit per tile
+    const TileMask& getOwnedTerritoryMask() const { return m_ownedTerritories; }
+    QList<TerritoryId> getOwnedTerritoryIds() const;  // In board order
+    QList<QString> getOwnedTerritories() const;  // Names, for display and save files
+    bool ownsTerritory(TerritoryId territory) const { return territory != NO_TERRITORY && m_ownedTerritories.test(territory); }
+    bool ownsTerritory(const QString &territoryName) const { return ownsTerritory(TerritoryNames::idOf(territoryName)); }
+    int getOwnedTerritoryCount() const { return m_ownedTerritories.count(); }
 
     // Claim/unclaim territories
-    void claimTerritory(const QString &territoryName);
-    void unclaimTerritory(const QString &territoryName);
+    void claimTerritory(TerritoryId territory);
+    void unclaimTerritory(TerritoryId territory);
+    void claimTerritory(const QString &territoryName) { claimTerritory(TerritoryNames::idOf(territoryName)); }
+    void unclaimTerritory(const QString &territoryName) { unclaimTerritory(TerritoryNames::idOf(territoryName)); }
     bool removeTerritory(const QString &territoryName) { unclaimTerritory(territoryName); return true; }  // Alias
 
     // Claim multiple territories at once
@@ -159,10 +189,18 @@ public:
     void endTurn();    // Called at the end of player's turn
     bool isMyTurn() const { return m_isMyTurn; }
 
+    // Played by the computer (MctsPlayer) instead of a person
+    bool isComputerControlled() const { return m_isComputerControlled; }
+    void setComputerControlled(bool computer) { m_isComputerControlled = computer; }
+
     // Tax collection - called at end of turn to collect taxes from owned territories
     // Returns the amount collected
     int collectTaxes(class MapWidget *mapWidget);
 
+    // Zobrist hash of this player's share of the position (pieces, territories, cities,
+    // wallet bucket, whose turn), updated as they change; the game hash is the sum over players
+    uint64_t getZobristHash() const { return m_zobristHash; }
+
 signals:
     void turnStarted();
     void turnEnded();
@@ -178,11 +216,29 @@ signals:
     void insufficientFunds(int required, int available);  // Emitted when trying to spend more than available
 
     // Territory ownership signals
-    void territoryClaimed(QString territoryName);
-    void territoryUnclaimed(QString territoryName);
+    void territoryClaimed(TerritoryId territory);
+    void territoryUnclaimed(TerritoryId territory);
     void territoriesCleared();  // All territories lost
 
+private slots:
+    void onPiecePositionChanged(GamePiece *piece, const Position &oldPosition, const Position &newPosition);
+    void onCityFortificationChanged(City *city, bool fortified);
+
 private:
+    void createStartingForces();
+
+    // Per-tile index maintenance. Prisoners are never indexed: a captured general leaves its
+    // owner's lists when it is taken, and the captor's captured list isn't indexed either
+    void indexPiece(GamePiece *piece);
+    void unindexPiece(GamePiece *piece);
+    void insertAtTile(GamePiece *piece, const Position &pos);
+    void removeFromTile(GamePiece *piece, const Position &pos);
+
+    // Zobrist hash maintenance
+    int seat() const;
+    uint64_t pieceKey(const GamePiece *piece, const Position &pos) const;
+    void updateWalletHash(int oldAmount);
+
     QChar m_id;                           // Player ID: 'A' through 'F'
     QColor m_color;                       // Player color
 
@@ -195,9 +251,15 @@ private:
     QList<CatapultPiece*> m_catapults;    // Can have many
     QList<GalleyPiece*> m_galleys;        // Can have many
 
+    // Pieces on each tile (index row * COLUMNS + col), kept in sync through positionChanged
+    QVector<QList<GamePiece*>> m_piecesByTile;
+    TileMask m_occupiedTiles;             // Non-empty buckets of m_piecesByTile
+
     // Building inventory lists
     QList<City*> m_cities;                // Can have many cities
     QList<Road*> m_roads;                 // Can have many roads
+    RoadNetwork m_roadNetwork;            // Tiles joined by m_roads, with connected components
+    TileMask m_cityTiles;                 // Tiles holding at least one of m_cities
 
     // Economic data
     int m_wallet;                         // Accumulated wealth in talents
@@ -208,10 +270,13 @@ private:
     bool m_hasHomeFortifiedCity;          // Every player starts with a fortified city at home
 
     // Territory ownership (icon markers)
-    QList<QString> m_ownedTerritories;    // List of territory names owned by this player
+    TileMask m_ownedTerritories;          // Territories owned by this player
 
     // Turn management
     bool m_isMyTurn;                      // Is it currently this player's turn?
+    bool m_isComputerControlled;          // Turns are played by the computer
+
+    uint64_t m_zobristHash;               // Sum of the Zobrist keys of everything above that is hashed
 
     // Helper function to get color based on player ID
     QColor getColorForPlayer(QChar playerId) const;
@@ -6,6 +6,10 @@
 #include "citydestructiondialog.h"
 #include "gamepiece.h"
 #include "building.h"
+#include "gamestatebridge.h"
+#include "gamejournal.h"
+#include "rulesengine.h"
+#include "mctsplayer.h"
 #include <QScrollArea>
 #include <QGridLayout>
 #include <QFrame>
@@ -15,12 +19,18 @@
 #include <QPainter>
 #include <QPixmap>
 #include <QSettings>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QStandardPaths>
 #include <QCloseEvent>
 #include <QDialogButtonBox>
 #include <QPushButton>
 #include <QDebug>
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QTimer>
+#include <QEventLoop>
+#include <future>
 
 PlayerInfoWidget::PlayerInfoWidget(QWidget *parent)
     : QWidget(parent)
@@ -28,6 +38,8 @@ PlayerInfoWidget::PlayerInfoWidget(QWidget *parent)
     , m_mapWidget(nullptr)
     , m_capturedGeneralsGroupBox(nullptr)
     , m_capturedGeneralsTable(nullptr)
+    , m_computerTurnRunning(false)
+    , m_journal(nullptr)
 {
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
 
@@ -169,18 +181,7 @@ QGroupBox* PlayerInfoWidget::createEconomicsSection(Player *player)
     // Calculate total tax value from all owned territories
     int totalTaxValue = 0;
     if (m_mapWidget) {
-        const QList<QString> &territories = player->getOwnedTerritories();
-        for (const QString &territoryName : territories) {
-            // Find the territory position by searching the map
-            for (int row = 0; row < 8; ++row) {
-                for (int col = 0; col < 12; ++col) {
-                    if (m_mapWidget->getTerritoryNameAt(row, col) == territoryName) {
-                        totalTaxValue += m_mapWidget->getTerritoryValueAt(row, col);
-                        break;
-                    }
-                }
-            }
-        }
+        totalTaxValue = m_mapWidget->getTerritoryValue(player->getOwnedTerritoryMask());
     }
 
     layout->addWidget(new QLabel("<b>Total Tax Value:</b>"), 2, 0);
@@ -192,7 +193,7 @@ QGroupBox* PlayerInfoWidget::createEconomicsSection(Player *player)
 
 QGroupBox* PlayerInfoWidget::createTerritoriesSection(Player *player)
 {
-    QGroupBox *groupBox = new QGroupBox(QString("Owned Territories (%1)").arg(player->getOwnedTerritories().size()));
+    QGroupBox *groupBox = new QGroupBox(QString("Owned Territories (%1)").arg(player->getOwnedTerritoryCount()));
     QVBoxLayout *layout = new QVBoxLayout();
 
     const QList<QString> &territories = player->getOwnedTerritories();
@@ -219,19 +220,7 @@ QGroupBox* PlayerInfoWidget::createTerritoriesSection(Player *player)
 
         for (const QString &territoryName : territories) {
             // Find the tax value for this territory
-            int taxValue = 0;
-            bool found = false;
-            if (m_mapWidget) {
-                for (int r = 0; r < 8 && !found; ++r) {
-                    for (int c = 0; c < 12; ++c) {
-                        if (m_mapWidget->getTerritoryNameAt(r, c) == territoryName) {
-                            taxValue = m_mapWidget->getTerritoryValueAt(r, c);
-                            found = true;
-                            break;
-                        }
-                    }
-                }
-            }
+            int taxValue = m_mapWidget ? m_mapWidget->getTerritoryValue(territoryName) : 0;
 
             // Check if player has a city here
             City *city = player->getCityAtTerritory(territoryName);
@@ -622,10 +611,13 @@ void PlayerInfoWidget::showCaesarContextMenu(CaesarPiece *piece, const QPoint &p
     QMenu *moveSubmenu = new QMenu("Move", this);
     Position currentPos = piece->getPosition();
 
+    // Land neighbours from the map's precomputed movement tables
+    const TileMask &landSteps = m_mapWidget->getReachability().landStep(tileIndex(currentPos.row, currentPos.col));
+
     // Up (row - 1)
     QString upTerritory = (currentPos.row > 0) ? getTerritoryNameAt(currentPos.row - 1, currentPos.col) : "Off Board";
     int upValue = (currentPos.row > 0) ? m_mapWidget->getTerritoryValueAt(currentPos.row - 1, currentPos.col) : 0;
-    bool upIsSea = (currentPos.row > 0) && m_mapWidget->isSeaTerritory(currentPos.row - 1, currentPos.col);
+    bool upIsSea = (currentPos.row > 0) && !landSteps.test(tileIndex(currentPos.row - 1, currentPos.col));
     QChar upOwner = (currentPos.row > 0) ? m_mapWidget->getTerritoryOwnerAt(currentPos.row - 1, currentPos.col) : '\0';
     QString upOwnership = (upOwner == '\0') ? "[Unclaimed]" : (upOwner == piece->getPlayer()) ? "[You]" : QString("[Player %1]").arg(upOwner);
     QString upTroops = (currentPos.row > 0) ? getTroopInfoAt(currentPos.row - 1, currentPos.col) : "";
@@ -675,7 +667,7 @@ void PlayerInfoWidget::showCaesarContextMenu(CaesarPiece *piece, const QPoint &p
     // Down (row + 1)
     QString downTerritory = (currentPos.row < 7) ? getTerritoryNameAt(currentPos.row + 1, currentPos.col) : "Off Board";
     int downValue = (currentPos.row < 7) ? m_mapWidget->getTerritoryValueAt(currentPos.row + 1, currentPos.col) : 0;
-    bool downIsSea = (currentPos.row < 7) && m_mapWidget->isSeaTerritory(currentPos.row + 1, currentPos.col);
+    bool downIsSea = (currentPos.row < 7) && !landSteps.test(tileIndex(currentPos.row + 1, currentPos.col));
     QChar downOwner = (currentPos.row < 7) ? m_mapWidget->getTerritoryOwnerAt(currentPos.row + 1, currentPos.col) : '\0';
     QString downOwnership = (downOwner == '\0') ? "[Unclaimed]" : (downOwner == piece->getPlayer()) ? "[You]" : QString("[Player %1]").arg(downOwner);
     QString downTroops = (currentPos.row < 7) ? getTroopInfoAt(currentPos.row + 1, currentPos.col) : "";
@@ -725,7 +717,7 @@ void PlayerInfoWidget::showCaesarContextMenu(CaesarPiece *piece, const QPoint &p
     // Left (col - 1)
     QString leftTerritory = (currentPos.col > 0) ? getTerritoryNameAt(currentPos.row, currentPos.col - 1) : "Off Board";
     int leftValue = (currentPos.col > 0) ? m_mapWidget->getTerritoryValueAt(currentPos.row, currentPos.col - 1) : 0;
-    bool leftIsSea = (currentPos.col > 0) && m_mapWidget->isSeaTerritory(currentPos.row, currentPos.col - 1);
+    bool leftIsSea = (currentPos.col > 0) && !landSteps.test(tileIndex(currentPos.row, currentPos.col - 1));
     QChar leftOwner = (currentPos.col > 0) ? m_mapWidget->getTerritoryOwnerAt(currentPos.row, currentPos.col - 1) : '\0';
     QString leftOwnership = (leftOwner == '\0') ? "[Unclaimed]" : (leftOwner == piece->getPlayer()) ? "[You]" : QString("[Player %1]").arg(leftOwner);
     QString leftTroops = (currentPos.col > 0) ? getTroopInfoAt(currentPos.row, currentPos.col - 1) : "";
@@ -775,7 +767,7 @@ void PlayerInfoWidget::showCaesarContextMenu(CaesarPiece *piece, const QPoint &p
     // Right (col + 1)
     QString rightTerritory = (currentPos.col < 11) ? getTerritoryNameAt(currentPos.row, currentPos.col + 1) : "Off Board";
     int rightValue = (currentPos.col < 11) ? m_mapWidget->getTerritoryValueAt(currentPos.row, currentPos.col + 1) : 0;
-    bool rightIsSea = (currentPos.col < 11) && m_mapWidget->isSeaTerritory(currentPos.row, currentPos.col + 1);
+    bool rightIsSea = (currentPos.col < 11) && !landSteps.test(tileIndex(currentPos.row, currentPos.col + 1));
     QChar rightOwner = (currentPos.col < 11) ? m_mapWidget->getTerritoryOwnerAt(currentPos.row, currentPos.col + 1) : '\0';
     QString rightOwnership = (rightOwner == '\0') ? "[Unclaimed]" : (rightOwner == piece->getPlayer()) ? "[You]" : QString("[Player %1]").arg(rightOwner);
     QString rightTroops = (currentPos.col < 11) ? getTroopInfoAt(currentPos.row, currentPos.col + 1) : "";
@@ -842,10 +834,13 @@ void PlayerInfoWidget::showGeneralContextMenu(GeneralPiece *piece, const QPoint
     QMenu *moveSubmenu = new QMenu("Move", this);
     Position currentPos = piece->getPosition();
 
+    // Land neighbours from the map's precomputed movement tables
+    const TileMask &landSteps = m_mapWidget->getReachability().landStep(tileIndex(currentPos.row, currentPos.col));
+
     // Up (row - 1)
     QString upTerritory = (currentPos.row > 0) ? getTerritoryNameAt(currentPos.row - 1, currentPos.col) : "Off Board";
     int upValue = (currentPos.row > 0) ? m_mapWidget->getTerritoryValueAt(currentPos.row - 1, currentPos.col) : 0;
-    bool upIsSea = (currentPos.row > 0) && m_mapWidget->isSeaTerritory(currentPos.row - 1, currentPos.col);
+    bool upIsSea = (currentPos.row > 0) && !landSteps.test(tileIndex(currentPos.row - 1, currentPos.col));
     QChar upOwner = (currentPos.row > 0) ? m_mapWidget->getTerritoryOwnerAt(currentPos.row - 1, currentPos.col) : '\0';
     QString upOwnership = (upOwner == '\0') ? "[Unclaimed]" : (upOwner == piece->getPlayer()) ? "[You]" : QString("[Player %1]").arg(upOwner);
     QString upTroops = (currentPos.row > 0) ? getTroopInfoAt(currentPos.row - 1, currentPos.col) : "";
@@ -895,7 +890,7 @@ void PlayerInfoWidget::showGeneralContextMenu(GeneralPiece *piece, const QPoint
     // Down (row + 1)
     QString downTerritory = (currentPos.row < 7) ? getTerritoryNameAt(currentPos.row + 1, currentPos.col) : "Off Board";
     int downValue = (currentPos.row < 7) ? m_mapWidget->getTerritoryValueAt(currentPos.row + 1, currentPos.col) : 0;
-    bool downIsSea = (currentPos.row < 7) && m_mapWidget->isSeaTerritory(currentPos.row + 1, currentPos.col);
+    bool downIsSea = (currentPos.row < 7) && !landSteps.test(tileIndex(currentPos.row + 1, currentPos.col));
     QChar downOwner = (currentPos.row < 7) ? m_mapWidget->getTerritoryOwnerAt(currentPos.row + 1, currentPos.col) : '\0';
     QString downOwnership = (downOwner == '\0') ? "[Unclaimed]" : (downOwner == piece->getPlayer()) ? "[You]" : QString("[Player %1]").arg(downOwner);
     QString downTroops = (currentPos.row < 7) ? getTroopInfoAt(currentPos.row + 1, currentPos.col) : "";
@@ -945,7 +940,7 @@ void PlayerInfoWidget::showGeneralContextMenu(GeneralPiece *piece, const QPoint
     // Left (col - 1)
     QString leftTerritory = (currentPos.col > 0) ? getTerritoryNameAt(currentPos.row, currentPos.col - 1) : "Off Board";
     int leftValue = (currentPos.col > 0) ? m_mapWidget->getTerritoryValueAt(currentPos.row, currentPos.col - 1) : 0;
-    bool leftIsSea = (currentPos.col > 0) && m_mapWidget->isSeaTerritory(currentPos.row, currentPos.col - 1);
+    bool leftIsSea = (currentPos.col > 0) && !landSteps.test(tileIndex(currentPos.row, currentPos.col - 1));
     QChar leftOwner = (currentPos.col > 0) ? m_mapWidget->getTerritoryOwnerAt(currentPos.row, currentPos.col - 1) : '\0';
     QString leftOwnership = (leftOwner == '\0') ? "[Unclaimed]" : (leftOwner == piece->getPlayer()) ? "[You]" : QString("[Player %1]").arg(leftOwner);
     QString leftTroops = (currentPos.col > 0) ? getTroopInfoAt(currentPos.row, currentPos.col - 1) : "";
@@ -995,7 +990,7 @@ void PlayerInfoWidget::showGeneralContextMenu(GeneralPiece *piece, const QPoint
     // Right (col + 1)
     QString rightTerritory = (currentPos.col < 11) ? getTerritoryNameAt(currentPos.row, currentPos.col + 1) : "Off Board";
     int rightValue = (currentPos.col < 11) ? m_mapWidget->getTerritoryValueAt(currentPos.row, currentPos.col + 1) : 0;
-    bool rightIsSea = (currentPos.col < 11) && m_mapWidget->isSeaTerritory(currentPos.row, currentPos.col + 1);
+    bool rightIsSea = (currentPos.col < 11) && !landSteps.test(tileIndex(currentPos.row, currentPos.col + 1));
     QChar rightOwner = (currentPos.col < 11) ? m_mapWidget->getTerritoryOwnerAt(currentPos.row, currentPos.col + 1) : '\0';
     QString rightOwnership = (rightOwner == '\0') ? "[Unclaimed]" : (rightOwner == piece->getPlayer()) ? "[You]" : QString("[Player %1]").arg(rightOwner);
     QString rightTroops = (currentPos.col < 11) ? getTroopInfoAt(currentPos.row, currentPos.col + 1) : "";
@@ -1059,8 +1054,8 @@ void PlayerInfoWidget::movePiece(GamePiece *piece, int rowDelta, int colDelta)
         return;
     }
 
-    // Get the new territory name
-    QString newTerritoryName = getTerritoryNameAt(newPos.row, newPos.col);
+    // Get the new territory
+    TerritoryId newTerritory = territoryIdAt(newPos);
 
     // Find which player owns this piece
     Player *owningPlayer = nullptr;
@@ -1094,24 +1089,24 @@ void PlayerInfoWidget::movePiece(GamePiece *piece, int rowDelta, int colDelta)
     if (!hasEnemyPieces) {
         // Check if another player owns this territory
         for (Player *otherPlayer : m_players) {
-            if (otherPlayer != owningPlayer && otherPlayer->ownsTerritory(newTerritoryName)) {
+            if (otherPlayer != owningPlayer && otherPlayer->ownsTerritory(newTerritory)) {
                 // Remove ownership from the other player
-                otherPlayer->unclaimTerritory(newTerritoryName);
+                otherPlayer->unclaimTerritory(newTerritory);
                 break;
             }
         }
 
         // Claim the new territory for the moving player
-        if (!owningPlayer->ownsTerritory(newTerritoryName)) {
-            owningPlayer->claimTerritory(newTerritoryName);
+        if (!owningPlayer->ownsTerritory(newTerritory)) {
+            owningPlayer->claimTerritory(newTerritory);
         }
     }
 
     // Update position
     piece->setPosition(newPos);
 
-    // Update territory name
-    piece->setTerritoryName(newTerritoryName);
+    // Update territory
+    piece->setTerritoryId(newTerritory);
 
     // Decrement movement
     piece->setMovesRemaining(piece->getMovesRemaining() - 1);
@@ -1141,8 +1136,8 @@ void PlayerInfoWidget::movePieceWithoutCost(GamePiece *piece, int rowDelta, int
         return;
     }
 
-    // Get the new territory name
-    QString newTerritoryName = getTerritoryNameAt(newPos.row, newPos.col);
+    // Get the new territory
+    TerritoryId newTerritory = territoryIdAt(newPos);
 
     // Find which player owns this piece
     Player *owningPlayer = nullptr;
@@ -1176,24 +1171,24 @@ void PlayerInfoWidget::movePieceWithoutCost(GamePiece *piece, int rowDelta, int
     if (!hasEnemyPieces) {
         // Check if another player owns this territory
         for (Player *otherPlayer : m_players) {
-            if (otherPlayer != owningPlayer && otherPlayer->ownsTerritory(newTerritoryName)) {
+            if (otherPlayer != owningPlayer && otherPlayer->ownsTerritory(newTerritory)) {
                 // Remove ownership from the other player
-                otherPlayer->unclaimTerritory(newTerritoryName);
+                otherPlayer->unclaimTerritory(newTerritory);
                 break;
             }
         }
 
         // Claim the new territory for the moving player
-        if (!owningPlayer->ownsTerritory(newTerritoryName)) {
-            owningPlayer->claimTerritory(newTerritoryName);
+        if (!owningPlayer->ownsTerritory(newTerritory)) {
+            owningPlayer->claimTerritory(newTerritory);
         }
     }
 
     // Update position
     piece->setPosition(newPos);
 
-    // Update territory name
-    piece->setTerritoryName(newTerritoryName);
+    // Update territory
+    piece->setTerritoryId(newTerritory);
 
     // DO NOT decrement movement - caller will handle it
 
@@ -1394,46 +1389,7 @@ void PlayerInfoWidget::moveLeaderWithTroops(GamePiece *leader, int rowDelta, int
         }
     }
 
-    // Save current tab index before any moves
-    int currentTabIndex = m_tabWidget->currentIndex();
-
-    // Store last territory before moving (for retreat purposes)
-    if (leader->getType() == GamePiece::Type::Caesar) {
-        static_cast<CaesarPiece*>(leader)->setLastTerritory(currentPos);
-    } else if (leader->getType() == GamePiece::Type::General) {
-        static_cast<GeneralPiece*>(leader)->setLastTerritory(currentPos);
-    } else if (leader->getType() == GamePiece::Type::Galley) {
-        static_cast<GalleyPiece*>(leader)->setLastTerritory(currentPos);
-    }
-
-    // Move the leader first
-    movePiece(leader, rowDelta, colDelta);
-    qDebug() << "Moved leader" << leaderName;
-
-    // Move all selected troops
-    for (int pieceId : selectedTroopIds) {
-        for (GamePiece *piece : troopsAtPosition) {
-            if (piece->getUniqueId() == pieceId) {
-                qDebug() << "Moving troop ID:" << pieceId << "from" << piece->getPosition().row << piece->getPosition().col;
-                movePiece(piece, rowDelta, colDelta);
-                qDebug() << "  to" << piece->getPosition().row << piece->getPosition().col;
-                break;
-            }
-        }
-    }
-    qDebug() << "Finished moving all troops";
-
-    // If we entered combat, consume all remaining moves for the leader
-    if (hasEnemies) {
-        leader->setMovesRemaining(0);
-        qDebug() << "Entered combat - all moves consumed for" << leaderName;
-    }
-
-    // Update display once after all moves
-    updateAllPlayers();
-
-    // Restore the tab index
-    m_tabWidget->setCurrentIndex(currentTabIndex);
+    executeLeaderMove(leader, destPos, selectedTroopIds, false);
 
     delete dialog;
 }
@@ -1445,10 +1401,6 @@ void PlayerInfoWidget::moveLeaderViaRoad(GamePiece *leader, const Position &dest
     // Get the leader's current position
     Position currentPos = leader->getPosition();
 
-    // Calculate the delta to the destination
-    int rowDelta = destination.row - currentPos.row;
-    int colDelta = destination.col - currentPos.col;
-
     // Find the player who owns this leader
     Player *owningPlayer = nullptr;
     for (Player *player : m_players) {
@@ -1628,6 +1580,40 @@ void PlayerInfoWidget::moveLeaderViaRoad(GamePiece *leader, const Position &dest
         }
     }
 
+    executeLeaderMove(leader, destination, selectedTroopIds, true);
+
+    delete dialog;
+}
+
+void PlayerInfoWidget::executeLeaderMove(GamePiece *leader, const Position &destination, const QList<int> &troopIds, bool viaRoad)
+{
+    if (!leader || !m_mapWidget) return;
+
+    // Find the player who owns this leader
+    Player *owningPlayer = nullptr;
+    for (Player *player : m_players) {
+        if (player->getId() == leader->getPlayer()) {
+            owningPlayer = player;
+            break;
+        }
+    }
+
+    if (!owningPlayer) return;
+
+    Position currentPos = leader->getPosition();
+    int rowDelta = destination.row - currentPos.row;
+    int colDelta = destination.col - currentPos.col;
+
+    // The selected troops standing with the leader
+    QList<GamePiece*> troops;
+    for (GamePiece *piece : owningPlayer->getPiecesAtPosition(currentPos)) {
+        if (piece != leader && troopIds.contains(piece->getUniqueId())) {
+            troops.append(piece);
+        }
+    }
+
+    bool hasEnemies = m_mapWidget->hasEnemyPiecesAt(destination.row, destination.col, owningPlayer->getId());
+
     // Save current tab index before any moves
     int currentTabIndex = m_tabWidget->currentIndex();
 
@@ -1640,43 +1626,38 @@ void PlayerInfoWidget::moveLeaderViaRoad(GamePiece *leader, const Position &dest
         static_cast<GalleyPiece*>(leader)->setLastTerritory(currentPos);
     }
 
-    // Move the leader using the calculated delta (without consuming movement points yet)
-    movePieceWithoutCost(leader, rowDelta, colDelta);
-    qDebug() << "Moved leader" << leaderName << "via road to" << destination.row << destination.col;
-
-    // Move all selected troops (without consuming movement points yet)
-    for (int pieceId : selectedTroopIds) {
-        for (GamePiece *piece : troopsAtPosition) {
-            if (piece->getUniqueId() == pieceId) {
-                qDebug() << "Moving troop ID:" << pieceId << "via road from" << piece->getPosition().row << piece->getPosition().col;
-                movePieceWithoutCost(piece, rowDelta, colDelta);
-                qDebug() << "  to" << piece->getPosition().row << piece->getPosition().col;
-                break;
-            }
+    if (viaRoad) {
+        // Move the leader and troops without consuming movement points yet
+        movePieceWithoutCost(leader, rowDelta, colDelta);
+        for (GamePiece *piece : troops) {
+            movePieceWithoutCost(piece, rowDelta, colDelta);
         }
-    }
-    qDebug() << "Finished moving all troops via road";
+        qDebug() << "Moved leader ID:" << leader->getUniqueId() << "and" << troops.size() << "troops via road to"
+                 << destination.row << destination.col;
 
-    // IMPORTANT: Road movement only costs 1 movement point, regardless of distance
-    // Deduct 1 move from leader
-    if (leader->getMovesRemaining() > 0) {
-        leader->setMovesRemaining(leader->getMovesRemaining() - 1);
-    }
-
-    // Deduct 1 move from all troops that moved
-    for (int pieceId : selectedTroopIds) {
-        for (GamePiece *piece : troopsAtPosition) {
-            if (piece->getUniqueId() == pieceId && piece->getMovesRemaining() > 0) {
+        // IMPORTANT: Road movement only costs 1 movement point, regardless of distance
+        if (leader->getMovesRemaining() > 0) {
+            leader->setMovesRemaining(leader->getMovesRemaining() - 1);
+        }
+        for (GamePiece *piece : troops) {
+            if (piece->getMovesRemaining() > 0) {
                 piece->setMovesRemaining(piece->getMovesRemaining() - 1);
-                break;
             }
         }
+    } else {
+        // Move the leader first, then its troops
+        movePiece(leader, rowDelta, colDelta);
+        for (GamePiece *piece : troops) {
+            movePiece(piece, rowDelta, colDelta);
+        }
+        qDebug() << "Moved leader ID:" << leader->getUniqueId() << "and" << troops.size() << "troops to"
+                 << destination.row << destination.col;
     }
 
     // If we entered combat, consume all remaining moves for the leader
     if (hasEnemies) {
         leader->setMovesRemaining(0);
-        qDebug() << "Entered combat via road - all moves consumed for" << leaderName;
+        qDebug() << "Entered combat - all moves consumed for leader ID:" << leader->getUniqueId();
     }
 
     // Update display once after all moves
@@ -1685,7 +1666,7 @@ void PlayerInfoWidget::moveLeaderViaRoad(GamePiece *leader, const Position &dest
     // Restore the tab index
     m_tabWidget->setCurrentIndex(currentTabIndex);
 
-    delete dialog;
+    recordHistory(viaRoad ? "Road Move" : "Move");
 }
 
 QString PlayerInfoWidget::getTerritoryNameAt(int row, int col) const
@@ -1857,40 +1838,12 @@ void PlayerInfoWidget::onEndTurnClicked()
     }
 
     // Detect combat territories FIRST before taxes and purchases
-    // Scan all territories for mixed player pieces
-    QMap<QString, Position> combatTerritories;  // Map of territory name to position
-
-    for (int row = 0; row < 8; ++row) {
-        for (int col = 0; col < 12; ++col) {
-            Position pos = {row, col};
+    // Intersect our occupancy mask with every enemy's to find shared tiles
+    QMap<TerritoryId, Position> combatTerritories;  // Map of territory to position
 
-            // Check if current player has pieces at this position
-            QList<GamePiece*> currentPlayerPieces = currentPlayer->getPiecesAtPosition(pos);
-            if (currentPlayerPieces.isEmpty()) {
-                continue;  // No pieces from current player here
-            }
-
-            // Check if any other player has pieces at this position
-            bool hasEnemyPieces = false;
-            for (Player *player : m_players) {
-                if (player->getId() != currentPlayer->getId()) {
-                    QList<GamePiece*> enemyPieces = player->getPiecesAtPosition(pos);
-                    if (!enemyPieces.isEmpty()) {
-                        hasEnemyPieces = true;
-                        break;
-                    }
-                }
-            }
-
-            // If we have both current player and enemy pieces, this is a combat territory
-            if (hasEnemyPieces) {
-                QString territoryName = m_mapWidget->getTerritoryNameAt(row, col);
-                if (!combatTerritories.contains(territoryName)) {
-                    combatTerritories[territoryName] = pos;
-                }
-            }
-        }
-    }
+    m_mapWidget->getCombatTiles(currentPlayer->getId()).forEach([&](int tile) {
+        combatTerritories[tile] = GameStateBridge::toPosition(tile);
+    });
 
     // If there are combat territories, show the list to the player
     if (!combatTerritories.isEmpty()) {
@@ -1899,7 +1852,7 @@ void PlayerInfoWidget::onEndTurnClicked()
         combatList << "";
 
         for (auto it = combatTerritories.constBegin(); it != combatTerritories.constEnd(); ++it) {
-            QString territoryName = it.key();
+            QString territoryName = TerritoryNames::nameOf(it.key());
             Position pos = it.value();
 
             // Count pieces at this location
@@ -1934,7 +1887,9 @@ void PlayerInfoWidget::onEndTurnClicked()
         combatList << "";
         combatList << "You must resolve all combats before ending your turn.";
 
-        QMessageBox::information(this, "Combat Detected", combatList.join("\n"));
+        if (!currentPlayer->isComputerControlled()) {
+            QMessageBox::information(this, "Combat Detected", combatList.join("\n"));
+        }
 
         // Resolve each combat
         for (auto it = combatTerritories.constBegin(); it != combatTerritories.constEnd(); ++it) {
@@ -1957,6 +1912,7 @@ void PlayerInfoWidget::onEndTurnClicked()
                 CombatDialog *combatDialog = new CombatDialog(currentPlayer, enemyPlayer, pos, m_mapWidget, this);
                 combatDialog->exec();
                 combatDialog->deleteLater();  // Use deleteLater() to avoid heap corruption
+                recordCheckpoint("Combat", false, true);
             }
         }
 
@@ -1969,11 +1925,64 @@ void PlayerInfoWidget::onEndTurnClicked()
         // (Fall through to the code below)
     }
 
+    // The taxes get a replay step of their own so the verifier can re-execute them; this
+    // one before them holds the combats and anything else done since the last record
+    recordCheckpoint(combatTerritories.isEmpty() ? "Before Taxes" : "Combats", true, false);
+
     // Collect taxes from owned territories before ending turn
     int taxesCollected = currentPlayer->collectTaxes(m_mapWidget);
     qDebug() << "Player" << currentPlayer->getId() << "collected" << taxesCollected << "talents in taxes";
 
+    // Not journalled: a game recovered between here and End Turn would collect them again
+    ReplayCommand taxes;
+    taxes.kind = ReplayCommand::Kind::Taxes;
+    taxes.player = currentPlayerIndex;
+    recordCheckpoint("Taxes", true, false, taxes);
+
     // FIRST: Allow player to destroy their own cities (before purchase phase)
+    if (!currentPlayer->isComputerControlled()) {
+        showCityDestructionDialog(currentPlayer);
+    }
+
+    // SECOND: Purchases (the computer buys with MctsPlayer's heuristic instead of the dialog)
+    if (currentPlayer->isComputerControlled()) {
+        applyPurchase(currentPlayer, computerPurchase(currentPlayerIndex));
+    } else {
+        showPurchaseDialog(currentPlayer);
+    }
+
+    // End current player's turn
+    currentPlayer->endTurn();
+
+    // Start next player's turn (wrap around to first player after last)
+    int nextPlayerIndex = (currentPlayerIndex + 1) % m_players.size();
+    m_players[nextPlayerIndex]->startTurn();
+
+    // Update all player displays
+    updateAllPlayers();
+
+    // Switch to next player's tab
+    m_tabWidget->setCurrentIndex(nextPlayerIndex);
+
+    // Trigger map redraw and update turn tracking
+    if (m_mapWidget) {
+        m_mapWidget->setCurrentPlayerIndex(nextPlayerIndex);
+        m_mapWidget->setAtStartOfTurn(true);  // New turn is starting
+        m_mapWidget->update();
+    }
+
+    // Update captured generals table
+    updateCapturedGeneralsTable();
+
+    // Combats, taxes and purchases undo together with the turn they ended
+    recordHistory("End Turn");
+
+    // Hand over to the computer if it plays the next player
+    scheduleComputerTurn();
+}
+
+void PlayerInfoWidget::showCityDestructionDialog(Player *currentPlayer)
+{
     CityDestructionDialog *destructionDialog = new CityDestructionDialog(
         currentPlayer->getId(),
         currentPlayer->getCities(),
@@ -1990,36 +1999,15 @@ void PlayerInfoWidget::onEndTurnClicked()
                 qDebug() << "  Destroying city at" << city->getTerritoryName()
                          << "(" << city->getPosition().row << "," << city->getPosition().col << ")";
 
-                QString territoryName = city->getTerritoryName();
                 Position cityPosition = city->getPosition();
 
-                // Find and remove all roads connected to this city's territory
-                QList<Road*> roadsAtTerritory = currentPlayer->getRoadsAtTerritory(territoryName);
-                for (Road *road : roadsAtTerritory) {
-                    qDebug() << "    Destroying road at" << road->getTerritoryName();
-                    currentPlayer->removeRoad(road);
-                    delete road;
-                }
-
-                // Also check for roads that have this position as either endpoint
-                QList<Road*> allRoads = currentPlayer->getRoads();
-                for (Road *road : allRoads) {
-                    if (road->getFromPosition() == cityPosition || road->getToPosition() == cityPosition) {
-                        qDebug() << "    Destroying connected road from"
-                                 << road->getFromPosition().row << "," << road->getFromPosition().col
-                                 << " to " << road->getToPosition().row << "," << road->getToPosition().col;
-                        currentPlayer->removeRoad(road);
-                        delete road;
-                    }
-                }
-
                 // Remove city and fortification from MapWidget grids
                 if (m_mapWidget) {
                     m_mapWidget->removeCityAt(cityPosition.row, cityPosition.col);
                     m_mapWidget->removeFortificationAt(cityPosition.row, cityPosition.col);
                 }
 
-                // Remove city from player's inventory
+                // Remove city from player's inventory (the map drops the roads it anchored)
                 currentPlayer->removeCity(city);
 
                 // Delete the city object
@@ -2035,30 +2023,22 @@ void PlayerInfoWidget::onEndTurnClicked()
     }
 
     delete destructionDialog;
+}
 
-    // SECOND: Build options for PurchaseDialog2
+void PlayerInfoWidget::showPurchaseDialog(Player *currentPlayer)
+{
+    // Build options for PurchaseDialog2
     Position homePosition = currentPlayer->getHomeProvince();
 
     // Build list of territories available for city placement
     QList<CityPlacementOption> cityOptions;
-    const QList<QString> &ownedTerritories = currentPlayer->getOwnedTerritories();
-    for (const QString &territoryName : ownedTerritories) {
+    for (TerritoryId territory : currentPlayer->getOwnedTerritoryIds()) {
         // Check if this territory already has a city
-        QList<City*> citiesInTerritory = currentPlayer->getCitiesAtTerritory(territoryName);
-        if (citiesInTerritory.isEmpty()) {
-            // Find position for this territory
-            for (int row = 0; row < 8; ++row) {
-                for (int col = 0; col < 12; ++col) {
-                    if (m_mapWidget->getTerritoryNameAt(row, col) == territoryName) {
-                        CityPlacementOption option;
-                        option.territoryName = territoryName;
-                        option.position = {row, col};
-                        cityOptions.append(option);
-                        goto next_territory;  // Break out of nested loops
-                    }
-                }
-            }
-            next_territory:;
+        if (!currentPlayer->getCityAtTerritory(territory)) {
+            CityPlacementOption option;
+            option.territoryName = TerritoryNames::nameOf(territory);
+            option.position = territoryPosition(territory);
+            cityOptions.append(option);
         }
     }
 
@@ -2108,17 +2088,11 @@ void PlayerInfoWidget::onEndTurnClicked()
         totalGalleys += player->getGalleys().size();
     }
 
-    // Define total pieces available in the physical game (1984 Milton Bradley edition)
-    const int TOTAL_INFANTRY_PIECES = 60;    // Silver/generic infantry units
-    const int TOTAL_CAVALRY_PIECES = 30;     // Gold cavalry units
-    const int TOTAL_CATAPULT_PIECES = 20;    // Catapult pieces
-    const int TOTAL_GALLEY_PIECES = 36;      // Galley/ship pieces
-
-    // Calculate available pieces
-    int availableInfantry = qMax(0, TOTAL_INFANTRY_PIECES - totalInfantry);
-    int availableCavalry = qMax(0, TOTAL_CAVALRY_PIECES - totalCavalry);
-    int availableCatapults = qMax(0, TOTAL_CATAPULT_PIECES - totalCatapults);
-    int availableGalleys = qMax(0, TOTAL_GALLEY_PIECES - totalGalleys);
+    // Calculate available pieces (limits of the 1984 Milton Bradley edition)
+    int availableInfantry = qMax(0, RulesEngine::TOTAL_INFANTRY_PIECES - totalInfantry);
+    int availableCavalry = qMax(0, RulesEngine::TOTAL_CAVALRY_PIECES - totalCavalry);
+    int availableCatapults = qMax(0, RulesEngine::TOTAL_CATAPULT_PIECES - totalCatapults);
+    int availableGalleys = qMax(0, RulesEngine::TOTAL_GALLEY_PIECES - totalGalleys);
 
     // Open purchase dialog
     PurchaseDialog *purchaseDialog = new PurchaseDialog(
@@ -2137,115 +2111,386 @@ void PlayerInfoWidget::onEndTurnClicked()
     );
 
     if (purchaseDialog->exec() == QDialog::Accepted) {
-        // Get purchase result
-        PurchaseResult result = purchaseDialog->getPurchaseResult();
-
-        // Deduct money from player's wallet
-        if (result.totalCost > 0) {
-            currentPlayer->spendMoney(result.totalCost);
-            qDebug() << "Player" << currentPlayer->getId() << "spent" << result.totalCost << "talents";
-        }
-
-        // Create purchased cities
-        for (const PurchaseResult::CityPurchase &cityPurchase : result.cities) {
-            City *newCity = new City(
-                currentPlayer->getId(),
-                cityPurchase.position,
-                cityPurchase.territoryName,
-                cityPurchase.fortified,
-                currentPlayer
-            );
-            currentPlayer->addCity(newCity);
-
-            if (cityPurchase.fortified) {
-                qDebug() << "Player" << currentPlayer->getId() << "placed fortified city at" << cityPurchase.territoryName;
-            } else {
-                qDebug() << "Player" << currentPlayer->getId() << "placed city at" << cityPurchase.territoryName;
-            }
+        applyPurchase(currentPlayer, purchaseDialog->getPurchaseResult());
+    }
+
+    delete purchaseDialog;
+}
+
+void PlayerInfoWidget::applyPurchase(Player *currentPlayer, const PurchaseResult &result)
+{
+    // Deduct money from player's wallet
+    if (result.totalCost > 0) {
+        currentPlayer->spendMoney(result.totalCost);
+        qDebug() << "Player" << currentPlayer->getId() << "spent" << result.totalCost << "talents";
+    }
+
+    // Create purchased cities
+    for (const PurchaseResult::CityPurchase &cityPurchase : result.cities) {
+        City *newCity = new City(
+            currentPlayer->getId(),
+            cityPurchase.position,
+            cityPurchase.territoryName,
+            cityPurchase.fortified,
+            currentPlayer
+        );
+        currentPlayer->addCity(newCity);
+
+        if (cityPurchase.fortified) {
+            qDebug() << "Player" << currentPlayer->getId() << "placed fortified city at" << cityPurchase.territoryName;
+        } else {
+            qDebug() << "Player" << currentPlayer->getId() << "placed city at" << cityPurchase.territoryName;
         }
+    }
 
-        // Add fortifications to existing cities
-        for (const QString &territoryName : result.fortifications) {
-            // Find the city and add fortification
-            const QList<City*> &playerCities = currentPlayer->getCities();
-            for (City *city : playerCities) {
-                if (city->getTerritoryName() == territoryName && !city->isFortified()) {
-                    city->addFortification();
-                    qDebug() << "Player" << currentPlayer->getId() << "fortified city at" << territoryName;
-                    break;
-                }
+    // Add fortifications to existing cities
+    for (const QString &territoryName : result.fortifications) {
+        // Find the city and add fortification
+        TerritoryId territory = TerritoryNames::idOf(territoryName);
+        const QList<City*> &playerCities = currentPlayer->getCities();
+        for (City *city : playerCities) {
+            if (city->getTerritoryId() == territory && !city->isFortified()) {
+                city->addFortification();
+                qDebug() << "Player" << currentPlayer->getId() << "fortified city at" << territoryName;
+                break;
             }
         }
+    }
 
-        // Create military units at home province
-        QString homeProvince = currentPlayer->getHomeProvinceName();
-        Position homePosForTroops = currentPlayer->getHomeProvince();
+    // Create military units at home province
+    QString homeProvince = currentPlayer->getHomeProvinceName();
+    Position homePosForTroops = currentPlayer->getHomeProvince();
 
-        // Create infantry
-        for (int i = 0; i < result.infantry; ++i) {
-            InfantryPiece *infantry = new InfantryPiece(currentPlayer->getId(), homePosForTroops, currentPlayer);
-            currentPlayer->addInfantry(infantry);
-        }
-        if (result.infantry > 0) {
-            qDebug() << "Player" << currentPlayer->getId() << "created" << result.infantry << "infantry at" << homeProvince;
-        }
+    // Create infantry
+    for (int i = 0; i < result.infantry; ++i) {
+        InfantryPiece *infantry = new InfantryPiece(currentPlayer->getId(), homePosForTroops, currentPlayer);
+        currentPlayer->addInfantry(infantry);
+    }
+    if (result.infantry > 0) {
+        qDebug() << "Player" << currentPlayer->getId() << "created" << result.infantry << "infantry at" << homeProvince;
+    }
 
-        // Create cavalry
-        for (int i = 0; i < result.cavalry; ++i) {
-            CavalryPiece *cavalry = new CavalryPiece(currentPlayer->getId(), homePosForTroops, currentPlayer);
-            currentPlayer->addCavalry(cavalry);
-        }
-        if (result.cavalry > 0) {
-            qDebug() << "Player" << currentPlayer->getId() << "created" << result.cavalry << "cavalry at" << homeProvince;
-        }
+    // Create cavalry
+    for (int i = 0; i < result.cavalry; ++i) {
+        CavalryPiece *cavalry = new CavalryPiece(currentPlayer->getId(), homePosForTroops, currentPlayer);
+        currentPlayer->addCavalry(cavalry);
+    }
+    if (result.cavalry > 0) {
+        qDebug() << "Player" << currentPlayer->getId() << "created" << result.cavalry << "cavalry at" << homeProvince;
+    }
 
-        // Create catapults
-        for (int i = 0; i < result.catapults; ++i) {
-            CatapultPiece *catapult = new CatapultPiece(currentPlayer->getId(), homePosForTroops, currentPlayer);
-            currentPlayer->addCatapult(catapult);
+    // Create catapults
+    for (int i = 0; i < result.catapults; ++i) {
+        CatapultPiece *catapult = new CatapultPiece(currentPlayer->getId(), homePosForTroops, currentPlayer);
+        currentPlayer->addCatapult(catapult);
+    }
+    if (result.catapults > 0) {
+        qDebug() << "Player" << currentPlayer->getId() << "created" << result.catapults << "catapults at" << homeProvince;
+    }
+
+    // Create galleys at specified sea borders
+    for (const PurchaseResult::GalleyPurchase &galleyPurchase : result.galleys) {
+        // Create the galleys at home position (they're on the border with the sea)
+        for (int i = 0; i < galleyPurchase.count; ++i) {
+            GalleyPiece *galley = new GalleyPiece(currentPlayer->getId(), homePosForTroops, currentPlayer);
+            currentPlayer->addGalley(galley);
         }
-        if (result.catapults > 0) {
-            qDebug() << "Player" << currentPlayer->getId() << "created" << result.catapults << "catapults at" << homeProvince;
+
+        QString seaTerritoryName = m_mapWidget->getTerritoryNameAt(galleyPurchase.seaBorder.row, galleyPurchase.seaBorder.col);
+        qDebug() << "Player" << currentPlayer->getId() << "created" << galleyPurchase.count
+                 << "galleys at" << homeProvince << "bordering sea territory" << seaTerritoryName;
+    }
+
+    recordCheckpoint("Purchase", true, true);
+}
+
+PurchaseResult PlayerInfoWidget::computerPurchase(int playerIndex) const
+{
+    GameState state = GameStateBridge::capture(m_mapWidget, m_players, playerIndex);
+    RulesEngine::PurchaseOrder order = MctsPlayer::choosePurchase(state, playerIndex);
+
+    PurchaseResult result;
+    result.infantry = order.infantry;
+    result.cavalry = order.cavalry;
+    result.catapults = order.catapults;
+    for (const std::vector<int> *tiles : {&order.cities, &order.fortifiedCities}) {
+        for (int tile : *tiles) {
+            PurchaseResult::CityPurchase city;
+            city.territoryName = TerritoryNames::nameOf(tile);
+            city.position = GameStateBridge::toPosition(tile);
+            city.fortified = (tiles == &order.fortifiedCities);
+            result.cities.append(city);
+        }
+    }
+    for (int tile : order.fortifications) {
+        result.fortifications.append(TerritoryNames::nameOf(tile));
+    }
+    result.totalCost = RulesEngine::purchaseCost(order, state.inflationMultiplier);
+    return result;
+}
+
+// ========== Undo History ==========
+
+int PlayerInfoWidget::currentPlayerIndex() const
+{
+    for (int i = 0; i < m_players.size(); ++i) {
+        if (m_players[i]->isMyTurn()) {
+            return i;
         }
+    }
+    return 0;
+}
 
-        // Create galleys at specified sea borders
-        for (const PurchaseResult::GalleyPurchase &galleyPurchase : result.galleys) {
-            // Create the galleys at home position (they're on the border with the sea)
-            for (int i = 0; i < galleyPurchase.count; ++i) {
-                GalleyPiece *galley = new GalleyPiece(currentPlayer->getId(), homePosForTroops, currentPlayer);
-                currentPlayer->addGalley(galley);
-            }
+void PlayerInfoWidget::resetHistory()
+{
+    if (!m_mapWidget) return;
+
+    GameState state = GameStateBridge::capture(m_mapWidget, m_players, currentPlayerIndex());
+    m_history.reset(state, GameRandom::current().saveState());
+    updateUndoRedoState();
+
+    std::vector<bool> computer;
+    for (Player *player : m_players) {
+        computer.push_back(player->isComputerControlled());
+    }
+    m_replay.start(state, computer, m_mapWidget->isAtStartOfTurn());
+    if (m_journal) {
+        m_journal->start(state, computer, m_mapWidget->isAtStartOfTurn());
+    }
+}
+
+void PlayerInfoWidget::recordHistory(const QString &label)
+{
+    if (!m_mapWidget) return;
+
+    // The command is the difference from the last recorded state, so anything changed
+    // since then without a record of its own is undone along with this action
+    GameState state = GameStateBridge::capture(m_mapWidget, m_players, currentPlayerIndex());
+    m_mapWidget->verifyGameHash(state);
+    if (m_history.record(state, label.toStdString(), GameRandom::current().saveState())) {
+        updateUndoRedoState();
 
-            QString seaTerritoryName = m_mapWidget->getTerritoryNameAt(galleyPurchase.seaBorder.row, galleyPurchase.seaBorder.col);
-            qDebug() << "Player" << currentPlayer->getId() << "created" << galleyPurchase.count
-                     << "galleys at" << homeProvince << "bordering sea territory" << seaTerritoryName;
+        // Queued for the journal's writer thread; nothing here touches the disk
+        m_replay.record(state, label.toStdString(), m_mapWidget->isAtStartOfTurn());
+        if (m_journal) {
+            m_journal->record(state, label.toStdString(), m_mapWidget->isAtStartOfTurn());
         }
     }
+}
 
-    delete purchaseDialog;
+// Combats, taxes and purchases undo with the turn they ended, so they have no history
+// entry of their own. The replay still gets the taxes as an engine call to re-execute,
+// and the journal gets each combat and the purchase: a crash in the next combat or in
+// the purchase dialog mustn't lose the dice already rolled. The End Turn record that
+// follows holds only what changed after the last of them
+void PlayerInfoWidget::recordCheckpoint(const QString &label, bool replay, bool journal, const ReplayCommand &command)
+{
+    if (!m_mapWidget || (!replay && !(journal && m_journal))) return;
 
-    // End current player's turn
-    currentPlayer->endTurn();
+    GameState state = GameStateBridge::capture(m_mapWidget, m_players, currentPlayerIndex());
+    if (replay) {
+        m_replay.record(state, label.toStdString(), m_mapWidget->isAtStartOfTurn(), command);
+    }
+    if (journal && m_journal) {
+        m_journal->record(state, label.toStdString(), m_mapWidget->isAtStartOfTurn());
+    }
+}
 
-    // Start next player's turn (wrap around to first player after last)
-    int nextPlayerIndex = (currentPlayerIndex + 1) % m_players.size();
-    m_players[nextPlayerIndex]->startTurn();
+void PlayerInfoWidget::updateUndoRedoState()
+{
+    if (!m_mapWidget) return;
 
-    // Update all player displays
+    m_mapWidget->setUndoRedoState(m_history.canUndo(), QString::fromStdString(m_history.undoLabel()),
+                                  m_history.canRedo(), QString::fromStdString(m_history.redoLabel()));
+}
+
+void PlayerInfoWidget::undo()
+{
+    if (!m_mapWidget || m_computerTurnRunning || !m_history.canUndo()) return;
+
+    // Back past the computer's moves to the last position a person played from
+    int step = m_history.position() - 1;
+    while (step > 0 && m_players[m_history.seek(step).currentPlayer]->isComputerControlled()) {
+        --step;
+    }
+    GameStateBridge::restore(m_mapWidget, m_players, m_history.seek(step));
+
+    // The dice go back too, so ending an undone turn again rolls the same combats
+    GameRandom &random = GameRandom::current();
+    random.restoreState(random.seed(), m_history.random());
+
+    int current = m_history.current().currentPlayer;
+    m_mapWidget->setAtStartOfTurn(step == 0 || m_history.label(step - 1) == "End Turn");
+    m_replay.record(m_history.current(), "Undo", m_mapWidget->isAtStartOfTurn());
+    if (m_journal) {
+        m_journal->record(m_history.current(), "Undo", m_mapWidget->isAtStartOfTurn());
+    }
     updateAllPlayers();
+    updateCapturedGeneralsTable();
+    m_tabWidget->setCurrentIndex(current);
+    updateUndoRedoState();
 
-    // Switch to next player's tab
-    m_tabWidget->setCurrentIndex(nextPlayerIndex);
+    // Only when undone back to a computer player's opening turn
+    scheduleComputerTurn();
+}
 
-    // Trigger map redraw and update turn tracking
-    if (m_mapWidget) {
-        m_mapWidget->setCurrentPlayerIndex(nextPlayerIndex);
-        m_mapWidget->setAtStartOfTurn(true);  // New turn is starting
-        m_mapWidget->update();
+void PlayerInfoWidget::redo()
+{
+    if (!m_mapWidget || m_computerTurnRunning || !m_history.canRedo()) return;
+
+    int step = m_history.position() + 1;
+    while (step < m_history.size() && m_players[m_history.seek(step).currentPlayer]->isComputerControlled()) {
+        ++step;
     }
+    GameStateBridge::restore(m_mapWidget, m_players, m_history.seek(step));
+    GameRandom &random = GameRandom::current();
+    random.restoreState(random.seed(), m_history.random());
 
-    // Update captured generals table
+    int current = m_history.current().currentPlayer;
+    m_mapWidget->setAtStartOfTurn(m_history.label(step - 1) == "End Turn");
+    m_replay.record(m_history.current(), "Redo", m_mapWidget->isAtStartOfTurn());
+    if (m_journal) {
+        m_journal->record(m_history.current(), "Redo", m_mapWidget->isAtStartOfTurn());
+    }
+    updateAllPlayers();
     updateCapturedGeneralsTable();
+    m_tabWidget->setCurrentIndex(current);
+    updateUndoRedoState();
+
+    // Redone up to a computer turn nobody has played yet
+    scheduleComputerTurn();
+}
+
+void PlayerInfoWidget::saveReplay()
+{
+    if (m_replay.isEmpty()) {
+        return;
+    }
+
+    // Replays go where saves go
+    QSettings settings("ConquestOfTheEmpire", "MapWidget");
+    QString lastDir = settings.value("lastSaveDirectory",
+                                     QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).toString();
+
+    QString fileName = QFileDialog::getSaveFileName(this, "Save Replay", lastDir,
+                                                    QString("Replays (*.%1)").arg(GameReplay::FILE_EXTENSION));
+    if (fileName.isEmpty()) {
+        return;
+    }
+    settings.setValue("lastSaveDirectory", QFileInfo(fileName).absolutePath());
+
+    if (m_replay.save(fileName.toStdString())) {
+        QMessageBox::information(this, "Replay Saved",
+                                 QString("Replay of %1 actions saved to:\n%2").arg(m_replay.steps() - 1).arg(fileName));
+    } else {
+        QMessageBox::critical(this, "Save Failed", QString("Failed to save replay to:\n%1").arg(fileName));
+    }
+}
+
+// ========== Computer Players ==========
+
+void PlayerInfoWidget::scheduleComputerTurn()
+{
+    for (Player *player : m_players) {
+        if (player->isMyTurn() && player->isComputerControlled()) {
+            // Let the previous turn's dialogs and repaints finish first
+            QTimer::singleShot(0, this, &PlayerInfoWidget::playComputerTurn);
+            return;
+        }
+    }
+}
+
+void PlayerInfoWidget::playComputerTurn()
+{
+    if (!m_mapWidget || m_computerTurnRunning) return;
+
+    Player *currentPlayer = nullptr;
+    int currentPlayerIndex = -1;
+    for (int i = 0; i < m_players.size(); ++i) {
+        if (m_players[i]->isMyTurn()) {
+            currentPlayer = m_players[i];
+            currentPlayerIndex = i;
+            break;
+        }
+    }
+    if (!currentPlayer || !currentPlayer->isComputerControlled()) return;
+
+    m_computerTurnRunning = true;
+    setEnabled(false);
+    m_mapWidget->setEnabled(false);
+
+    // Search on the thread pool while the windows keep painting
+    GameState state = GameStateBridge::capture(m_mapWidget, m_players, currentPlayerIndex);
+    MctsPlayer::Settings settings;
+    settings.galleys = false;  // Galleys can't be moved from the UI yet
+    MctsPlayer computer(settings);
+    std::future<MctsPlayer::TurnPlan> planning = std::async(std::launch::async, [&computer, &state, currentPlayerIndex]() {
+        return computer.planMovement(state, currentPlayerIndex);
+    });
+    while (planning.wait_for(std::chrono::milliseconds(20)) != std::future_status::ready) {
+        QApplication::processEvents();
+    }
+    MctsPlayer::TurnPlan plan = planning.get();
+    qDebug() << "Computer player" << currentPlayer->getId() << "planned" << plan.moves.size()
+             << "moves from" << plan.iterations << "playouts";
+
+    // Leaders by id
+    QHash<int, GamePiece*> leaders;
+    for (CaesarPiece *caesar : currentPlayer->getCaesars()) {
+        leaders[caesar->getUniqueId()] = caesar;
+    }
+    for (GeneralPiece *general : currentPlayer->getGenerals()) {
+        leaders[general->getUniqueId()] = general;
+    }
+
+    // Mirror the plan on the captured state so each move takes exactly the troops the engine moved,
+    // and give every leader the legion the engine formed
+    for (const std::pair<int, int> &assignment : plan.legions) {
+        RulesEngine::assignToLegion(state, currentPlayerIndex, assignment.first, assignment.second);
+    }
+    QHash<int, QList<int>> legions;
+    for (const PieceState &piece : *state.players[currentPlayerIndex].pieces) {
+        if (piece.leaderId != 0) {
+            legions[piece.leaderId].append(piece.id);
+        }
+    }
+    for (GamePiece *leader : leaders) {
+        if (leader->getType() == GamePiece::Type::Caesar) {
+            static_cast<CaesarPiece*>(leader)->setLegion(legions.value(leader->getUniqueId()));
+        } else {
+            static_cast<GeneralPiece*>(leader)->setLegion(legions.value(leader->getUniqueId()));
+        }
+    }
+
+    // Play the moves through the same path as the context menus
+    for (const Move &move : plan.moves) {
+        GamePiece *leader = leaders.value(move.pieceId, nullptr);
+        if (!leader || (move.kind != Move::Kind::LeaderStep && move.kind != Move::Kind::LeaderRoad)) {
+            break;
+        }
+
+        QList<int> troopIds;
+        for (const PieceState &piece : *state.players[currentPlayerIndex].pieces) {
+            if (piece.leaderId == move.pieceId && piece.tile == move.fromTile && piece.movesRemaining > 0) {
+                troopIds.append(piece.id);
+            }
+        }
+        executeLeaderMove(leader, GameStateBridge::toPosition(move.toTile), troopIds,
+                          move.kind == Move::Kind::LeaderRoad);
+        MoveGenerator::apply(state, currentPlayerIndex, move);
+
+        // Pause so the moves can be followed on the map
+        QEventLoop pause;
+        QTimer::singleShot(COMPUTER_MOVE_DELAY_MS, &pause, &QEventLoop::quit);
+        pause.exec();
+    }
+
+    setEnabled(true);
+    m_mapWidget->setEnabled(true);
+    m_computerTurnRunning = false;
+
+    // Combats, taxes and purchases (the dialogs play the computer's side)
+    onEndTurnClicked();
 }
 
 QGroupBox* PlayerInfoWidget::createAllCapturedGeneralsSection()
@@ -2471,6 +2716,9 @@ void PlayerInfoWidget::showCapturedGeneralContextMenu(GeneralPiece *general, con
                         general->setPosition(homePos);
                         QString homeTerritoryName = m_mapWidget->getTerritoryNameAt(homePos.row, homePos.col);
                         general->setTerritoryName(homeTerritoryName);
+                        if (!player->getGenerals().contains(general)) {
+                            player->addGeneral(general);
+                        }
 
                         QMessageBox::information(this, "General Ransomed",
                             QString("General %1 #%2 has been ransomed back to Player %3 for %4 talents.\n\n"
@@ -2506,6 +2754,7 @@ void PlayerInfoWidget::showCapturedGeneralContextMenu(GeneralPiece *general, con
                     if (m_mapWidget) {
                         m_mapWidget->update();
                     }
+                    recordHistory("Ransom General");
                 });
             }
         }
@@ -2514,29 +2763,22 @@ void PlayerInfoWidget::showCapturedGeneralContextMenu(GeneralPiece *general, con
         QAction *killAction = menu.addAction("Kill General");
         connect(killAction, &QAction::triggered, [this, general, currentPlayer]() {
             QMessageBox::StandardButton reply = QMessageBox::question(this, "Kill General?",
-                QString("Are you sure you want to kill General %1 #%2?\n\nThis action cannot be undone.")
+                QString("Are you sure you want to kill General %1 #%2?")
                 .arg(general->getPlayer())
                 .arg(general->getNumber()),
                 QMessageBox::Yes | QMessageBox::No);
 
             if (reply == QMessageBox::Yes) {
-                // Remove from captured list
+                // Prisoners are only in their captor's list
                 currentPlayer->removeCapturedGeneral(general);
 
-                // Find original player and remove from their list
-                for (Player *player : m_players) {
-                    if (player->getId() == general->getPlayer()) {
-                        player->removeGeneral(general);
-                        break;
-                    }
-                }
-
                 // Delete the general
                 general->deleteLater();
 
                 // Update displays
                 updateAllPlayers();
                 updateCapturedGeneralsTable();
+                recordHistory("Kill General");
 
                 QMessageBox::information(this, "General Killed",
                     QString("General %1 #%2 has been executed.")
@@ -2627,6 +2869,9 @@ void PlayerInfoWidget::showCapturedGeneralContextMenu(GeneralPiece *general, con
             general->setPosition(homePos);
             QString homeTerritoryName = m_mapWidget->getTerritoryNameAt(homePos.row, homePos.col);
             general->setTerritoryName(homeTerritoryName);
+            if (!currentPlayer->getGenerals().contains(general)) {
+                currentPlayer->addGeneral(general);
+            }
 
             QMessageBox::information(this, "General Ransomed",
                 QString("General %1 #%2 has been ransomed back to you for %3 talents.\n\n"
@@ -2641,6 +2886,7 @@ void PlayerInfoWidget::showCapturedGeneralContextMenu(GeneralPiece *general, con
             if (m_mapWidget) {
                 m_mapWidget->update();
             }
+            recordHistory("Ransom General");
         });
     }
 
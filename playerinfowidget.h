@@ -10,6 +10,12 @@
 #include <QGroupBox>
 #include "player.h"
 #include "mapwidget.h"
+#include "gamehistory.h"
+#include "gamereplay.h"
+
+class GameJournal;
+
+struct PurchaseResult;
 
 class PlayerInfoWidget : public QWidget
 {
@@ -30,6 +36,23 @@ public:
     void updatePlayerInfo(Player *player);
     void updateAllPlayers();
 
+    // Play the current player's turn later from the event loop if the computer controls it
+    void scheduleComputerTurn();
+
+    // Autosave every recorded action to this journal for crash recovery (not owned)
+    void setJournal(GameJournal *journal) { m_journal = journal; }
+
+    // Start the undo history, the journal and the replay from the current position (new or loaded game)
+    void resetHistory();
+
+public slots:
+    // Step back or forward through the history, skipping the computer's actions
+    void undo();
+    void redo();
+
+    // Write everything since the game started or was loaded as a replay file
+    void saveReplay();
+
 signals:
     void pieceMoved(int fromRow, int fromCol, int toRow, int toCol);
 
@@ -38,8 +61,12 @@ protected:
 
 private slots:
     void onEndTurnClicked();
+    void playComputerTurn();
 
 private:
+    // Pause between the computer's moves so they can be followed on the map
+    static constexpr int COMPUTER_MOVE_DELAY_MS = 400;
+
     // Create a tab for a single player
     QWidget* createPlayerTab(Player *player);
 
@@ -67,6 +94,15 @@ private:
     // Leader movement via road (only costs 1 movement point)
     void moveLeaderViaRoad(GamePiece *leader, const Position &destination);
 
+    // Move a leader and the given troops once the move is confirmed (shared by people and the computer)
+    void executeLeaderMove(GamePiece *leader, const Position &destination, const QList<int> &troopIds, bool viaRoad);
+
+    // End of turn phases
+    void showCityDestructionDialog(Player *currentPlayer);
+    void showPurchaseDialog(Player *currentPlayer);
+    void applyPurchase(Player *currentPlayer, const PurchaseResult &result);
+    PurchaseResult computerPurchase(int playerIndex) const;
+
     // Helper to get territory name at position
     QString getTerritoryNameAt(int row, int col) const;
 
@@ -76,6 +112,12 @@ private:
     // Create icon for territory (shows ownership color and combat indicator)
     QIcon createTerritoryIcon(int row, int col, QChar currentPlayer) const;
 
+    // Undo history
+    int currentPlayerIndex() const;
+    void recordHistory(const QString &label);
+    void recordCheckpoint(const QString &label, bool replay, bool journal, const ReplayCommand &command = ReplayCommand());
+    void updateUndoRedoState();
+
     // Save/load window geometry
     void saveSettings();
     void loadSettings();
@@ -88,6 +130,12 @@ private:
     // Global captured generals section
     QGroupBox *m_capturedGeneralsGroupBox;
     QTableWidget *m_capturedGeneralsTable;
+
+    bool m_computerTurnRunning;  // playComputerTurn is planning or moving
+
+    GameHistory m_history;       // Every recorded action since the game started or was loaded
+    GameJournal *m_journal;      // Crash-recovery autosave, may be null
+    GameReplay m_replay;         // The game so far, for File > Save Replay
 };
 
 #endif // PLAYERINFOWIDGET_H
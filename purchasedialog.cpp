@@ -44,7 +44,7 @@ PurchaseDialog::PurchaseDialog(QChar player,
 
 int PurchaseDialog::getCurrentPrice(int basePrice) const
 {
-    return basePrice * m_inflationMultiplier;
+    return RulesEngine::price(basePrice, m_inflationMultiplier);
 }
 
 void PurchaseDialog::setupUI()
@@ -9,6 +9,7 @@
 #include <QMap>
 #include <QString>
 #include "common.h"
+#include "rulesengine.h"
 
 // Structure to hold information about territories available for city placement
 struct CityPlacementOption {
@@ -98,14 +99,14 @@ private:
     int m_availableCatapults;
     int m_availableGalleys;
 
-    // Base prices
-    static const int MAX_GALLEYS = 6;
-    static const int INFANTRY_BASE_COST = 10;
-    static const int CAVALRY_BASE_COST = 20;
-    static const int CATAPULT_BASE_COST = 30;
-    static const int GALLEY_BASE_COST = 20;
-    static const int CITY_BASE_COST = 30;
-    static const int FORTIFICATION_BASE_COST = 20;
+    // Base prices (shared with the rules engine)
+    static const int MAX_GALLEYS = RulesEngine::MAX_GALLEYS_PER_PLAYER;
+    static const int INFANTRY_BASE_COST = RulesEngine::INFANTRY_BASE_COST;
+    static const int CAVALRY_BASE_COST = RulesEngine::CAVALRY_BASE_COST;
+    static const int CATAPULT_BASE_COST = RulesEngine::CATAPULT_BASE_COST;
+    static const int GALLEY_BASE_COST = RulesEngine::GALLEY_BASE_COST;
+    static const int CITY_BASE_COST = RulesEngine::CITY_BASE_COST;
+    static const int FORTIFICATION_BASE_COST = RulesEngine::FORTIFICATION_BASE_COST;
 
     // Input data
     QList<CityPlacementOption> m_cityOptions;
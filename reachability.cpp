@@ -0,0 +1,49 @@
+#include "reachability.h"
+
+ReachabilityTable::ReachabilityTable()
+{
+    // Board adjacency never changes; terrain-dependent tables start as an all-sea map
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        int row = tileRow(tile);
+        int col = tileColumn(tile);
+        const int steps[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for (const auto &step : steps) {
+            if (isOnBoard(row + step[0], col + step[1])) {
+                m_neighbours[tile].set(tileIndex(row + step[0], col + step[1]));
+            }
+        }
+    }
+    rebuild(TileMask());
+}
+
+void ReachabilityTable::rebuild(const TileMask &land)
+{
+    m_land = land;
+    TileMask sea = ~land;
+
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        m_landStep[tile] = m_neighbours[tile] & land;
+        m_seaStep[tile] = land.test(tile) ? m_neighbours[tile] & sea : m_neighbours[tile];
+    }
+
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        // Second land step through any land neighbour; this covers straight lines and
+        // both L-shaped paths of a diagonal
+        TileMask reach = m_landStep[tile];
+        if (land.test(tile)) {
+            reach.set(tile);
+        }
+        m_landStep[tile].forEach([this, &reach](int step) {
+            reach |= m_landStep[step];
+        });
+        m_landReach[tile] = reach;
+
+        // A galley keeps sailing only from sea tiles
+        TileMask sail = m_seaStep[tile];
+        (m_seaStep[tile] & sea).forEach([this, &sail](int step) {
+            sail |= m_seaStep[step];
+        });
+        sail.reset(tile);
+        m_seaReach[tile] = sail;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef REACHABILITY_H
+#define REACHABILITY_H
+
+#include <array>
+#include "tilemask.h"
+
+// Per-map movement tables: for every tile, the tiles a piece can reach as a
+// TileMask. Built once from the land/sea layout and rebuilt only when the
+// terrain changes, so legal-destination queries are a table lookup instead of
+// re-deriving distances and intermediate terrain on every call.
+class ReachabilityTable
+{
+public:
+    ReachabilityTable();
+
+    void rebuild(const TileMask &land);
+
+    const TileMask& land() const { return m_land; }
+    bool isLand(int tile) const { return m_land.test(tile); }
+
+    // Orthogonal neighbours on the board, whatever the terrain
+    const TileMask& neighbours(int tile) const { return m_neighbours[tile]; }
+
+    // Land tiles one step away (leader moves)
+    const TileMask& landStep(int tile) const { return m_landStep[tile]; }
+
+    // Land tiles within two steps over land, including the tile itself when it is land
+    // (the RulesEngine::isValidLandMove rule)
+    const TileMask& landReach(int tile) const { return m_landReach[tile]; }
+
+    // One galley move: onto an adjacent sea tile, or ashore when already at sea
+    const TileMask& seaStep(int tile) const { return m_seaStep[tile]; }
+
+    // Two galley moves (a galley that lands stops there)
+    const TileMask& seaReach(int tile) const { return m_seaReach[tile]; }
+
+private:
+    TileMask m_land;
+    std::array<TileMask, BOARD_TILES> m_neighbours;
+    std::array<TileMask, BOARD_TILES> m_landStep;
+    std::array<TileMask, BOARD_TILES> m_landReach;
+    std::array<TileMask, BOARD_TILES> m_seaStep;
+    std::array<TileMask, BOARD_TILES> m_seaReach;
+};
+
+#endif // REACHABILITY_H
@@ -0,0 +1,94 @@
+#include "roadnetwork.h"
+
+RoadNetwork::RoadNetwork()
+{
+    clear();
+}
+
+void RoadNetwork::clear()
+{
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        m_adjacent[tile].clear();
+    }
+    m_roadCount = 0;
+    rebuildComponents();
+}
+
+bool RoadNetwork::addRoad(int from, int to)
+{
+    if (!isTile(from) || !isTile(to) || from == to || m_adjacent[from].test(to)) {
+        return false;
+    }
+
+    m_adjacent[from].set(to);
+    m_adjacent[to].set(from);
+    ++m_roadCount;
+    unite(from, to);
+    return true;
+}
+
+bool RoadNetwork::removeRoad(int from, int to)
+{
+    if (!hasRoad(from, to)) {
+        return false;
+    }
+
+    m_adjacent[from].reset(to);
+    m_adjacent[to].reset(from);
+    --m_roadCount;
+
+    // Union-find can't split a component, so relabel from the adjacency masks
+    rebuildComponents();
+    return true;
+}
+
+void RoadNetwork::removeRoadsAt(int tile)
+{
+    if (!isTile(tile) || m_adjacent[tile].isEmpty()) {
+        return;
+    }
+
+    m_adjacent[tile].forEach([this, tile](int neighbour) {
+        m_adjacent[neighbour].reset(tile);
+        --m_roadCount;
+    });
+    m_adjacent[tile].clear();
+    rebuildComponents();
+}
+
+void RoadNetwork::unite(int tileA, int tileB)
+{
+    int rootA = find(tileA);
+    int rootB = find(tileB);
+    if (rootA == rootB) {
+        return;
+    }
+
+    // Union by size
+    if (m_size[rootA] < m_size[rootB]) {
+        int swap = rootA;
+        rootA = rootB;
+        rootB = swap;
+    }
+    m_members[rootB].forEach([this, rootA](int tile) { m_root[tile] = rootA; });
+    m_size[rootA] += m_size[rootB];
+    m_members[rootA] |= m_members[rootB];
+}
+
+void RoadNetwork::rebuildComponents()
+{
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        m_root[tile] = tile;
+        m_size[tile] = 1;
+        m_members[tile] = TileMask::single(tile);
+    }
+
+    // Each road is stored on both ends; unite once from the lower tile
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        m_adjacent[tile].forEach([this, tile](int neighbour) {
+            if (neighbour > tile) {
+                unite(tile, neighbour);
+            }
+        });
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef ROADNETWORK_H
+#define ROADNETWORK_H
+
+#include <array>
+#include "tilemask.h"
+
+// One player's roads as a graph over board tiles. Each tile keeps its road
+// neighbours as a TileMask, and every tile is labelled with its connected
+// component's root (quick-find, relabelling the smaller side on a merge), so
+// "everything reachable by road from here" is a lookup. Lookups never write,
+// so one network can be shared by game state snapshots on several threads.
+// Removing roads (a destroyed city) relabels the 96 tiles from the adjacency
+// masks.
+class RoadNetwork
+{
+public:
+    RoadNetwork();
+
+    void clear();
+
+    // Returns false if the road already exists or the ends are not distinct board tiles
+    bool addRoad(int from, int to);
+    bool removeRoad(int from, int to);
+
+    // Remove every road touching a tile (roads need a city at both ends)
+    void removeRoadsAt(int tile);
+
+    bool hasRoad(int tileA, int tileB) const { return isTile(tileA) && m_adjacent[tileA].test(tileB); }
+    const TileMask& neighbours(int tile) const { return m_adjacent[tile]; }
+    int roadCount() const { return m_roadCount; }
+
+    // Component label of a tile (tiles without roads are their own component)
+    int component(int tile) const { return find(tile); }
+    bool isConnected(int tileA, int tileB) const { return find(tileA) == find(tileB); }
+
+    // All tiles in the same component as tile, including tile itself
+    const TileMask& connectedTiles(int tile) const { return m_members[find(tile)]; }
+
+    // Same roads (component labels follow from them)
+    bool operator==(const RoadNetwork &other) const { return m_adjacent == other.m_adjacent; }
+    bool operator!=(const RoadNetwork &other) const { return !(*this == other); }
+
+private:
+    static bool isTile(int tile) { return tile >= 0 && tile < BOARD_TILES; }
+
+    int find(int tile) const { return m_root[tile]; }
+    void unite(int tileA, int tileB);
+    void rebuildComponents();
+
+    std::array<TileMask, BOARD_TILES> m_adjacent;  // Road neighbours of each tile
+    std::array<int, BOARD_TILES> m_root;           // Component root of each tile
+    std::array<int, BOARD_TILES> m_size;           // Component size, valid at roots
+    std::array<TileMask, BOARD_TILES> m_members;   // Component tiles, valid at roots
+    int m_roadCount;
+};
+
+#endif // ROADNETWORK_H
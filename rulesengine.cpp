@@ -0,0 +1,962 @@
+#include "rulesengine.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+// Find one of a player's pieces by unique id
+static PieceState *findOwnPiece(PlayerState &player, int pieceId)
+{
+    for (PieceState &piece : player.pieces.write()) {
+        if (piece.id == pieceId) {
+            return &piece;
+        }
+    }
+    return nullptr;
+}
+
+static const PieceState *findOwnPiece(const PlayerState &player, int pieceId)
+{
+    for (const PieceState &piece : *player.pieces) {
+        if (piece.id == pieceId) {
+            return &piece;
+        }
+    }
+    return nullptr;
+}
+
+// Infantry, cavalry and catapults of a player at a tile
+static int troopCountAt(const PlayerState &player, int tile)
+{
+    int count = 0;
+    for (const PieceState &piece : *player.pieces) {
+        if (piece.tile == tile && isTroopKind(piece.kind)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static PieceState makePiece(GameState &state, PieceKind kind, int tile)
+{
+    PieceState piece;
+    piece.id = state.allocatePieceId(kind);
+    piece.kind = kind;
+    piece.tile = tile;
+    piece.movesRemaining = RulesEngine::movesPerTurn(kind);
+    return piece;
+}
+
+// ========== Setup ==========
+
+void RulesEngine::generateMap(MapState &map, Xoshiro256 &random)
+{
+    // Large list of animal names for land territories
+    static const char *const animalNames[] = {
+        "Lion", "Tiger", "Bear", "Wolf", "Eagle", "Hawk", "Falcon", "Owl",
+        "Fox", "Deer", "Moose", "Elk", "Bison", "Buffalo", "Zebra", "Giraffe",
+        "Elephant", "Rhino", "Hippo", "Crocodile", "Alligator", "Snake", "Cobra", "Viper",
+        "Panther", "Leopard", "Cheetah", "Jaguar", "Cougar", "Lynx", "Bobcat", "Ocelot",
+        "Monkey", "Gorilla", "Chimp", "Orangutan", "Lemur", "Baboon", "Mandrill", "Gibbon",
+        "Rabbit", "Hare", "Squirrel", "Chipmunk", "Raccoon", "Badger", "Weasel", "Ferret",
+        "Raven", "Crow", "Parrot", "Peacock", "Swan", "Goose", "Duck", "Crane",
+        "Horse", "Stallion", "Mare", "Donkey", "Mule", "Camel", "Llama", "Alpaca",
+        "Panda", "Koala", "Sloth", "Armadillo", "Anteater", "Platypus", "Echidna", "Wombat",
+        "Kangaroo", "Wallaby", "Opossum", "Skunk", "Porcupine", "Hedgehog", "Mole", "Shrew",
+        "Bat", "Condor", "Vulture", "Kite", "Osprey", "Harrier", "Buzzard", "Kestrel"
+    };
+
+    // List of fish names for sea territories
+    static const char *const fishNames[] = {
+        "Salmon", "Tuna", "Bass", "Trout", "Pike", "Carp", "Catfish", "Perch",
+        "Cod", "Haddock", "Halibut", "Flounder", "Sole", "Mackerel", "Herring", "Sardine",
+        "Anchovy", "Barracuda", "Marlin", "Swordfish", "Sailfish", "Mahi", "Grouper", "Snapper",
+        "Sturgeon", "Eel", "Lamprey", "Pufferfish", "Angelfish", "Clownfish", "Tang", "Wrasse",
+        "Seahorse", "Stingray", "Manta", "Jellyfish", "Octopus", "Squid", "Cuttlefish", "Nautilus",
+        "Lobster", "Crab", "Shrimp", "Krill", "Starfish", "Urchin", "Anemone", "Coral"
+    };
+
+    // 75% chance of land, 25% chance of sea
+    map.land.clear();
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        if (random.bounded(100) < 75) {
+            map.land.set(tile);
+        }
+    }
+
+    // Shuffle both lists
+    std::vector<std::string> animals(std::begin(animalNames), std::end(animalNames));
+    std::vector<std::string> fish(std::begin(fishNames), std::end(fishNames));
+    random.shuffle(animals.begin(), animals.end());
+    random.shuffle(fish.begin(), fish.end());
+
+    // Assign names and values
+    size_t animalIndex = 0;
+    size_t fishIndex = 0;
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        if (map.isLand(tile)) {
+            // Fallback if we run out of names (shouldn't happen with 88 names)
+            map.names[tile] = animalIndex < animals.size() ? animals[animalIndex] : "Territory" + std::to_string(animalIndex);
+            ++animalIndex;
+            map.value[tile] = (random.bounded(2) == 0) ? 5 : 10;
+        } else {
+            map.names[tile] = fishIndex < fish.size() ? fish[fishIndex] : "Sea" + std::to_string(fishIndex);
+            ++fishIndex;
+            map.value[tile] = 0;  // Sea territories have no tax value
+        }
+    }
+}
+
+std::vector<int> RulesEngine::chooseHomeProvinces(const MapState &map, Xoshiro256 &random, int count)
+{
+    // Collect all land tiles that are adjacent to at least one sea territory
+    std::vector<int> coastalLandTiles;
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        if (!map.isLand(tile)) {
+            continue;
+        }
+        for (int neighbour : adjacentTiles(tile)) {
+            if (map.isSea(neighbour)) {
+                coastalLandTiles.push_back(tile);
+                break;
+            }
+        }
+    }
+
+    // Shuffle and keep the first count
+    random.shuffle(coastalLandTiles.begin(), coastalLandTiles.end());
+    if (static_cast<int>(coastalLandTiles.size()) > count) {
+        coastalLandTiles.resize(count);
+    }
+    return coastalLandTiles;
+}
+
+void RulesEngine::addPlayer(GameState &state, char id, int homeTile)
+{
+    PlayerState player;
+    player.id = id;
+    player.wallet = STARTING_WALLET;
+    player.homeTile = homeTile;
+
+    // Caesar, 6 generals and 4 infantry at the home province (per 1984 rules)
+    player.pieces.write().push_back(makePiece(state, PieceKind::Caesar, homeTile));
+    for (int i = 1; i <= STARTING_GENERALS; ++i) {
+        PieceState general = makePiece(state, PieceKind::General, homeTile);
+        general.generalNumber = i;
+        player.pieces.write().push_back(general);
+    }
+    for (int i = 0; i < STARTING_INFANTRY; ++i) {
+        player.pieces.write().push_back(makePiece(state, PieceKind::Infantry, homeTile));
+    }
+
+    // Fortified city on the claimed home province
+    player.cities.set(homeTile);
+    player.fortifiedCities.set(homeTile);
+    player.owned.set(homeTile);
+
+    state.players.push_back(player);
+}
+
+bool RulesEngine::setupNewGame(GameState &state, Xoshiro256 &random, int playerCount)
+{
+    state = GameState();
+    generateMap(state.map.write(), random);
+
+    std::vector<int> homes = chooseHomeProvinces(*state.map, random, playerCount);
+    if (static_cast<int>(homes.size()) < playerCount) {
+        return false;
+    }
+
+    for (int i = 0; i < playerCount; ++i) {
+        addPlayer(state, static_cast<char>('A' + i), homes[i]);
+    }
+    startTurn(state, 0);
+    return true;
+}
+
+// ========== Movement ==========
+
+int RulesEngine::movesPerTurn(PieceKind kind)
+{
+    switch (kind) {
+        case PieceKind::Infantry:
+        case PieceKind::Catapult:
+            return 1;
+        case PieceKind::Caesar:
+        case PieceKind::General:
+        case PieceKind::Cavalry:
+        case PieceKind::Galley:
+            return 2;
+    }
+    return 0;
+}
+
+bool RulesEngine::isAdjacent(int fromTile, int toTile)
+{
+    if (fromTile < 0 || toTile < 0 || fromTile >= BOARD_TILES || toTile >= BOARD_TILES) {
+        return false;
+    }
+    int rowDiff = std::abs(tileRow(fromTile) - tileRow(toTile));
+    int colDiff = std::abs(tileColumn(fromTile) - tileColumn(toTile));
+    return rowDiff + colDiff == 1;
+}
+
+std::vector<int> RulesEngine::adjacentTiles(int tile)
+{
+    std::vector<int> neighbours;
+    int row = tileRow(tile);
+    int col = tileColumn(tile);
+    if (row > 0) neighbours.push_back(tileIndex(row - 1, col));
+    if (row < BOARD_ROWS - 1) neighbours.push_back(tileIndex(row + 1, col));
+    if (col > 0) neighbours.push_back(tileIndex(row, col - 1));
+    if (col < BOARD_COLUMNS - 1) neighbours.push_back(tileIndex(row, col + 1));
+    return neighbours;
+}
+
+bool RulesEngine::isValidLandMove(const MapState &map, int fromTile, int toTile)
+{
+    // Must be on a land tile (not sea)
+    if (!map.isLand(toTile)) {
+        return false;
+    }
+
+    int fromRow = tileRow(fromTile);
+    int fromCol = tileColumn(fromTile);
+    int toRow = tileRow(toTile);
+    int toCol = tileColumn(toTile);
+    int absRowDiff = std::abs(toRow - fromRow);
+    int absColDiff = std::abs(toCol - fromCol);
+
+    // Total Manhattan distance must be <= 2
+    int totalDistance = absRowDiff + absColDiff;
+    if (totalDistance > 2) {
+        return false;
+    }
+    if (totalDistance <= 1) {
+        return true;
+    }
+
+    // Two steps in a straight line: the square in between must be land
+    if (absRowDiff == 0) {
+        return map.isLand(tileIndex(fromRow, (fromCol + toCol) / 2));
+    }
+    if (absColDiff == 0) {
+        return map.isLand(tileIndex((fromRow + toRow) / 2, fromCol));
+    }
+
+    // Diagonal: either horizontal-then-vertical or vertical-then-horizontal through land
+    return map.isLand(tileIndex(fromRow, toCol)) || map.isLand(tileIndex(toRow, fromCol));
+}
+
+TileMask RulesEngine::roadConnectedTiles(const PlayerState &player, int startTile)
+{
+    return player.roads->connectedTiles(startTile);
+}
+
+bool RulesEngine::assignToLegion(GameState &state, int player, int troopId, int leaderId)
+{
+    PlayerState &owner = state.players[player];
+    PieceState *troop = findOwnPiece(owner, troopId);
+    if (!troop || !isTroopKind(troop->kind)) {
+        return false;
+    }
+
+    if (leaderId != 0) {
+        const PieceState *leader = findOwnPiece(owner, leaderId);
+        if (!leader || !isLeaderKind(leader->kind) || leader->capturedBy != NO_PLAYER || leader->tile != troop->tile) {
+            return false;
+        }
+    }
+
+    troop->leaderId = leaderId;
+    return true;
+}
+
+bool RulesEngine::canMoveLeader(const GameState &state, int player, int leaderId, int toTile, bool viaRoad)
+{
+    const PlayerState &owner = state.players[player];
+    const PieceState *leader = findOwnPiece(owner, leaderId);
+    if (!leader || !isLeaderKind(leader->kind) || leader->capturedBy != NO_PLAYER || leader->galleyId != 0) {
+        return false;
+    }
+    if (leader->movesRemaining <= 0 || toTile < 0 || toTile >= BOARD_TILES || toTile == leader->tile) {
+        return false;
+    }
+    if (!state.map->isLand(toTile)) {
+        return false;
+    }
+
+    if (!viaRoad) {
+        if (!isAdjacent(leader->tile, toTile)) {
+            return false;
+        }
+    } else {
+        // Step into an adjacent territory, then travel along roads connected to it
+        bool reachable = false;
+        for (int step : adjacentTiles(leader->tile)) {
+            if (state.map->isLand(step) && roadConnectedTiles(owner, step).test(toTile)) {
+                reachable = true;
+                break;
+            }
+        }
+        if (!reachable) {
+            return false;
+        }
+    }
+
+    // A General/Caesar cannot fight alone
+    if (state.hasEnemyPiecesAt(player, toTile)) {
+        for (const PieceState &piece : *owner.pieces) {
+            if (piece.leaderId == leaderId && piece.tile == leader->tile && piece.movesRemaining > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool RulesEngine::moveLeader(GameState &state, int player, int leaderId, int toTile, bool viaRoad)
+{
+    if (!canMoveLeader(state, player, leaderId, toTile, viaRoad)) {
+        return false;
+    }
+
+    PlayerState &owner = state.players[player];
+    PieceState *leader = findOwnPiece(owner, leaderId);
+    int fromTile = leader->tile;
+    bool enteringCombat = state.hasEnemyPiecesAt(player, toTile);
+
+    // Store last territory before moving (for retreat purposes)
+    leader->lastTile = fromTile;
+    leader->tile = toTile;
+    leader->movesRemaining--;
+
+    // The legion marches with its leader; troops that cannot move are left behind
+    for (PieceState &piece : owner.pieces.write()) {
+        if (piece.leaderId != leaderId) {
+            continue;
+        }
+        if (piece.tile != fromTile || piece.movesRemaining <= 0) {
+            piece.leaderId = 0;
+            continue;
+        }
+        piece.tile = toTile;
+        piece.movesRemaining--;
+    }
+
+    // Territory changes hands only if there is nobody to fight
+    if (enteringCombat) {
+        leader->movesRemaining = 0;
+    } else {
+        claimTerritory(state, player, toTile);
+    }
+
+    return true;
+}
+
+bool RulesEngine::embark(GameState &state, int player, int pieceId, int galleyId)
+{
+    PlayerState &owner = state.players[player];
+    PieceState *piece = findOwnPiece(owner, pieceId);
+    const PieceState *galley = findOwnPiece(owner, galleyId);
+    if (!piece || !galley || piece->kind == PieceKind::Galley || galley->kind != PieceKind::Galley) {
+        return false;
+    }
+    if (piece->capturedBy != NO_PLAYER || piece->tile != galley->tile) {
+        return false;
+    }
+
+    piece->galleyId = galleyId;
+    return true;
+}
+
+bool RulesEngine::canEmbarkLegion(const GameState &state, int player, int leaderId, int galleyId)
+{
+    const PlayerState &owner = state.players[player];
+    const PieceState *leader = findOwnPiece(owner, leaderId);
+    const PieceState *galley = findOwnPiece(owner, galleyId);
+    if (!leader || !galley || !isLeaderKind(leader->kind) || galley->kind != PieceKind::Galley) {
+        return false;
+    }
+    return leader->capturedBy == NO_PLAYER && leader->galleyId == 0 && leader->movesRemaining > 0 &&
+           leader->tile != NO_TILE && leader->tile == galley->tile;
+}
+
+bool RulesEngine::embarkLegion(GameState &state, int player, int leaderId, int galleyId)
+{
+    if (!canEmbarkLegion(state, player, leaderId, galleyId)) {
+        return false;
+    }
+
+    int tile = findOwnPiece(state.players[player], leaderId)->tile;
+    for (PieceState &piece : state.players[player].pieces.write()) {
+        if (piece.id == leaderId || (piece.leaderId == leaderId && piece.tile == tile)) {
+            piece.galleyId = galleyId;
+        }
+    }
+    return true;
+}
+
+bool RulesEngine::canMoveGalley(const GameState &state, int player, int galleyId, int toTile)
+{
+    const PlayerState &owner = state.players[player];
+    const PieceState *galley = findOwnPiece(owner, galleyId);
+    if (!galley || galley->kind != PieceKind::Galley || galley->movesRemaining <= 0) {
+        return false;
+    }
+    if (!isAdjacent(galley->tile, toTile)) {
+        return false;
+    }
+
+    // Sail onto sea, or land from sea
+    if (state.map->isLand(toTile) && state.map->isLand(galley->tile)) {
+        return false;
+    }
+
+    // Landing on enemy pieces needs troops aboard
+    if (state.map->isLand(toTile) && state.hasEnemyPiecesAt(player, toTile)) {
+        for (const PieceState &piece : *owner.pieces) {
+            if (piece.galleyId == galleyId && isTroopKind(piece.kind)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool RulesEngine::moveGalley(GameState &state, int player, int galleyId, int toTile)
+{
+    if (!canMoveGalley(state, player, galleyId, toTile)) {
+        return false;
+    }
+
+    PlayerState &owner = state.players[player];
+    PieceState *galley = findOwnPiece(owner, galleyId);
+    bool landing = state.map->isLand(toTile);
+    bool enteringCombat = landing && state.hasEnemyPiecesAt(player, toTile);
+
+    galley->lastTile = galley->tile;
+    galley->tile = toTile;
+    galley->movesRemaining--;
+
+    // Passengers travel for free and go ashore when the galley lands
+    for (PieceState &piece : owner.pieces.write()) {
+        if (piece.galleyId != galleyId) {
+            continue;
+        }
+        piece.tile = toTile;
+        if (landing) {
+            piece.galleyId = 0;
+            if (enteringCombat && isLeaderKind(piece.kind)) {
+                piece.movesRemaining = 0;
+            }
+        }
+    }
+
+    if (landing && !enteringCombat) {
+        claimTerritory(state, player, toTile);
+    }
+
+    return true;
+}
+
+void RulesEngine::claimTerritory(GameState &state, int player, int tile)
+{
+    if (!state.map->isLand(tile) || state.players[player].owned.test(tile)) {
+        return;
+    }
+
+    for (PlayerState &other : state.players) {
+        other.owned.reset(tile);
+    }
+    state.players[player].owned.set(tile);
+
+    // Claiming a territory with one of our cities may connect new roads
+    if (state.players[player].cities.test(tile)) {
+        updateRoads(state, player);
+    }
+}
+
+// ========== Combat ==========
+
+int RulesEngine::hitThreshold(PieceKind target)
+{
+    switch (target) {
+        case PieceKind::Infantry: return 4;
+        case PieceKind::Cavalry: return 5;
+        case PieceKind::Catapult: return 6;
+        default: return 0;  // Leaders and galleys cannot be targeted
+    }
+}
+
+int RulesEngine::netAdvantage(int attackerCatapults, int defenderCatapults, bool defenderFortified, bool forAttacker)
+{
+    int difference = attackerCatapults - (defenderCatapults + (defenderFortified ? 1 : 0));
+    if (forAttacker) {
+        return (difference > 0) ? difference : 0;  // Only positive for attacker
+    }
+    return (difference < 0) ? -difference : 0;  // Only positive for defender
+}
+
+int RulesEngine::netAdvantage(const GameState &state, int tile, int attacker, int defender, bool forAttacker)
+{
+    return netAdvantage(state.countAt(attacker, tile, PieceKind::Catapult),
+                        state.countAt(defender, tile, PieceKind::Catapult),
+                        state.players[defender].fortifiedCities.test(tile),
+                        forAttacker);
+}
+
+bool RulesEngine::isHit(PieceKind target, int dieValue, int advantage)
+{
+    int threshold = hitThreshold(target);
+    return threshold > 0 && dieValue + advantage >= threshold;
+}
+
+std::vector<int> RulesEngine::combatTiles(const GameState &state, int player)
+{
+    TileMask enemyTiles;
+    for (int i = 0; i < state.playerCount(); ++i) {
+        if (i != player) {
+            enemyTiles |= state.occupiedTiles(i);
+        }
+    }
+
+    std::vector<int> tiles;
+    (state.occupiedTiles(player) & enemyTiles).forEach([&tiles](int tile) { tiles.push_back(tile); });
+    return tiles;
+}
+
+int RulesEngine::defenderAt(const GameState &state, int attacker, int tile)
+{
+    for (int i = 0; i < state.playerCount(); ++i) {
+        if (i != attacker && state.hasPiecesAt(i, tile)) {
+            return i;
+        }
+    }
+    return NO_PLAYER;
+}
+
+RulesEngine::CombatResult RulesEngine::resolveCombat(GameState &state, int tile, int attacker, int defender,
+                                                     Xoshiro256 &random)
+{
+    CombatResult result;
+    int attackerTroops = troopCountAt(state.players[attacker], tile);
+    int defenderTroops = troopCountAt(state.players[defender], tile);
+    if (attackerTroops == 0 && defenderTroops == 0) {
+        return result;  // Nobody can fight
+    }
+    result.fought = true;
+
+    // Alternate shots, attacker first, each at the easiest enemy troop to hit
+    bool attackersTurn = true;
+    while (attackerTroops > 0 && defenderTroops > 0) {
+        PlayerState &target = state.players[attackersTurn ? defender : attacker];
+
+        const PieceState *targetPiece = nullptr;
+        for (const PieceState &piece : *target.pieces) {
+            if (piece.tile == tile && isTroopKind(piece.kind) &&
+                (!targetPiece || hitThreshold(piece.kind) < hitThreshold(targetPiece->kind))) {
+                targetPiece = &piece;
+            }
+        }
+
+        int advantage = netAdvantage(state, tile, attacker, defender, attackersTurn);
+        if (isHit(targetPiece->kind, random.uniform(1, 6), advantage)) {
+            removePiece(target, targetPiece->id);
+            if (attackersTurn) {
+                --defenderTroops;
+                ++result.defenderLosses;
+            } else {
+                --attackerTroops;
+                ++result.attackerLosses;
+            }
+        }
+        attackersTurn = !attackersTurn;
+    }
+
+    result.attackerWon = (defenderTroops == 0);
+    int winner = result.attackerWon ? attacker : defender;
+    int loser = result.attackerWon ? defender : attacker;
+    PlayerState &losingPlayer = state.players[loser];
+
+    // Defeated Caesar: complete takeover
+    for (const PieceState &piece : *losingPlayer.pieces) {
+        if (piece.tile == tile && piece.kind == PieceKind::Caesar) {
+            result.caesarCaptured = true;
+            break;
+        }
+    }
+    if (result.caesarCaptured) {
+        takeOver(state, winner, loser);
+        return result;
+    }
+
+    // Defeated generals are taken prisoner; galleys at the tile are sunk
+    std::vector<int> sunkGalleys;
+    for (PieceState &piece : losingPlayer.pieces.write()) {
+        if (piece.tile != tile) {
+            continue;
+        }
+        if (piece.kind == PieceKind::General && piece.capturedBy == NO_PLAYER) {
+            piece.capturedBy = winner;
+        } else if (piece.kind == PieceKind::Galley) {
+            sunkGalleys.push_back(piece.id);
+        }
+    }
+    for (int galleyId : sunkGalleys) {
+        removePiece(losingPlayer, galleyId);
+    }
+
+    // The attacker takes the territory and any city on it
+    if (result.attackerWon) {
+        claimTerritory(state, attacker, tile);
+
+        PlayerState &defendingPlayer = state.players[defender];
+        if (defendingPlayer.cities.test(tile)) {
+            bool fortified = defendingPlayer.fortifiedCities.test(tile);
+            destroyCity(state, defender, tile);
+            state.players[attacker].cities.set(tile);
+            state.players[attacker].fortifiedCities.assign(tile, fortified);
+            updateRoads(state, attacker);
+        }
+    }
+
+    return result;
+}
+
+void RulesEngine::resolveAllCombats(GameState &state, int player, Xoshiro256 &random)
+{
+    for (int tile : combatTiles(state, player)) {
+        // Fight each enemy at the tile in turn while we still have pieces there
+        while (!state.players[player].eliminated && state.hasPiecesAt(player, tile)) {
+            int defender = defenderAt(state, player, tile);
+            if (defender == NO_PLAYER || !resolveCombat(state, tile, player, defender, random).fought) {
+                break;
+            }
+        }
+    }
+}
+
+void RulesEngine::takeOver(GameState &state, int winner, int loser)
+{
+    PlayerState &winningPlayer = state.players[winner];
+    PlayerState &losingPlayer = state.players[loser];
+
+    // Transfer all money + 100 bonus
+    winningPlayer.wallet += losingPlayer.wallet + CAESAR_CAPTURE_BONUS;
+    losingPlayer.wallet = 0;
+
+    // Transfer all territories and cities
+    winningPlayer.owned |= losingPlayer.owned;
+    winningPlayer.cities |= losingPlayer.cities;
+    winningPlayer.fortifiedCities |= losingPlayer.fortifiedCities;
+    losingPlayer.owned.clear();
+    losingPlayer.cities.clear();
+    losingPlayer.fortifiedCities.clear();
+    losingPlayer.roads.write().clear();
+
+    // Transfer all pieces except Caesar (killed)
+    int caesarId = 0;
+    for (PieceState &piece : losingPlayer.pieces.write()) {
+        if (piece.kind == PieceKind::Caesar) {
+            caesarId = piece.id;
+            continue;
+        }
+        if (piece.capturedBy == winner) {
+            piece.capturedBy = NO_PLAYER;  // The winner's prisoners join the winner's army
+        }
+        winningPlayer.pieces.write().push_back(piece);
+    }
+    losingPlayer.pieces.write().clear();
+    losingPlayer.eliminated = true;
+
+    for (PieceState &piece : winningPlayer.pieces.write()) {
+        if (caesarId != 0 && piece.leaderId == caesarId) {
+            piece.leaderId = 0;
+        }
+    }
+
+    // Generals the loser was holding: the winner's own go free, the rest change jailer
+    for (int i = 0; i < state.playerCount(); ++i) {
+        for (PieceState &piece : state.players[i].pieces.write()) {
+            if (piece.capturedBy == loser) {
+                piece.capturedBy = (i == winner) ? NO_PLAYER : winner;
+            }
+        }
+    }
+
+    updateRoads(state, winner);
+}
+
+// ========== Economy ==========
+
+int RulesEngine::territoryIncome(const std::array<int, BOARD_TILES> &values, const TileMask &owned)
+{
+    int income = 0;
+    owned.forEach([&](int tile) { income += values[tile]; });
+    return income;
+}
+
+int RulesEngine::territoryIncome(const GameState &state, int player)
+{
+    return territoryIncome(state.map->value, state.players[player].owned);
+}
+
+int RulesEngine::taxIncome(const GameState &state, int player)
+{
+    const PlayerState &owner = state.players[player];
+    return taxIncome(state.map->value, owner.owned, owner.cities);
+}
+
+int RulesEngine::collectTaxes(GameState &state, int player)
+{
+    int taxes = taxIncome(state, player);
+    state.players[player].wallet += taxes;
+    return taxes;
+}
+
+int RulesEngine::price(int baseCost, int inflationMultiplier)
+{
+    return baseCost * inflationMultiplier;
+}
+
+int RulesEngine::purchaseCost(const PurchaseOrder &order, int inflationMultiplier)
+{
+    int totalCost = 0;
+    totalCost += order.infantry * price(INFANTRY_BASE_COST, inflationMultiplier);
+    totalCost += order.cavalry * price(CAVALRY_BASE_COST, inflationMultiplier);
+    totalCost += order.catapults * price(CATAPULT_BASE_COST, inflationMultiplier);
+    totalCost += order.galleys * price(GALLEY_BASE_COST, inflationMultiplier);
+    totalCost += static_cast<int>(order.cities.size()) * price(CITY_BASE_COST, inflationMultiplier);
+    totalCost += static_cast<int>(order.fortifiedCities.size()) *
+                 price(CITY_BASE_COST + FORTIFICATION_BASE_COST, inflationMultiplier);
+    totalCost += static_cast<int>(order.fortifications.size()) * price(FORTIFICATION_BASE_COST, inflationMultiplier);
+    return totalCost;
+}
+
+bool RulesEngine::canPurchase(const GameState &state, int player, const PurchaseOrder &order)
+{
+    const PlayerState &buyer = state.players[player];
+    if (order.infantry < 0 || order.cavalry < 0 || order.catapults < 0 || order.galleys < 0) {
+        return false;
+    }
+    if (purchaseCost(order, state.inflationMultiplier) > buyer.wallet) {
+        return false;
+    }
+
+    // Limited by the pieces left in the game box
+    if (state.countInPlay(PieceKind::Infantry) + order.infantry > TOTAL_INFANTRY_PIECES ||
+        state.countInPlay(PieceKind::Cavalry) + order.cavalry > TOTAL_CAVALRY_PIECES ||
+        state.countInPlay(PieceKind::Catapult) + order.catapults > TOTAL_CATAPULT_PIECES ||
+        state.countInPlay(PieceKind::Galley) + order.galleys > TOTAL_GALLEY_PIECES) {
+        return false;
+    }
+
+    int ownGalleys = 0;
+    for (const PieceState &piece : *buyer.pieces) {
+        if (piece.kind == PieceKind::Galley) {
+            ++ownGalleys;
+        }
+    }
+    if (ownGalleys + order.galleys > MAX_GALLEYS_PER_PLAYER) {
+        return false;
+    }
+
+    // One city per owned territory
+    TileMask newCities;
+    for (const std::vector<int> *tiles : {&order.cities, &order.fortifiedCities}) {
+        for (int tile : *tiles) {
+            if (tile < 0 || tile >= BOARD_TILES || !buyer.owned.test(tile) || buyer.cities.test(tile) || newCities.test(tile)) {
+                return false;
+            }
+            newCities.set(tile);
+        }
+    }
+
+    // Fortifications only for existing unfortified cities
+    TileMask newFortifications;
+    for (int tile : order.fortifications) {
+        if (tile < 0 || tile >= BOARD_TILES || !buyer.cities.test(tile) ||
+            buyer.fortifiedCities.test(tile) || newFortifications.test(tile)) {
+            return false;
+        }
+        newFortifications.set(tile);
+    }
+
+    return true;
+}
+
+bool RulesEngine::purchase(GameState &state, int player, const PurchaseOrder &order)
+{
+    if (!canPurchase(state, player, order)) {
+        return false;
+    }
+
+    PlayerState &buyer = state.players[player];
+    buyer.wallet -= purchaseCost(order, state.inflationMultiplier);
+
+    // Cities and fortifications
+    for (int tile : order.cities) {
+        buyer.cities.set(tile);
+    }
+    for (int tile : order.fortifiedCities) {
+        buyer.cities.set(tile);
+        buyer.fortifiedCities.set(tile);
+    }
+    for (int tile : order.fortifications) {
+        buyer.fortifiedCities.set(tile);
+    }
+
+    // Military units (and galleys) are created at the home province
+    for (int i = 0; i < order.infantry; ++i) {
+        buyer.pieces.write().push_back(makePiece(state, PieceKind::Infantry, buyer.homeTile));
+    }
+    for (int i = 0; i < order.cavalry; ++i) {
+        buyer.pieces.write().push_back(makePiece(state, PieceKind::Cavalry, buyer.homeTile));
+    }
+    for (int i = 0; i < order.catapults; ++i) {
+        buyer.pieces.write().push_back(makePiece(state, PieceKind::Catapult, buyer.homeTile));
+    }
+    for (int i = 0; i < order.galleys; ++i) {
+        buyer.pieces.write().push_back(makePiece(state, PieceKind::Galley, buyer.homeTile));
+    }
+
+    if (!order.cities.empty() || !order.fortifiedCities.empty()) {
+        updateRoads(state, player);
+    }
+    return true;
+}
+
+// ========== Roads and Cities ==========
+
+bool RulesEngine::canConnectByRoad(const GameState &state, int player, int tileA, int tileB)
+{
+    const PlayerState &owner = state.players[player];
+    return isAdjacent(tileA, tileB) &&
+           state.map->isLand(tileA) && state.map->isLand(tileB) &&
+           owner.cities.test(tileA) && owner.cities.test(tileB) &&
+           owner.owned.test(tileA) && owner.owned.test(tileB);
+}
+
+bool RulesEngine::hasRoad(const PlayerState &player, int tileA, int tileB)
+{
+    return player.roads->hasRoad(tileA, tileB);
+}
+
+TileMask RulesEngine::roadNeighbours(const TileMask &land, const TileMask &owned, const TileMask &cities, int tile)
+{
+    TileMask joinable = land & owned & cities;
+    TileMask neighbours;
+    if (tile == NO_TILE || !joinable.test(tile)) {
+        return neighbours;
+    }
+
+    int row = tileRow(tile);
+    int col = tileColumn(tile);
+    if (row > 0) neighbours.set(tileIndex(row - 1, col));
+    if (row < BOARD_ROWS - 1) neighbours.set(tileIndex(row + 1, col));
+    if (col > 0) neighbours.set(tileIndex(row, col - 1));
+    if (col < BOARD_COLUMNS - 1) neighbours.set(tileIndex(row, col + 1));
+    return neighbours & joinable;
+}
+
+void RulesEngine::addRoadsAround(GameState &state, int player, int tile)
+{
+    PlayerState &owner = state.players[player];
+    TileMask missing = roadNeighbours(state.map->land, owner.owned, owner.cities, tile);
+    if (tile != NO_TILE) {
+        missing &= ~owner.roads->neighbours(tile);
+    }
+
+    // Only unshare the network when a road is actually added
+    if (missing.any()) {
+        RoadNetwork &roads = owner.roads.write();
+        missing.forEach([&roads, tile](int neighbour) {
+            roads.addRoad(tile, neighbour);
+        });
+    }
+}
+
+void RulesEngine::updateRoads(GameState &state, int player)
+{
+    state.players[player].cities.forEach([&state, player](int tile) {
+        addRoadsAround(state, player, tile);
+    });
+}
+
+void RulesEngine::destroyCity(GameState &state, int player, int tile)
+{
+    PlayerState &owner = state.players[player];
+    owner.cities.reset(tile);
+    owner.fortifiedCities.reset(tile);
+
+    // Roads need a city at both ends
+    owner.roads.write().removeRoadsAt(tile);
+}
+
+// ========== Turns ==========
+
+void RulesEngine::startTurn(GameState &state, int player)
+{
+    state.currentPlayer = player;
+
+    // Reset movement for all pieces to their default values (prisoners stay put)
+    for (PieceState &piece : state.players[player].pieces.write()) {
+        piece.movesRemaining = (piece.capturedBy == NO_PLAYER) ? movesPerTurn(piece.kind) : 0;
+    }
+}
+
+void RulesEngine::endTurn(GameState &state)
+{
+    int current = state.currentPlayer;
+    collectTaxes(state, current);
+
+    // Next player still in the game (wrap around to first player after last)
+    int next = current;
+    for (int i = 1; i <= state.playerCount(); ++i) {
+        int candidate = (current + i) % state.playerCount();
+        if (!state.players[candidate].eliminated) {
+            next = candidate;
+            break;
+        }
+    }
+    if (next <= current) {
+        state.turnNumber++;
+    }
+
+    startTurn(state, next);
+}
+
+int RulesEngine::winner(const GameState &state)
+{
+    if (state.activePlayerCount() != 1) {
+        return NO_PLAYER;
+    }
+    for (int i = 0; i < state.playerCount(); ++i) {
+        if (!state.players[i].eliminated) {
+            return i;
+        }
+    }
+    return NO_PLAYER;
+}
+
+void RulesEngine::removePiece(PlayerState &player, int pieceId)
+{
+    std::vector<PieceState> &pieces = player.pieces.write();
+    pieces.erase(std::remove_if(pieces.begin(), pieces.end(),
+                                [pieceId](const PieceState &piece) { return piece.id == pieceId; }),
+                 pieces.end());
+
+    // Followers and passengers lose their leader or galley
+    for (PieceState &piece : pieces) {
+        if (piece.leaderId == pieceId) {
+            piece.leaderId = 0;
+        }
+        if (piece.galleyId == pieceId) {
+            piece.galleyId = 0;
+        }
+    }
+}
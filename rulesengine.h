@@ -0,0 +1,177 @@
+#ifndef RULESENGINE_H
+#define RULESENGINE_H
+
+#include <vector>
+#include "gamestate.h"
+#include "fastrng.h"
+
+// Game rules applied to a GameState. Everything is static and free of Qt so
+// the same rules drive the widgets, headless simulations and computer players.
+class RulesEngine
+{
+public:
+    // Base prices in talents (multiplied by the inflation multiplier)
+    static constexpr int INFANTRY_BASE_COST = 10;
+    static constexpr int CAVALRY_BASE_COST = 20;
+    static constexpr int CATAPULT_BASE_COST = 30;
+    static constexpr int GALLEY_BASE_COST = 20;
+    static constexpr int CITY_BASE_COST = 30;
+    static constexpr int FORTIFICATION_BASE_COST = 20;
+
+    // Pieces available in the physical game (1984 Milton Bradley edition)
+    static constexpr int TOTAL_INFANTRY_PIECES = 60;
+    static constexpr int TOTAL_CAVALRY_PIECES = 30;
+    static constexpr int TOTAL_CATAPULT_PIECES = 20;
+    static constexpr int TOTAL_GALLEY_PIECES = 36;
+    static constexpr int MAX_GALLEYS_PER_PLAYER = 6;
+
+    // Economy
+    static constexpr int STARTING_WALLET = 100;
+    static constexpr int CITY_TAX = 5;
+    static constexpr int CAESAR_CAPTURE_BONUS = 100;
+
+    // Starting forces at each home province
+    static constexpr int STARTING_GENERALS = 6;
+    static constexpr int STARTING_INFANTRY = 4;
+
+    // Everything a player can buy during the purchase phase
+    struct PurchaseOrder {
+        int infantry = 0;
+        int cavalry = 0;
+        int catapults = 0;
+        int galleys = 0;
+        std::vector<int> cities;            // Tiles for new cities
+        std::vector<int> fortifiedCities;   // Tiles for new fortified cities
+        std::vector<int> fortifications;    // Tiles of existing cities to fortify
+    };
+
+    struct CombatResult {
+        bool fought = false;             // False if either side was missing
+        bool attackerWon = false;
+        bool caesarCaptured = false;     // The loser was taken over by the winner
+        int attackerLosses = 0;
+        int defenderLosses = 0;
+    };
+
+    // ----- Setup -----
+
+    // Random land/sea layout (75% land) with shuffled animal/fish names and 5/10 tax values
+    static void generateMap(MapState &map, Xoshiro256 &random);
+
+    // Coastal land tiles picked at random for home provinces
+    static std::vector<int> chooseHomeProvinces(const MapState &map, Xoshiro256 &random, int count = MAX_PLAYERS);
+
+    // Add a player with the starting Caesar, generals, infantry and fortified city
+    static void addPlayer(GameState &state, char id, int homeTile);
+
+    // Fresh map and players; returns false if the map has too few coastal tiles
+    static bool setupNewGame(GameState &state, Xoshiro256 &random, int playerCount = MAX_PLAYERS);
+
+    // ----- Movement -----
+
+    static int movesPerTurn(PieceKind kind);
+    static bool isAdjacent(int fromTile, int toTile);
+    static std::vector<int> adjacentTiles(int tile);
+
+    // Up to 2 steps over land (the old MapWidget drag-and-drop rule)
+    static bool isValidLandMove(const MapState &map, int fromTile, int toTile);
+
+    // Tiles reachable from startTile along the player's roads (including startTile)
+    static TileMask roadConnectedTiles(const PlayerState &player, int startTile);
+
+    // Put a troop under a leader's command (0 removes it from any legion)
+    static bool assignToLegion(GameState &state, int player, int troopId, int leaderId);
+
+    // Move a leader and its legion one step, or along roads after the first step.
+    // Costs one move; entering enemy pieces needs troops and ends the leader's movement.
+    static bool canMoveLeader(const GameState &state, int player, int leaderId, int toTile, bool viaRoad);
+    static bool moveLeader(GameState &state, int player, int leaderId, int toTile, bool viaRoad);
+
+    // Board a galley that shares the piece's tile
+    static bool embark(GameState &state, int player, int pieceId, int galleyId);
+
+    // A leader and the legion troops beside it board a galley on their tile. Costs no move
+    // (the leader must have one left); they sail with the galley and go ashore when it lands
+    static bool canEmbarkLegion(const GameState &state, int player, int leaderId, int galleyId);
+    static bool embarkLegion(GameState &state, int player, int leaderId, int galleyId);
+
+    // Move a galley one step onto sea, or from sea onto land to unload its passengers
+    static bool canMoveGalley(const GameState &state, int player, int galleyId, int toTile);
+    static bool moveGalley(GameState &state, int player, int galleyId, int toTile);
+
+    // Claim a territory, taking it away from any previous owner
+    static void claimTerritory(GameState &state, int player, int tile);
+
+    // ----- Combat -----
+
+    // Die roll needed to hit a troop (0 for pieces that cannot be targeted)
+    static int hitThreshold(PieceKind target);
+
+    // One catapult = +1, fortified city = +1 for the defender; only the side ahead gets the difference
+    static int netAdvantage(int attackerCatapults, int defenderCatapults, bool defenderFortified, bool forAttacker);
+    static int netAdvantage(const GameState &state, int tile, int attacker, int defender, bool forAttacker);
+    static bool isHit(PieceKind target, int dieValue, int advantage);
+
+    // Tiles where the player shares a territory with enemy pieces
+    static std::vector<int> combatTiles(const GameState &state, int player);
+
+    // First enemy player with pieces at the tile (NO_PLAYER if none)
+    static int defenderAt(const GameState &state, int attacker, int tile);
+
+    // Fight to the end: alternate shots (attacker first) at the weakest enemy troop
+    static CombatResult resolveCombat(GameState &state, int tile, int attacker, int defender, Xoshiro256 &random);
+
+    // Resolve every combat for the player
+    static void resolveAllCombats(GameState &state, int player, Xoshiro256 &random);
+
+    // Caesar captured: the winner gets the loser's money + 100, territories, cities and pieces
+    static void takeOver(GameState &state, int winner, int loser);
+
+    // ----- Economy -----
+
+    // Territory values plus CITY_TAX per city. The mask forms are the formula itself, cheap
+    // enough for the game window's score ledger to call; the GameState ones apply it to a player
+    static int territoryIncome(const std::array<int, BOARD_TILES> &values, const TileMask &owned);
+    static int cityIncome(const TileMask &cities) { return cities.count() * CITY_TAX; }
+    static int taxIncome(const std::array<int, BOARD_TILES> &values, const TileMask &owned, const TileMask &cities)
+    {
+        return territoryIncome(values, owned) + cityIncome(cities);
+    }
+    static int territoryIncome(const GameState &state, int player);
+    static int taxIncome(const GameState &state, int player);
+    static int collectTaxes(GameState &state, int player);
+    static int price(int baseCost, int inflationMultiplier);
+    static int purchaseCost(const PurchaseOrder &order, int inflationMultiplier);
+    static bool canPurchase(const GameState &state, int player, const PurchaseOrder &order);
+    static bool purchase(GameState &state, int player, const PurchaseOrder &order);
+
+    // ----- Roads and cities -----
+
+    // Orthogonally adjacent land tiles, both owned by the player and both with the player's cities
+    static bool canConnectByRoad(const GameState &state, int player, int tileA, int tileB);
+    static bool hasRoad(const PlayerState &player, int tileA, int tileB);
+
+    // Neighbours of tile the rule above lets a road join it to (none unless tile
+    // itself qualifies); works on plain masks so the UI can apply it as well
+    static TileMask roadNeighbours(const TileMask &land, const TileMask &owned, const TileMask &cities, int tile);
+    // Adds the missing roads at one tile, for when a city is built or a territory claimed there
+    static void addRoadsAround(GameState &state, int player, int tile);
+    // Every missing road of the player
+    static void updateRoads(GameState &state, int player);
+    static void destroyCity(GameState &state, int player, int tile);
+
+    // ----- Turns -----
+
+    static void startTurn(GameState &state, int player);
+
+    // Collect taxes and hand the turn to the next player still in the game
+    static void endTurn(GameState &state);
+
+    // Index of the last player standing (NO_PLAYER while the game is running)
+    static int winner(const GameState &state);
+
+private:
+    static void removePiece(PlayerState &player, int pieceId);
+};
+
+#endif // RULESENGINE_H
@@ -0,0 +1,460 @@
+#include "savegame.h"
+#include "bytestream.h"
+#include "gamestate.h"
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+static const char BINARY_MAGIC[4] = {'C', 'T', 'E', 'S'};
+
+// Which optional fields a piece table stores (mirrors the JSON objects per type)
+struct PieceFields
+{
+    bool galley;       // onGalley
+    bool number;       // General number
+    bool original;     // Captured generals: original player
+    bool legion;       // Legion and last territory
+};
+
+static const PieceFields CAESAR_FIELDS = {true, false, false, true};
+static const PieceFields GENERAL_FIELDS = {true, true, false, true};
+static const PieceFields CAPTURED_FIELDS = {true, true, true, false};
+static const PieceFields TROOP_FIELDS = {true, false, false, false};
+static const PieceFields GALLEY_FIELDS = {false, false, false, true};
+
+// ========== Writing ==========
+
+namespace {
+
+// Names are written once and referred to by index
+class StringTable
+{
+public:
+    void add(const std::string &text)
+    {
+        if (m_indices.emplace(text, static_cast<int>(m_strings.size())).second) {
+            m_strings.push_back(text);
+        }
+    }
+
+    int indexOf(const std::string &text) const { return m_indices.at(text); }
+    const std::vector<std::string> &strings() const { return m_strings; }
+
+private:
+    std::unordered_map<std::string, int> m_indices;
+    std::vector<std::string> m_strings;
+};
+
+} // namespace
+
+static void collectStrings(const SaveGame &save, StringTable &table)
+{
+    for (const SavedTerritory &territory : save.territories) {
+        table.add(territory.name);
+    }
+    for (const SavedPlayer &player : save.players) {
+        table.add(player.homeName);
+        for (const std::string &name : player.ownedTerritories) {
+            table.add(name);
+        }
+        for (const std::vector<SavedPiece> *pieces : {&player.caesars, &player.generals, &player.capturedGenerals,
+                                                      &player.infantry, &player.cavalry, &player.catapults,
+                                                      &player.galleys}) {
+            for (const SavedPiece &piece : *pieces) {
+                table.add(piece.territory);
+            }
+        }
+        for (const SavedCity &city : player.cities) {
+            table.add(city.territory);
+        }
+    }
+}
+
+static void writePieces(ByteWriter &writer, const StringTable &table, const std::vector<SavedPiece> &pieces,
+                        const PieceFields &fields)
+{
+    writer.count(pieces.size());
+    for (const SavedPiece &piece : pieces) {
+        writer.integer(piece.serialNumber);
+        writer.position(piece.row, piece.col);
+        writer.count(table.indexOf(piece.territory));
+        writer.integer(piece.movesRemaining);
+        if (fields.galley) {
+            writer.integer(piece.onGalley);
+        }
+        if (fields.number) {
+            writer.integer(piece.number);
+        }
+        if (fields.original) {
+            writer.byte(static_cast<uint8_t>(piece.originalPlayer));
+        }
+        if (fields.legion) {
+            writer.position(piece.lastRow, piece.lastCol);
+            writer.count(piece.legion.size());
+            for (int id : piece.legion) {
+                writer.integer(id);
+            }
+        }
+    }
+}
+
+bool SaveGame::isBinary(const char *data, size_t size)
+{
+    return size >= sizeof(BINARY_MAGIC) && std::memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+}
+
+std::vector<char> SaveGame::toBinary() const
+{
+    StringTable table;
+    collectStrings(*this, table);
+
+    ByteWriter writer;
+    writer.bytes(std::string(BINARY_MAGIC, sizeof(BINARY_MAGIC)));
+    writer.byte(BINARY_VERSION);
+
+    writer.count(table.strings().size());
+    for (const std::string &text : table.strings()) {
+        writer.text(text);
+    }
+
+    writer.integer(currentPlayerIndex);
+    writer.byte(hasRandomState ? 1 : 0);
+    if (hasRandomState) {
+        writer.word(randomSeed);
+        writer.count(randomState.size());
+        for (uint64_t word : randomState) {
+            writer.word(word);
+        }
+    }
+
+    for (const SavedTerritory &territory : territories) {
+        writer.count(table.indexOf(territory.name));
+        writer.integer(territory.value * 2 + (territory.isLand ? 1 : 0));
+    }
+
+    writer.count(players.size());
+    for (const SavedPlayer &player : players) {
+        writer.byte(static_cast<uint8_t>(player.id));
+        writer.integer(player.wallet);
+        writer.byte(player.computer ? 1 : 0);
+        writer.position(player.homeRow, player.homeCol);
+        writer.count(table.indexOf(player.homeName));
+
+        writer.count(player.ownedTerritories.size());
+        for (const std::string &name : player.ownedTerritories) {
+            writer.count(table.indexOf(name));
+        }
+
+        writePieces(writer, table, player.caesars, CAESAR_FIELDS);
+        writePieces(writer, table, player.generals, GENERAL_FIELDS);
+        writePieces(writer, table, player.capturedGenerals, CAPTURED_FIELDS);
+        writePieces(writer, table, player.infantry, TROOP_FIELDS);
+        writePieces(writer, table, player.cavalry, TROOP_FIELDS);
+        writePieces(writer, table, player.catapults, TROOP_FIELDS);
+        writePieces(writer, table, player.galleys, GALLEY_FIELDS);
+
+        writer.count(player.cities.size());
+        for (const SavedCity &city : player.cities) {
+            writer.position(city.row, city.col);
+            writer.count(table.indexOf(city.territory));
+            writer.byte(city.fortified ? 1 : 0);
+        }
+
+        writer.count(player.roads.size());
+        for (const SavedRoad &road : player.roads) {
+            writer.position(road.fromRow, road.fromCol);
+            writer.position(road.toRow, road.toCol);
+        }
+    }
+
+    return std::move(writer.data());
+}
+
+// ========== Reading ==========
+
+static const std::string &readString(ByteReader &reader, const std::vector<std::string> &strings)
+{
+    static const std::string empty;
+    uint64_t index = reader.count();
+    if (index >= strings.size()) {
+        reader.fail();
+        return empty;
+    }
+    return strings[index];
+}
+
+static void readPieces(ByteReader &reader, const std::vector<std::string> &strings, std::vector<SavedPiece> &pieces,
+                       const PieceFields &fields)
+{
+    pieces.resize(reader.items());
+    for (SavedPiece &piece : pieces) {
+        piece.serialNumber = reader.integer();
+        reader.position(piece.row, piece.col);
+        piece.territory = readString(reader, strings);
+        piece.movesRemaining = reader.integer();
+        if (fields.galley) {
+            piece.onGalley = reader.integer();
+        }
+        if (fields.number) {
+            piece.number = reader.integer();
+        }
+        if (fields.original) {
+            piece.originalPlayer = static_cast<char>(reader.byte());
+        }
+        if (fields.legion) {
+            reader.position(piece.lastRow, piece.lastCol);
+            piece.legion.resize(reader.items());
+            for (int &id : piece.legion) {
+                id = reader.integer();
+            }
+        }
+    }
+}
+
+bool SaveGame::fromBinary(const char *data, size_t size)
+{
+    if (!isBinary(data, size)) {
+        return false;
+    }
+
+    ByteReader reader(data + sizeof(BINARY_MAGIC), size - sizeof(BINARY_MAGIC));
+    int version = reader.byte();
+    if (version < 1 || version > BINARY_VERSION) {
+        return false;
+    }
+
+    std::vector<std::string> strings(reader.items());
+    for (std::string &text : strings) {
+        text = reader.text();
+    }
+
+    currentPlayerIndex = reader.integer();
+    hasRandomState = reader.byte() != 0;
+    randomState.clear();
+    if (hasRandomState) {
+        randomSeed = reader.word();
+        randomState.resize(reader.items());
+        for (uint64_t &word : randomState) {
+            word = reader.word();
+        }
+    }
+
+    for (SavedTerritory &territory : territories) {
+        territory.name = readString(reader, strings);
+        int packed = reader.integer();
+        territory.value = packed >> 1;
+        territory.isLand = (packed & 1) != 0;
+    }
+
+    players.resize(reader.items());
+    for (SavedPlayer &player : players) {
+        player.id = static_cast<char>(reader.byte());
+        player.wallet = reader.integer();
+        player.computer = reader.byte() != 0;
+        reader.position(player.homeRow, player.homeCol);
+        player.homeName = readString(reader, strings);
+
+        player.ownedTerritories.resize(reader.items());
+        for (std::string &name : player.ownedTerritories) {
+            name = readString(reader, strings);
+        }
+
+        readPieces(reader, strings, player.caesars, CAESAR_FIELDS);
+        readPieces(reader, strings, player.generals, GENERAL_FIELDS);
+        readPieces(reader, strings, player.capturedGenerals, CAPTURED_FIELDS);
+        readPieces(reader, strings, player.infantry, TROOP_FIELDS);
+        readPieces(reader, strings, player.cavalry, TROOP_FIELDS);
+        readPieces(reader, strings, player.catapults, TROOP_FIELDS);
+        readPieces(reader, strings, player.galleys, GALLEY_FIELDS);
+
+        player.cities.resize(reader.items());
+        for (SavedCity &city : player.cities) {
+            reader.position(city.row, city.col);
+            city.territory = readString(reader, strings);
+            city.fortified = reader.byte() != 0;
+        }
+
+        player.roads.resize(reader.items());
+        for (SavedRoad &road : player.roads) {
+            reader.position(road.fromRow, road.fromCol);
+            reader.position(road.toRow, road.toCol);
+        }
+    }
+
+    return reader.ok() && reader.atEnd();
+}
+
+// ========== Validation ==========
+
+static bool fail(std::string *error, const std::string &message)
+{
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+bool SaveGame::validate(std::string *error) const
+{
+    if (players.empty() || players.size() > static_cast<size_t>(MAX_PLAYERS)) {
+        return fail(error, "expected 1 to " + std::to_string(MAX_PLAYERS) + " players, found " + std::to_string(players.size()));
+    }
+    if (currentPlayerIndex < 0 || currentPlayerIndex >= static_cast<int>(players.size())) {
+        return fail(error, "current player " + std::to_string(currentPlayerIndex) + " is out of range");
+    }
+
+    std::unordered_set<std::string> names;
+    for (const SavedTerritory &territory : territories) {
+        names.insert(territory.name);
+    }
+
+    std::unordered_set<char> ids;
+    for (const SavedPlayer &player : players) {
+        std::string who = std::string("player ") + player.id;
+        if (player.id < 'A' || player.id >= 'A' + MAX_PLAYERS || !ids.insert(player.id).second) {
+            return fail(error, who + ": invalid or repeated id");
+        }
+        if (!isOnBoard(player.homeRow, player.homeCol)) {
+            return fail(error, who + ": home province is off the board");
+        }
+        if (player.wallet < 0) {
+            return fail(error, who + ": negative wallet");
+        }
+        for (const std::string &name : player.ownedTerritories) {
+            if (!names.count(name)) {
+                return fail(error, who + ": owns unknown territory \"" + name + "\"");
+            }
+        }
+
+        for (const std::vector<SavedPiece> *pieces : {&player.caesars, &player.generals, &player.capturedGenerals,
+                                                      &player.infantry, &player.cavalry, &player.catapults,
+                                                      &player.galleys}) {
+            for (const SavedPiece &piece : *pieces) {
+                if (!isOnBoard(piece.row, piece.col)) {
+                    return fail(error, who + ": piece " + std::to_string(piece.serialNumber) + " is off the board");
+                }
+            }
+        }
+        for (const SavedPiece &piece : player.capturedGenerals) {
+            if (piece.originalPlayer < 'A' || piece.originalPlayer >= 'A' + MAX_PLAYERS || piece.originalPlayer == player.id) {
+                return fail(error, who + ": captured general " + std::to_string(piece.serialNumber) + " has no valid owner");
+            }
+        }
+
+        for (const SavedCity &city : player.cities) {
+            if (!isOnBoard(city.row, city.col) || !territories[tileIndex(city.row, city.col)].isLand) {
+                return fail(error, who + ": city \"" + city.territory + "\" is not on a land tile");
+            }
+        }
+        for (const SavedRoad &road : player.roads) {
+            if (!isOnBoard(road.fromRow, road.fromCol) || !isOnBoard(road.toRow, road.toCol)) {
+                return fail(error, who + ": road is off the board");
+            }
+        }
+    }
+
+    return true;
+}
+
+// ========== From GameState ==========
+
+static SavedPiece savedPiece(const MapState &map, const PieceState &piece)
+{
+    SavedPiece saved;
+    saved.serialNumber = piece.id;
+    if (piece.tile != NO_TILE) {
+        saved.row = tileRow(piece.tile);
+        saved.col = tileColumn(piece.tile);
+        saved.territory = map.names[piece.tile];
+    }
+    saved.movesRemaining = piece.movesRemaining;
+    saved.onGalley = piece.galleyId;
+    saved.number = piece.generalNumber;
+    if (piece.lastTile != NO_TILE) {
+        saved.lastRow = tileRow(piece.lastTile);
+        saved.lastCol = tileColumn(piece.lastTile);
+    }
+    return saved;
+}
+
+SaveGame SaveGame::fromState(const GameState &state)
+{
+    SaveGame save;
+    const MapState &map = *state.map;
+    save.currentPlayerIndex = state.currentPlayer;
+
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        save.territories[tile].name = map.names[tile];
+        save.territories[tile].value = map.value[tile];
+        save.territories[tile].isLand = map.isLand(tile);
+    }
+
+    save.players.resize(state.players.size());
+    for (size_t i = 0; i < state.players.size(); ++i) {
+        const PlayerState &player = state.players[i];
+        SavedPlayer &saved = save.players[i];
+        saved.id = player.id;
+        saved.wallet = player.wallet;
+        if (player.homeTile != NO_TILE) {
+            saved.homeRow = tileRow(player.homeTile);
+            saved.homeCol = tileColumn(player.homeTile);
+            saved.homeName = map.names[player.homeTile];
+        }
+        player.owned.forEach([&](int tile) { saved.ownedTerritories.push_back(map.names[tile]); });
+
+        player.cities.forEach([&](int tile) {
+            SavedCity city;
+            city.row = tileRow(tile);
+            city.col = tileColumn(tile);
+            city.territory = map.names[tile];
+            city.fortified = player.fortifiedCities.test(tile);
+            saved.cities.push_back(city);
+        });
+
+        // Each road once, from its lower tile
+        for (int from = 0; from < BOARD_TILES; ++from) {
+            player.roads->neighbours(from).forEach([&](int to) {
+                if (to > from) {
+                    saved.roads.push_back({tileRow(from), tileColumn(from), tileRow(to), tileColumn(to)});
+                }
+            });
+        }
+    }
+
+    // Legions are stored on the leader or galley in the save, on the troop in the engine
+    for (size_t i = 0; i < state.players.size(); ++i) {
+        const std::vector<PieceState> &pieces = *state.players[i].pieces;
+        for (const PieceState &piece : pieces) {
+            SavedPiece saved = savedPiece(map, piece);
+            if (isLeaderKind(piece.kind) || piece.kind == PieceKind::Galley) {
+                for (const PieceState &other : pieces) {
+                    bool carried = piece.kind == PieceKind::Galley ? other.galleyId == piece.id : other.leaderId == piece.id;
+                    if (carried && other.capturedBy == NO_PLAYER) {
+                        saved.legion.push_back(other.id);
+                    }
+                }
+            }
+
+            SavedPlayer &owner = save.players[i];
+            if (piece.capturedBy != NO_PLAYER && piece.capturedBy < static_cast<int>(save.players.size())) {
+                saved.originalPlayer = owner.id;
+                saved.legion.clear();
+                saved.lastRow = -1;
+                saved.lastCol = -1;
+                save.players[piece.capturedBy].capturedGenerals.push_back(saved);
+                continue;
+            }
+
+            switch (piece.kind) {
+            case PieceKind::Caesar: owner.caesars.push_back(saved); break;
+            case PieceKind::General: owner.generals.push_back(saved); break;
+            case PieceKind::Infantry: owner.infantry.push_back(saved); break;
+            case PieceKind::Cavalry: owner.cavalry.push_back(saved); break;
+            case PieceKind::Catapult: owner.catapults.push_back(saved); break;
+            case PieceKind::Galley: owner.galleys.push_back(saved); break;
+            }
+        }
+    }
+
+    return save;
+}
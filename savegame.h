@@ -0,0 +1,115 @@
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tilemask.h"
+
+class GameState;
+
+// Contents of a save file as plain C++ data, the same fields as the JSON
+// save written by MapWidget::saveGame. Besides JSON (SaveGameJson) a save can
+// be stored in a compact binary form:
+//
+//   "CTES" magic, version byte
+//   string table: every territory and home province name once
+//   96 tiles: name index and (tax value << 1 | land), as varints
+//   players: fixed fields, owned territories, then one piece table per type,
+//            cities and roads, with positions as varint tile + 1 (0 = off board)
+//
+// All integers are LEB128 varints except the random state (little-endian
+// 64-bit words). The decoder only reads through a pointer and length, so
+// the file can be memory mapped instead of read (SaveGameJson::readFile).
+struct SavedPiece
+{
+    int serialNumber = 0;          // GamePiece::getUniqueId() when saved
+    int row = -1;
+    int col = -1;
+    std::string territory;
+    int movesRemaining = 0;
+    int onGalley = 0;              // Serial of the carrying galley (0 = not embarked)
+    int number = 0;                // Generals only
+    char originalPlayer = 0;       // Captured generals only: the general's own player
+    int lastRow = -1;              // Leaders and galleys: retreat tile (-1 = none)
+    int lastCol = -1;
+    std::vector<int> legion;       // Leaders and galleys: serials of the pieces they carry
+};
+
+struct SavedCity
+{
+    int row = -1;
+    int col = -1;
+    std::string territory;
+    bool fortified = false;
+};
+
+struct SavedRoad
+{
+    int fromRow = -1;
+    int fromCol = -1;
+    int toRow = -1;
+    int toCol = -1;
+};
+
+struct SavedPlayer
+{
+    char id = 'A';
+    int wallet = 0;
+    bool computer = false;
+    int homeRow = -1;
+    int homeCol = -1;
+    std::string homeName;
+    std::vector<std::string> ownedTerritories;
+
+    // Piece tables, one per type as in the JSON
+    std::vector<SavedPiece> caesars;
+    std::vector<SavedPiece> generals;
+    std::vector<SavedPiece> capturedGenerals;  // Held by this player
+    std::vector<SavedPiece> infantry;
+    std::vector<SavedPiece> cavalry;
+    std::vector<SavedPiece> catapults;
+    std::vector<SavedPiece> galleys;
+
+    std::vector<SavedCity> cities;
+    std::vector<SavedRoad> roads;
+};
+
+struct SavedTerritory
+{
+    std::string name;
+    int value = 0;
+    bool isLand = true;
+};
+
+struct SaveGame
+{
+    static constexpr int BINARY_VERSION = 1;
+
+    // True if the bytes start like a binary save (anything else is treated as JSON)
+    static bool isBinary(const char *data, size_t size);
+
+    std::vector<char> toBinary() const;
+
+    // Returns false (leaving a partly filled save) if the data is truncated, malformed
+    // or from a newer version
+    bool fromBinary(const char *data, size_t size);
+
+    // Save of an engine state; computer players and the random state are left for the caller
+    static SaveGame fromState(const GameState &state);
+
+    // Checks the save is consistent enough to load, without any widgets; on failure
+    // describes the first problem found in error
+    bool validate(std::string *error = nullptr) const;
+
+    int currentPlayerIndex = 0;
+    bool hasRandomState = false;   // Older saves carry no seed
+    uint64_t randomSeed = 0;
+    std::vector<uint64_t> randomState;
+    std::array<SavedTerritory, BOARD_TILES> territories;   // Row-major
+    std::vector<SavedPlayer> players;
+};
+
+#endif // SAVEGAME_H
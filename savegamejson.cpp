@@ -0,0 +1,353 @@
+#include "savegamejson.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+static QString serialString(int serial)
+{
+    return QString("%1").arg(serial, 5, 10, QChar('0'));
+}
+
+static QString toQString(const std::string &text)
+{
+    return QString::fromStdString(text);
+}
+
+static std::string toStdString(const QJsonValue &value)
+{
+    return value.toString().toStdString();
+}
+
+// ========== To JSON ==========
+
+static QJsonArray legionToJson(const std::vector<int> &legion)
+{
+    QJsonArray array;
+    for (int id : legion) {
+        array.append(id);
+    }
+    return array;
+}
+
+// Common fields of every piece object; the per-type extras are added by the caller
+static QJsonObject pieceToJson(const SavedPiece &piece)
+{
+    QJsonObject object;
+    object["serialNumber"] = serialString(piece.serialNumber);
+    object["row"] = piece.row;
+    object["col"] = piece.col;
+    object["territory"] = toQString(piece.territory);
+    object["movesRemaining"] = piece.movesRemaining;
+    return object;
+}
+
+static void galleyToJson(const SavedPiece &piece, QJsonObject &object)
+{
+    object["onGalley"] = piece.onGalley != 0 ? serialString(piece.onGalley) : QString();
+}
+
+static void legionToJson(const SavedPiece &piece, QJsonObject &object)
+{
+    object["legion"] = legionToJson(piece.legion);
+    if (piece.lastRow != -1) {
+        object["lastTerritoryRow"] = piece.lastRow;
+        object["lastTerritoryCol"] = piece.lastCol;
+    }
+}
+
+QJsonObject SaveGameJson::toJson(const SaveGame &save)
+{
+    QJsonObject gameState;
+    gameState["currentPlayerIndex"] = save.currentPlayerIndex;
+
+    if (save.hasRandomState) {
+        gameState["randomSeed"] = QString::number(save.randomSeed, 16);
+        QJsonArray randomStateArray;
+        for (uint64_t word : save.randomState) {
+            randomStateArray.append(QString::number(word, 16));
+        }
+        gameState["randomState"] = randomStateArray;
+    }
+
+    QJsonArray territoriesArray;
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        const SavedTerritory &territory = save.territories[tile];
+        QJsonObject territoryObj;
+        territoryObj["row"] = tileRow(tile);
+        territoryObj["col"] = tileColumn(tile);
+        territoryObj["name"] = toQString(territory.name);
+        territoryObj["value"] = territory.value;
+        territoryObj["isLand"] = territory.isLand;
+        territoriesArray.append(territoryObj);
+    }
+    gameState["territories"] = territoriesArray;
+
+    QJsonArray playersArray;
+    for (const SavedPlayer &player : save.players) {
+        QJsonObject playerObj;
+        playerObj["id"] = QString(QChar(player.id));
+        playerObj["wallet"] = player.wallet;
+        playerObj["computer"] = player.computer;
+        playerObj["homeRow"] = player.homeRow;
+        playerObj["homeCol"] = player.homeCol;
+        playerObj["homeName"] = toQString(player.homeName);
+
+        QJsonArray ownedArray;
+        for (const std::string &name : player.ownedTerritories) {
+            ownedArray.append(toQString(name));
+        }
+        playerObj["ownedTerritories"] = ownedArray;
+
+        QJsonArray caesarsArray;
+        for (const SavedPiece &piece : player.caesars) {
+            QJsonObject object = pieceToJson(piece);
+            galleyToJson(piece, object);
+            legionToJson(piece, object);
+            caesarsArray.append(object);
+        }
+        playerObj["caesars"] = caesarsArray;
+
+        QJsonArray generalsArray;
+        for (const SavedPiece &piece : player.generals) {
+            QJsonObject object = pieceToJson(piece);
+            object["number"] = piece.number;
+            galleyToJson(piece, object);
+            legionToJson(piece, object);
+            generalsArray.append(object);
+        }
+        playerObj["generals"] = generalsArray;
+
+        QJsonArray capturedArray;
+        for (const SavedPiece &piece : player.capturedGenerals) {
+            QJsonObject object = pieceToJson(piece);
+            object["originalPlayer"] = QString(QChar(piece.originalPlayer));
+            object["number"] = piece.number;
+            galleyToJson(piece, object);
+            capturedArray.append(object);
+        }
+        playerObj["capturedGenerals"] = capturedArray;
+
+        const std::pair<const char*, const std::vector<SavedPiece>*> troopTables[] = {
+            {"infantry", &player.infantry}, {"cavalry", &player.cavalry}, {"catapults", &player.catapults}
+        };
+        for (const auto &table : troopTables) {
+            QJsonArray troopsArray;
+            for (const SavedPiece &piece : *table.second) {
+                QJsonObject object = pieceToJson(piece);
+                galleyToJson(piece, object);
+                troopsArray.append(object);
+            }
+            playerObj[table.first] = troopsArray;
+        }
+
+        QJsonArray galleysArray;
+        for (const SavedPiece &piece : player.galleys) {
+            QJsonObject object = pieceToJson(piece);
+            legionToJson(piece, object);
+            galleysArray.append(object);
+        }
+        playerObj["galleys"] = galleysArray;
+
+        QJsonArray citiesArray;
+        for (const SavedCity &city : player.cities) {
+            QJsonObject cityObj;
+            cityObj["row"] = city.row;
+            cityObj["col"] = city.col;
+            cityObj["territory"] = toQString(city.territory);
+            cityObj["isFortified"] = city.fortified;
+            citiesArray.append(cityObj);
+        }
+        playerObj["cities"] = citiesArray;
+
+        QJsonArray roadsArray;
+        for (const SavedRoad &road : player.roads) {
+            QJsonObject roadObj;
+            roadObj["fromRow"] = road.fromRow;
+            roadObj["fromCol"] = road.fromCol;
+            roadObj["toRow"] = road.toRow;
+            roadObj["toCol"] = road.toCol;
+            roadsArray.append(roadObj);
+        }
+        playerObj["roads"] = roadsArray;
+
+        playersArray.append(playerObj);
+    }
+    gameState["players"] = playersArray;
+
+    return gameState;
+}
+
+// ========== From JSON ==========
+
+// Defaults match the original loader in main.cpp
+static SavedPiece pieceFromJson(const QJsonObject &object)
+{
+    SavedPiece piece;
+    piece.serialNumber = object["serialNumber"].toString().toInt();
+    piece.row = object["row"].toInt(0);
+    piece.col = object["col"].toInt(0);
+    piece.territory = toStdString(object["territory"]);
+    piece.movesRemaining = object["movesRemaining"].toInt(0);
+    piece.onGalley = object["onGalley"].toString().toInt();
+    piece.number = object["number"].toInt(1);
+    piece.originalPlayer = object["originalPlayer"].toString().toLatin1().value(0, 0);
+    if (object.contains("lastTerritoryRow")) {
+        piece.lastRow = object["lastTerritoryRow"].toInt(-1);
+        piece.lastCol = object["lastTerritoryCol"].toInt(-1);
+    }
+    for (const QJsonValue &id : object["legion"].toArray()) {
+        piece.legion.push_back(id.toInt());
+    }
+    return piece;
+}
+
+static std::vector<SavedPiece> piecesFromJson(const QJsonValue &value)
+{
+    std::vector<SavedPiece> pieces;
+    for (const QJsonValue &pieceValue : value.toArray()) {
+        pieces.push_back(pieceFromJson(pieceValue.toObject()));
+    }
+    return pieces;
+}
+
+SaveGame SaveGameJson::fromJson(const QJsonObject &gameState)
+{
+    SaveGame save;
+    save.currentPlayerIndex = gameState["currentPlayerIndex"].toInt(0);
+
+    bool seedOk = false;
+    save.randomSeed = gameState["randomSeed"].toString().toULongLong(&seedOk, 16);
+    save.hasRandomState = seedOk;
+    for (const QJsonValue &word : gameState["randomState"].toArray()) {
+        save.randomState.push_back(word.toString().toULongLong(nullptr, 16));
+    }
+
+    for (const QJsonValue &territoryValue : gameState["territories"].toArray()) {
+        QJsonObject territoryObj = territoryValue.toObject();
+        int row = territoryObj["row"].toInt(0);
+        int col = territoryObj["col"].toInt(0);
+        if (!isOnBoard(row, col)) {
+            continue;
+        }
+        SavedTerritory &territory = save.territories[tileIndex(row, col)];
+        territory.name = toStdString(territoryObj["name"]);
+        territory.value = territoryObj["value"].toInt(0);
+        territory.isLand = territoryObj["isLand"].toBool(true);
+    }
+
+    for (const QJsonValue &playerValue : gameState["players"].toArray()) {
+        QJsonObject playerObj = playerValue.toObject();
+        SavedPlayer player;
+        player.id = playerObj["id"].toString().toLatin1().value(0, 'A');
+        player.wallet = playerObj["wallet"].toInt(0);
+        player.computer = playerObj["computer"].toBool(false);
+        player.homeRow = playerObj["homeRow"].toInt(0);
+        player.homeCol = playerObj["homeCol"].toInt(0);
+        player.homeName = toStdString(playerObj["homeName"]);
+
+        for (const QJsonValue &name : playerObj["ownedTerritories"].toArray()) {
+            player.ownedTerritories.push_back(toStdString(name));
+        }
+
+        player.caesars = piecesFromJson(playerObj["caesars"]);
+        player.generals = piecesFromJson(playerObj["generals"]);
+        player.capturedGenerals = piecesFromJson(playerObj["capturedGenerals"]);
+        player.infantry = piecesFromJson(playerObj["infantry"]);
+        player.cavalry = piecesFromJson(playerObj["cavalry"]);
+        player.catapults = piecesFromJson(playerObj["catapults"]);
+        player.galleys = piecesFromJson(playerObj["galleys"]);
+
+        for (const QJsonValue &cityValue : playerObj["cities"].toArray()) {
+            QJsonObject cityObj = cityValue.toObject();
+            SavedCity city;
+            city.row = cityObj["row"].toInt(0);
+            city.col = cityObj["col"].toInt(0);
+            city.territory = toStdString(cityObj["territory"]);
+            city.fortified = cityObj["isFortified"].toBool(false);
+            player.cities.push_back(city);
+        }
+
+        for (const QJsonValue &roadValue : playerObj["roads"].toArray()) {
+            QJsonObject roadObj = roadValue.toObject();
+            SavedRoad road;
+            road.fromRow = roadObj["fromRow"].toInt(0);
+            road.fromCol = roadObj["fromCol"].toInt(0);
+            road.toRow = roadObj["toRow"].toInt(0);
+            road.toCol = roadObj["toCol"].toInt(0);
+            player.roads.push_back(road);
+        }
+
+        save.players.push_back(player);
+    }
+
+    return save;
+}
+
+// ========== Files ==========
+
+bool SaveGameJson::isBinaryFileName(const QString &fileName)
+{
+    return QFileInfo(fileName).suffix().compare(BINARY_EXTENSION, Qt::CaseInsensitive) == 0;
+}
+
+static bool isCompressed(const QByteArray &data)
+{
+    return data.startsWith(SaveGameJson::COMPRESSED_MAGIC);
+}
+
+bool SaveGameJson::isBinaryData(const QByteArray &data)
+{
+    return isCompressed(data) || SaveGame::isBinary(data.constData(), static_cast<size_t>(data.size()));
+}
+
+bool SaveGameJson::read(const QByteArray &data, SaveGame &save)
+{
+    if (isCompressed(data)) {
+        int headerSize = static_cast<int>(qstrlen(COMPRESSED_MAGIC));
+        QByteArray raw = qUncompress(reinterpret_cast<const uchar*>(data.constData()) + headerSize, data.size() - headerSize);
+        return SaveGame::isBinary(raw.constData(), static_cast<size_t>(raw.size()))
+            && save.fromBinary(raw.constData(), static_cast<size_t>(raw.size()));
+    }
+    if (SaveGame::isBinary(data.constData(), static_cast<size_t>(data.size()))) {
+        return save.fromBinary(data.constData(), static_cast<size_t>(data.size()));
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (doc.isNull() || !doc.isObject()) {
+        return false;
+    }
+    save = fromJson(doc.object());
+    return true;
+}
+
+bool SaveGameJson::readFile(const QString &fileName, SaveGame &save)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // The mapping stays valid until the file is closed; fromRawData wraps it without copying
+    qint64 size = file.size();
+    uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (!mapped) {
+        return read(file.readAll(), save);
+    }
+
+    bool ok = read(QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), static_cast<int>(size)), save);
+    file.unmap(mapped);
+    return ok;
+}
+
+QByteArray SaveGameJson::write(const SaveGame &save, bool binary, bool compress)
+{
+    if (binary) {
+        std::vector<char> bytes = save.toBinary();
+        if (compress) {
+            return QByteArray(COMPRESSED_MAGIC) + qCompress(reinterpret_cast<const uchar*>(bytes.data()), static_cast<int>(bytes.size()));
+        }
+        return QByteArray(bytes.data(), static_cast<int>(bytes.size()));
+    }
+    return QJsonDocument(toJson(save)).toJson();
+}
@@ -0,0 +1,36 @@
+#ifndef SAVEGAMEJSON_H
+#define SAVEGAMEJSON_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include "savegame.h"
+
+// Converts SaveGame to and from the JSON save layout (the original format),
+// and reads or writes either format
+class SaveGameJson
+{
+public:
+    // Binary saves use this extension; anything else is written as JSON
+    static constexpr const char *BINARY_EXTENSION = "ctes";
+    static bool isBinaryFileName(const QString &fileName);
+
+    // Compressed binary saves (archives) are zlib data behind this magic; both kinds load
+    static constexpr const char *COMPRESSED_MAGIC = "CTEZ";
+    static bool isBinaryData(const QByteArray &data);
+
+    static QJsonObject toJson(const SaveGame &save);
+    static SaveGame fromJson(const QJsonObject &object);
+
+    // Detects the format from the data itself, so renamed files still load
+    static bool read(const QByteArray &data, SaveGame &save);
+
+    // Maps the file read-only and decodes straight from the mapping (reads it if mapping fails)
+    static bool readFile(const QString &fileName, SaveGame &save);
+
+    // Binary output is plain by default, so readFile can decode it straight from the mapping;
+    // compress trades that for a smaller file. JSON stays plain text so it can be read and edited
+    static QByteArray write(const SaveGame &save, bool binary, bool compress = false);
+};
+
+#endif // SAVEGAMEJSON_H
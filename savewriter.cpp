@@ -0,0 +1,49 @@
+#include "savewriter.h"
+#include "savegamejson.h"
+#include <QSaveFile>
+
+// Encoding is the first half of the progress bar, writing the second
+static constexpr int ENCODED_PERCENT = 50;
+static constexpr int WRITE_CHUNK = 64 * 1024;
+
+SaveWriter::SaveWriter(const SaveGame &save, const QString &fileName, QObject *parent)
+    : QThread(parent)
+    , m_save(save)
+    , m_fileName(fileName)
+{
+}
+
+void SaveWriter::run()
+{
+    emit progress(0);
+
+    // The extension picks the format; loading detects it from the contents
+    QByteArray data = SaveGameJson::write(m_save, SaveGameJson::isBinaryFileName(m_fileName));
+    emit progress(ENCODED_PERCENT);
+
+    // QSaveFile writes to a temporary file and renames it over the target on commit()
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit saved(false, file.errorString());
+        return;
+    }
+
+    for (int offset = 0; offset < data.size(); offset += WRITE_CHUNK) {
+        int length = qMin(WRITE_CHUNK, data.size() - offset);
+        if (file.write(data.constData() + offset, length) != length) {
+            QString error = file.errorString();
+            file.cancelWriting();
+            emit saved(false, error);
+            return;
+        }
+        emit progress(ENCODED_PERCENT + static_cast<int>(qint64(100 - ENCODED_PERCENT) * (offset + length) / data.size()));
+    }
+
+    if (!file.commit()) {
+        emit saved(false, file.errorString());
+        return;
+    }
+
+    emit progress(100);
+    emit saved(true, QString());
+}
@@ -0,0 +1,34 @@
+#ifndef SAVEWRITER_H
+#define SAVEWRITER_H
+
+#include <QThread>
+#include <QString>
+#include "savegame.h"
+
+// Writes a save on its own thread so a large game doesn't freeze the map.
+// The SaveGame is a plain value copied out of the widgets before the thread
+// starts, so nothing here touches them. The file is encoded and written
+// beside the target, then renamed over it only
+// once complete, so a failed save never leaves a truncated file behind.
+class SaveWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    SaveWriter(const SaveGame &save, const QString &fileName, QObject *parent = nullptr);
+
+    const QString &fileName() const { return m_fileName; }
+
+signals:
+    void progress(int percent);
+    void saved(bool ok, const QString &error);  // Last thing run() does
+
+protected:
+    void run() override;
+
+private:
+    const SaveGame m_save;
+    const QString m_fileName;
+};
+
+#endif // SAVEWRITER_H
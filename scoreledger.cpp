@@ -0,0 +1,96 @@
+#include "scoreledger.h"
+#include "mapwidget.h"
+#include "player.h"
+#include "building.h"
+#include "rulesengine.h"
+#include <QDebug>
+
+ScoreLedger::ScoreLedger(const MapWidget *mapWidget, QObject *parent)
+    : QObject(parent)
+    , m_mapWidget(mapWidget)
+{
+}
+
+void ScoreLedger::setPlayers(const QList<Player*> &players)
+{
+    for (Player *player : m_players) {
+        disconnect(player, nullptr, this, nullptr);
+    }
+    m_players = players;
+
+    for (Player *player : m_players) {
+        connect(player, &Player::territoryClaimed, this, [this, player](TerritoryId territory) {
+            adjust(player, m_mapWidget->getTerritoryValue(territory), 0);
+        });
+        connect(player, &Player::territoryUnclaimed, this, [this, player](TerritoryId territory) {
+            adjust(player, -m_mapWidget->getTerritoryValue(territory), 0);
+        });
+        connect(player, &Player::territoriesCleared, this, [this, player]() {
+            adjust(player, -getTerritoryIncome(player->getId()), 0);
+        });
+        connect(player, &Player::buildingAdded, this, [this, player](Building *building) {
+            if (building->getType() == Building::Type::City) {
+                adjust(player, 0, RulesEngine::CITY_TAX);
+            }
+        });
+        connect(player, &Player::buildingRemoved, this, [this, player](Building *building) {
+            if (building->getType() == Building::Type::City) {
+                adjust(player, 0, -RulesEngine::CITY_TAX);
+            }
+        });
+    }
+
+    rebuild();
+}
+
+void ScoreLedger::rebuild()
+{
+    m_entries.clear();
+    for (Player *player : m_players) {
+        m_entries[player->getId()] = recompute(player);
+    }
+    emit scoresChanged();
+}
+
+QMap<QChar, int> ScoreLedger::getScores() const
+{
+    QMap<QChar, int> scores;
+    for (char c = 'A'; c <= 'F'; ++c) {
+        scores[QChar(c)] = getTaxIncome(QChar(c));
+    }
+    return scores;
+}
+
+ScoreLedger::Entry ScoreLedger::recompute(const Player *player) const
+{
+    Entry entry;
+    entry.territoryIncome = RulesEngine::territoryIncome(m_mapWidget->getTileValues(), player->getOwnedTerritoryMask());
+    entry.cityIncome = RulesEngine::cityIncome(player->getCityTiles());
+    return entry;
+}
+
+void ScoreLedger::adjust(const Player *player, int territoryDelta, int cityDelta)
+{
+    Entry &entry = m_entries[player->getId()];
+    entry.territoryIncome += territoryDelta;
+    entry.cityIncome += cityDelta;
+
+    verify(player);
+    emit scoresChanged();
+}
+
+void ScoreLedger::verify(const Player *player) const
+{
+#ifdef QT_DEBUG
+    Entry expected = recompute(player);
+    Entry actual = m_entries.value(player->getId());
+    if (expected.territoryIncome != actual.territoryIncome || expected.cityIncome != actual.cityIncome) {
+        qWarning() << "ScoreLedger out of sync for player" << player->getId()
+                   << "- territories" << actual.territoryIncome << "expected" << expected.territoryIncome
+                   << "cities" << actual.cityIncome << "expected" << expected.cityIncome;
+        Q_ASSERT_X(false, "ScoreLedger::verify", "incremental ledger disagrees with full recompute");
+    }
+#else
+    Q_UNUSED(player);
+#endif
+}
@@ -0,0 +1,56 @@
+#ifndef SCORELEDGER_H
+#define SCORELEDGER_H
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include "common.h"
+
+class MapWidget;
+class Player;
+
+// Running per-player score/tax income (territory values + city tax), which is also what
+// Player::collectTaxes pays. Updated from the Player ownership and building signals instead
+// of rescanning the map; debug builds check every update against a full recompute with
+// RulesEngine's income formula.
+class ScoreLedger : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ScoreLedger(const MapWidget *mapWidget, QObject *parent = nullptr);
+
+    // Track these players (rebuilds the ledger and connects to their signals)
+    void setPlayers(const QList<Player*> &players);
+
+    // Recompute every entry from scratch (after territory values change, e.g. loading a map)
+    void rebuild();
+
+    // Income from territories, from cities, and the total (which is also the score)
+    int getTerritoryIncome(QChar player) const { return m_entries.value(player).territoryIncome; }
+    int getCityIncome(QChar player) const { return m_entries.value(player).cityIncome; }
+    int getTaxIncome(QChar player) const { return getTerritoryIncome(player) + getCityIncome(player); }
+
+    // Scores for 'A'-'F' (0 for absent players)
+    QMap<QChar, int> getScores() const;
+
+signals:
+    void scoresChanged();
+
+private:
+    struct Entry {
+        int territoryIncome = 0;
+        int cityIncome = 0;
+    };
+
+    Entry recompute(const Player *player) const;
+    void adjust(const Player *player, int territoryDelta, int cityDelta);
+    void verify(const Player *player) const;
+
+    const MapWidget *m_mapWidget;
+    QList<Player*> m_players;
+    QHash<QChar, Entry> m_entries;
+};
+
+#endif // SCORELEDGER_H
@@ -0,0 +1,483 @@
+#include "staterecord.h"
+
+static_assert(std::tuple_size<StateRecord::RandomState>::value <= 64, "changed random words are flagged in one 64-bit mask");
+
+// Record types
+enum : uint8_t {
+    SNAPSHOT_RECORD = 0,
+    ACTION_RECORD = 1
+};
+
+// Which parts of a player an action record carries
+enum : uint8_t {
+    PLAYER_SCALARS = 1,       // Eliminated, wallet, home
+    PLAYER_TERRITORIES = 2,
+    PLAYER_CITIES = 4,        // Cities and fortifications
+    PLAYER_PIECE_EDITS = 8,   // Same pieces, some changed
+    PLAYER_PIECE_LIST = 16,   // Pieces added or removed: the whole list
+    PLAYER_ROADS = 32
+};
+
+// FNV-1a; enough to tell a torn or half-written record from a good one
+static uint32_t checksum(const char *data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+static void writePiece(ByteWriter &writer, const PieceState &piece)
+{
+    writer.integer(piece.id);
+    writer.byte(static_cast<uint8_t>(piece.kind));
+    writer.tile(piece.tile);
+    writer.tile(piece.lastTile);
+    writer.integer(piece.movesRemaining);
+    writer.integer(piece.generalNumber);
+    writer.integer(piece.capturedBy);
+    writer.integer(piece.leaderId);
+    writer.integer(piece.galleyId);
+}
+
+static void writePieces(ByteWriter &writer, const std::vector<PieceState> &pieces)
+{
+    writer.count(pieces.size());
+    for (const PieceState &piece : pieces) {
+        writePiece(writer, piece);
+    }
+}
+
+static void writeRoads(ByteWriter &writer, const RoadNetwork &roads)
+{
+    writer.count(roads.roadCount());
+    for (int from = 0; from < BOARD_TILES; ++from) {
+        roads.neighbours(from).forEach([&](int to) {
+            if (to > from) {
+                writer.tile(from);
+                writer.tile(to);
+            }
+        });
+    }
+}
+
+static void writeScalars(ByteWriter &writer, const PlayerState &player)
+{
+    writer.byte(player.eliminated ? 1 : 0);
+    writer.integer(player.wallet);
+    writer.tile(player.homeTile);
+}
+
+static void writeRandom(ByteWriter &writer, const StateRecord::Extras &extras, const StateRecord::Extras *previous)
+{
+    // Only the stream words that moved since the previous record
+    uint64_t changed = 0;
+    for (size_t i = 0; i < extras.randomState.size(); ++i) {
+        if (!previous || extras.randomState[i] != previous->randomState[i]) {
+            changed |= 1ULL << i;
+        }
+    }
+    writer.count(changed);
+    for (size_t i = 0; i < extras.randomState.size(); ++i) {
+        if (changed & (1ULL << i)) {
+            writer.word(extras.randomState[i]);
+        }
+    }
+}
+
+static void writeGlobals(ByteWriter &writer, const GameState &state)
+{
+    writer.integer(state.currentPlayer);
+    writer.integer(state.turnNumber);
+    writer.integer(state.pieceCounter);
+    writer.integer(state.inflationMultiplier);
+}
+
+// ========== Digest ==========
+
+static void mix(uint64_t &hash, uint64_t value)
+{
+    hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 32;
+}
+
+static void mix(uint64_t &hash, const TileMask &mask)
+{
+    mix(hash, mask.lowWord());
+    mix(hash, mask.highWord());
+}
+
+uint64_t StateRecord::digest(const GameState &state)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    mix(hash, static_cast<uint64_t>(state.currentPlayer));
+    mix(hash, static_cast<uint64_t>(state.turnNumber));
+    mix(hash, static_cast<uint64_t>(state.pieceCounter));
+    mix(hash, static_cast<uint64_t>(state.inflationMultiplier));
+    mix(hash, state.map->land);
+
+    for (const PlayerState &player : state.players) {
+        mix(hash, static_cast<uint64_t>(player.id));
+        mix(hash, player.eliminated ? 1 : 0);
+        mix(hash, static_cast<uint64_t>(player.wallet));
+        mix(hash, static_cast<uint64_t>(player.homeTile));
+        mix(hash, player.owned);
+        mix(hash, player.cities);
+        mix(hash, player.fortifiedCities);
+
+        mix(hash, player.pieces->size());
+        for (const PieceState &piece : *player.pieces) {
+            mix(hash, static_cast<uint64_t>(piece.id));
+            mix(hash, (static_cast<uint64_t>(piece.kind) << 32) | static_cast<uint32_t>(piece.tile));
+            mix(hash, (static_cast<uint64_t>(static_cast<uint32_t>(piece.lastTile)) << 32) | static_cast<uint32_t>(piece.movesRemaining));
+            mix(hash, (static_cast<uint64_t>(static_cast<uint32_t>(piece.generalNumber)) << 32) | static_cast<uint32_t>(piece.capturedBy));
+            mix(hash, (static_cast<uint64_t>(static_cast<uint32_t>(piece.leaderId)) << 32) | static_cast<uint32_t>(piece.galleyId));
+        }
+
+        const RoadNetwork &roads = *player.roads;
+        mix(hash, roads.roadCount());
+        for (int tile = 0; tile < BOARD_TILES; ++tile) {
+            mix(hash, roads.neighbours(tile));
+        }
+    }
+    return hash;
+}
+
+// ========== Encoding ==========
+
+std::vector<char> StateRecord::encodeSnapshot(const GameState &state, const Extras &extras)
+{
+    ByteWriter writer;
+    writer.byte(SNAPSHOT_RECORD);
+    writer.count(extras.computer.size());
+    for (bool computer : extras.computer) {
+        writer.byte(computer ? 1 : 0);
+    }
+    writer.byte(extras.atStartOfTurn ? 1 : 0);
+    writer.word(extras.randomSeed);
+    writeRandom(writer, extras, nullptr);
+    writeGlobals(writer, state);
+
+    const MapState &map = *state.map;
+    writer.mask(map.land);
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        writer.text(map.names[tile]);
+        writer.integer(map.value[tile]);
+    }
+
+    writer.count(state.players.size());
+    for (const PlayerState &player : state.players) {
+        writer.byte(static_cast<uint8_t>(player.id));
+        writeScalars(writer, player);
+        writer.mask(player.owned);
+        writer.mask(player.cities);
+        writer.mask(player.fortifiedCities);
+        writePieces(writer, *player.pieces);
+        writeRoads(writer, *player.roads);
+    }
+    writer.word(digest(state));
+    return std::move(writer.data());
+}
+
+static bool sameMap(const MapState &a, const MapState &b)
+{
+    return &a == &b || (a.land == b.land && a.value == b.value && a.names == b.names);
+}
+
+bool StateRecord::encodeAction(const GameState &before, const Extras &beforeExtras, const GameState &after,
+                               const Extras &extras, const std::string &label, std::vector<char> &out)
+{
+    if (before.players.size() != after.players.size() || !sameMap(*before.map, *after.map)) {
+        return false;
+    }
+
+    ByteWriter writer;
+    writer.byte(ACTION_RECORD);
+    writer.text(label);
+    writer.byte(extras.atStartOfTurn ? 1 : 0);
+    writeRandom(writer, extras, &beforeExtras);
+    writeGlobals(writer, after);
+
+    ByteWriter players;
+    int changedPlayers = 0;
+    for (size_t i = 0; i < after.players.size(); ++i) {
+        const PlayerState &a = before.players[i];
+        const PlayerState &b = after.players[i];
+        if (a.id != b.id) {
+            return false;
+        }
+
+        uint8_t flags = 0;
+        if (a.eliminated != b.eliminated || a.wallet != b.wallet || a.homeTile != b.homeTile) {
+            flags |= PLAYER_SCALARS;
+        }
+        if (a.owned != b.owned) {
+            flags |= PLAYER_TERRITORIES;
+        }
+        if (a.cities != b.cities || a.fortifiedCities != b.fortifiedCities) {
+            flags |= PLAYER_CITIES;
+        }
+
+        std::vector<size_t> edits;
+        const std::vector<PieceState> &piecesA = *a.pieces;
+        const std::vector<PieceState> &piecesB = *b.pieces;
+        if (!a.pieces.isSharedWith(b.pieces)) {
+            bool sameIds = piecesA.size() == piecesB.size();
+            for (size_t p = 0; sameIds && p < piecesB.size(); ++p) {
+                sameIds = piecesA[p].id == piecesB[p].id;
+                if (sameIds && piecesA[p] != piecesB[p]) {
+                    edits.push_back(p);
+                }
+            }
+            if (!sameIds) {
+                flags |= PLAYER_PIECE_LIST;
+            } else if (!edits.empty()) {
+                flags |= PLAYER_PIECE_EDITS;
+            }
+        }
+        if (!a.roads.isSharedWith(b.roads) && *a.roads != *b.roads) {
+            flags |= PLAYER_ROADS;
+        }
+        if (!flags) {
+            continue;
+        }
+
+        ++changedPlayers;
+        players.count(i);
+        players.byte(flags);
+        if (flags & PLAYER_SCALARS) {
+            writeScalars(players, b);
+        }
+        if (flags & PLAYER_TERRITORIES) {
+            players.mask(b.owned);
+        }
+        if (flags & PLAYER_CITIES) {
+            players.mask(b.cities);
+            players.mask(b.fortifiedCities);
+        }
+        if (flags & PLAYER_PIECE_EDITS) {
+            players.count(edits.size());
+            for (size_t p : edits) {
+                players.count(p);
+                writePiece(players, piecesB[p]);
+            }
+        }
+        if (flags & PLAYER_PIECE_LIST) {
+            writePieces(players, piecesB);
+        }
+        if (flags & PLAYER_ROADS) {
+            writeRoads(players, *b.roads);
+        }
+    }
+
+    players.word(digest(after));
+
+    writer.count(changedPlayers);
+    out = std::move(writer.data());
+    out.insert(out.end(), players.data().begin(), players.data().end());
+    return true;
+}
+
+// ========== Decoding ==========
+
+static PieceState readPiece(ByteReader &reader)
+{
+    PieceState piece;
+    piece.id = reader.integer();
+    uint8_t kind = reader.byte();
+    if (kind > static_cast<uint8_t>(PieceKind::Galley)) {
+        reader.fail();
+    }
+    piece.kind = static_cast<PieceKind>(kind);
+    piece.tile = reader.tile();
+    piece.lastTile = reader.tile();
+    piece.movesRemaining = reader.integer();
+    piece.generalNumber = reader.integer();
+    piece.capturedBy = reader.integer();
+    piece.leaderId = reader.integer();
+    piece.galleyId = reader.integer();
+    return piece;
+}
+
+static void readPieces(ByteReader &reader, std::vector<PieceState> &pieces)
+{
+    pieces.resize(reader.items());
+    for (PieceState &piece : pieces) {
+        piece = readPiece(reader);
+    }
+}
+
+static void readRoads(ByteReader &reader, RoadNetwork &roads)
+{
+    roads.clear();
+    size_t count = reader.items();
+    for (size_t i = 0; i < count && reader.ok(); ++i) {
+        int from = reader.tile();
+        int to = reader.tile();
+        roads.addRoad(from, to);
+    }
+}
+
+static void readScalars(ByteReader &reader, PlayerState &player)
+{
+    player.eliminated = reader.byte() != 0;
+    player.wallet = reader.integer();
+    player.homeTile = reader.tile();
+}
+
+static void readRandom(ByteReader &reader, StateRecord::Extras &extras)
+{
+    uint64_t changed = reader.count();
+    for (size_t i = 0; i < extras.randomState.size(); ++i) {
+        if (changed & (1ULL << i)) {
+            extras.randomState[i] = reader.word();
+        }
+    }
+}
+
+static void readGlobals(ByteReader &reader, GameState &state)
+{
+    state.currentPlayer = reader.integer();
+    state.turnNumber = reader.integer();
+    state.pieceCounter = reader.integer();
+    state.inflationMultiplier = reader.integer();
+}
+
+// Every record ends with the digest of the state it was made from; a decoder
+// bug or a damaged record that slipped past the checksum doesn't match it
+static bool checkDigest(ByteReader &reader, const GameState &state, uint64_t *stateDigest)
+{
+    uint64_t stored = reader.word();
+    if (stateDigest) {
+        *stateDigest = stored;
+    }
+    return reader.ok() && reader.atEnd() && stored == StateRecord::digest(state);
+}
+
+bool StateRecord::isSnapshot(const char *payload, size_t size)
+{
+    return size > 0 && static_cast<uint8_t>(payload[0]) == SNAPSHOT_RECORD;
+}
+
+bool StateRecord::decodeSnapshot(const char *payload, size_t size, GameState &state, Extras &extras, uint64_t *stateDigest)
+{
+    ByteReader reader(payload, size);
+    if (reader.byte() != SNAPSHOT_RECORD) {
+        return false;
+    }
+
+    extras.computer.resize(reader.items());
+    for (size_t i = 0; i < extras.computer.size(); ++i) {
+        extras.computer[i] = reader.byte() != 0;
+    }
+    extras.atStartOfTurn = reader.byte() != 0;
+    extras.randomSeed = reader.word();
+    readRandom(reader, extras);
+
+    state = GameState();
+    readGlobals(reader, state);
+
+    MapState &map = state.map.write();
+    map.land = reader.mask();
+    for (int tile = 0; tile < BOARD_TILES; ++tile) {
+        map.names[tile] = reader.text();
+        map.value[tile] = reader.integer();
+    }
+
+    size_t playerCount = reader.items();
+    if (playerCount > static_cast<size_t>(MAX_PLAYERS)) {
+        return false;
+    }
+    state.players.resize(playerCount);
+    for (PlayerState &player : state.players) {
+        player.id = static_cast<char>(reader.byte());
+        readScalars(reader, player);
+        player.owned = reader.mask();
+        player.cities = reader.mask();
+        player.fortifiedCities = reader.mask();
+        readPieces(reader, player.pieces.write());
+        readRoads(reader, player.roads.write());
+    }
+    return checkDigest(reader, state, stateDigest);
+}
+
+bool StateRecord::applyAction(const char *payload, size_t size, GameState &state, Extras &extras, uint64_t *stateDigest)
+{
+    ByteReader reader(payload, size);
+    if (reader.byte() != ACTION_RECORD) {
+        return false;
+    }
+
+    reader.text();  // Label
+    extras.atStartOfTurn = reader.byte() != 0;
+    readRandom(reader, extras);
+    readGlobals(reader, state);
+
+    size_t changedPlayers = reader.items();
+    for (size_t c = 0; c < changedPlayers && reader.ok(); ++c) {
+        size_t index = reader.count();
+        if (index >= state.players.size()) {
+            return false;
+        }
+        PlayerState &player = state.players[index];
+        uint8_t flags = reader.byte();
+        if (flags & PLAYER_SCALARS) {
+            readScalars(reader, player);
+        }
+        if (flags & PLAYER_TERRITORIES) {
+            player.owned = reader.mask();
+        }
+        if (flags & PLAYER_CITIES) {
+            player.cities = reader.mask();
+            player.fortifiedCities = reader.mask();
+        }
+        if (flags & PLAYER_PIECE_EDITS) {
+            std::vector<PieceState> &pieces = player.pieces.write();
+            size_t edits = reader.items();
+            for (size_t e = 0; e < edits && reader.ok(); ++e) {
+                size_t p = reader.count();
+                if (p >= pieces.size()) {
+                    return false;
+                }
+                pieces[p] = readPiece(reader);
+            }
+        }
+        if (flags & PLAYER_PIECE_LIST) {
+            readPieces(reader, player.pieces.write());
+        }
+        if (flags & PLAYER_ROADS) {
+            readRoads(reader, player.roads.write());
+        }
+    }
+    return checkDigest(reader, state, stateDigest);
+}
+
+// ========== Framing ==========
+
+void StateRecord::appendFrame(std::vector<char> &out, const std::vector<char> &payload)
+{
+    ByteWriter writer;
+    writer.count(payload.size());
+    out.insert(out.end(), writer.data().begin(), writer.data().end());
+    out.insert(out.end(), payload.begin(), payload.end());
+    uint32_t sum = checksum(payload.data(), payload.size());
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>(sum >> (8 * i)));
+    }
+}
+
+bool StateRecord::readFrame(ByteReader &reader, const char *&payload, size_t &size)
+{
+    size = reader.count();
+    if (!reader.ok() || size + 4 > reader.remaining()) {
+        return false;
+    }
+    payload = reader.current();
+    reader.skip(size);
+    uint32_t stored = 0;
+    for (int i = 0; i < 4; ++i) {
+        stored |= static_cast<uint32_t>(reader.byte()) << (8 * i);
+    }
+    return stored == checksum(payload, size);
+}
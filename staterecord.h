@@ -0,0 +1,58 @@
+#ifndef STATERECORD_H
+#define STATERECORD_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include "bytestream.h"
+#include "gamerandom.h"
+#include "gamestate.h"
+
+// Binary records of GameStates, shared by the autosave journal and replays.
+// A snapshot holds a whole state; an action holds only what changed since
+// the state before it (the players it touched, whose turn it is, the random
+// streams so dice rolled afterwards match). Records are framed as length,
+// payload and checksum so a torn or damaged one is recognised. Every record
+// ends with the digest() of the state it describes, so decoding proves it
+// rebuilt exactly that state and a verifier can compare a re-run against it.
+class StateRecord
+{
+public:
+    using RandomState = std::array<uint64_t, 4 * GameRandom::STREAM_COUNT>;
+
+    // What a record holds besides the engine state
+    struct Extras
+    {
+        std::vector<bool> computer;     // Per player: played by the computer
+        bool atStartOfTurn = true;      // Nothing moved yet this turn (the game can be saved)
+        uint64_t randomSeed = 0;
+        RandomState randomState = {};
+    };
+
+    // Hash of everything in the state (exact wallets, every piece field, roads,
+    // inflation); unlike the Zobrist key it is for telling states apart, not searching
+    static uint64_t digest(const GameState &state);
+
+    static std::vector<char> encodeSnapshot(const GameState &state, const Extras &extras);
+
+    // Returns false if the change can't be expressed as an action (the players or map changed)
+    static bool encodeAction(const GameState &before, const Extras &beforeExtras, const GameState &after,
+                             const Extras &extras, const std::string &label, std::vector<char> &out);
+
+    static bool isSnapshot(const char *payload, size_t size);
+
+    // Decode a snapshot into state, or apply an action on top of it; false if the payload is the other kind,
+    // damaged or doesn't rebuild the state it was recorded from. stateDigest receives the recorded digest
+    static bool decodeSnapshot(const char *payload, size_t size, GameState &state, Extras &extras,
+                               uint64_t *stateDigest = nullptr);
+    static bool applyAction(const char *payload, size_t size, GameState &state, Extras &extras,
+                            uint64_t *stateDigest = nullptr);
+
+    // Length, payload, checksum
+    static void appendFrame(std::vector<char> &out, const std::vector<char> &payload);
+
+    // Next frame's payload; false if it is cut short or fails its checksum
+    static bool readFrame(ByteReader &reader, const char *&payload, size_t &size);
+};
+
+#endif // STATERECORD_H
@@ -0,0 +1,108 @@
+#include "threadpool.h"
+
+// Pool and worker index of the calling thread (nullptr / -1 outside any pool)
+static thread_local ThreadPool *t_pool = nullptr;
+static thread_local int t_workerIndex = -1;
+
+ThreadPool::ThreadPool(int threads)
+    : m_queued(0)
+    , m_nextWorker(0)
+    , m_stopping(false)
+{
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    for (int i = 0; i < threads; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < threads; ++i) {
+        m_threads.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::push(std::function<void()> task)
+{
+    int index = (t_pool == this) ? t_workerIndex
+                                 : static_cast<int>(m_nextWorker++ % m_workers.size());
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // Publish under the sleep mutex so a worker can't miss the wake-up between its check and its wait
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_queued++;
+    }
+    m_wake.notify_one();
+}
+
+bool ThreadPool::popLocal(int index, std::function<void()> &task)
+{
+    Worker &worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(int index, std::function<void()> &task)
+{
+    int count = static_cast<int>(m_workers.size());
+    for (int offset = 1; offset < count; ++offset) {
+        Worker &victim = *m_workers[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(int index)
+{
+    t_pool = this;
+    t_workerIndex = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (popLocal(index, task) || steal(index, task)) {
+            m_queued--;
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this]() { return m_stopping || m_queued > 0; });
+        if (m_stopping && m_queued == 0) {
+            return;
+        }
+    }
+}
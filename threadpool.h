@@ -0,0 +1,65 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Work-stealing thread pool. Each worker owns a deque: tasks submitted from
+// inside a worker go to the back of its own deque and are popped LIFO (hot
+// caches), idle workers steal from the front of the others. Tasks submitted
+// from outside the pool are dealt round-robin. Don't block on a future from
+// inside a task - every worker could end up waiting on work nobody runs.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threads = 0);   // 0 = one per hardware thread
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int threadCount() const { return static_cast<int>(m_threads.size()); }
+
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function function)
+    {
+        using Result = std::invoke_result_t<Function>;
+        // std::function needs a copyable target, packaged_task is move-only
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+        std::future<Result> result = task->get_future();
+        push([task]() { (*task)(); });
+        return result;
+    }
+
+    // Process-wide pool shared by the computer players
+    static ThreadPool &shared();
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void push(std::function<void()> task);
+    bool popLocal(int index, std::function<void()> &task);
+    bool steal(int index, std::function<void()> &task);
+    void run(int index);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<int> m_queued;
+    std::atomic<unsigned> m_nextWorker;
+    bool m_stopping;   // Guarded by m_sleepMutex
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,125 @@
+#ifndef TILEMASK_H
+#define TILEMASK_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Board dimensions shared by the widgets and the headless game engine
+static constexpr int BOARD_ROWS = 8;
+static constexpr int BOARD_COLUMNS = 12;
+static constexpr int BOARD_TILES = BOARD_ROWS * BOARD_COLUMNS;
+
+// Tiles are addressed by a single index: row * BOARD_COLUMNS + col
+inline int tileIndex(int row, int col) { return row * BOARD_COLUMNS + col; }
+inline int tileRow(int tile) { return tile / BOARD_COLUMNS; }
+inline int tileColumn(int tile) { return tile % BOARD_COLUMNS; }
+inline bool isOnBoard(int row, int col) { return row >= 0 && row < BOARD_ROWS && col >= 0 && col < BOARD_COLUMNS; }
+
+// Bit helpers (GCC/Clang builtins, portable fallbacks elsewhere)
+inline int popCount64(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(value);
+#else
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+inline int lowestBit64(uint64_t value)  // value must be non-zero
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    int index = 0;
+    while (!(value & 1ULL)) {
+        value >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// Set of board tiles packed into 96 bits (two 64-bit words)
+class TileMask
+{
+public:
+    constexpr TileMask() : m_low(0), m_high(0) {}
+    constexpr TileMask(uint64_t low, uint64_t high) : m_low(low), m_high(high & HIGH_WORD_MASK) {}
+
+    static TileMask single(int tile) { TileMask mask; mask.set(tile); return mask; }
+    static constexpr TileMask all() { return TileMask(~0ULL, ~0ULL); }
+
+    bool test(int tile) const
+    {
+        return tile < 64 ? ((m_low >> tile) & 1ULL) != 0 : ((m_high >> (tile - 64)) & 1ULL) != 0;
+    }
+    void set(int tile)
+    {
+        if (tile < 64) m_low |= (1ULL << tile);
+        else m_high |= (1ULL << (tile - 64));
+    }
+    void reset(int tile)
+    {
+        if (tile < 64) m_low &= ~(1ULL << tile);
+        else m_high &= ~(1ULL << (tile - 64));
+    }
+    void assign(int tile, bool on) { if (on) set(tile); else reset(tile); }
+    void clear() { m_low = 0; m_high = 0; }
+
+    bool isEmpty() const { return (m_low | m_high) == 0; }
+    bool any() const { return !isEmpty(); }
+    bool intersects(const TileMask &other) const { return ((m_low & other.m_low) | (m_high & other.m_high)) != 0; }
+    bool contains(const TileMask &other) const { return (other & ~*this).isEmpty(); }
+    int count() const { return popCount64(m_low) + popCount64(m_high); }
+
+    // Lowest tile in the set, or -1 if empty
+    int first() const
+    {
+        if (m_low) return lowestBit64(m_low);
+        if (m_high) return 64 + lowestBit64(m_high);
+        return -1;
+    }
+
+    // Call f(tile) for every tile in ascending order
+    template<typename Function>
+    void forEach(Function f) const
+    {
+        for (uint64_t bits = m_low; bits; bits &= bits - 1) {
+            f(lowestBit64(bits));
+        }
+        for (uint64_t bits = m_high; bits; bits &= bits - 1) {
+            f(64 + lowestBit64(bits));
+        }
+    }
+
+    uint64_t lowWord() const { return m_low; }
+    uint64_t highWord() const { return m_high; }
+
+    TileMask operator|(const TileMask &other) const { return TileMask(m_low | other.m_low, m_high | other.m_high); }
+    TileMask operator&(const TileMask &other) const { return TileMask(m_low & other.m_low, m_high & other.m_high); }
+    TileMask operator^(const TileMask &other) const { return TileMask(m_low ^ other.m_low, m_high ^ other.m_high); }
+    TileMask operator~() const { return TileMask(~m_low, ~m_high); }
+    TileMask &operator|=(const TileMask &other) { m_low |= other.m_low; m_high |= other.m_high; return *this; }
+    TileMask &operator&=(const TileMask &other) { m_low &= other.m_low; m_high &= other.m_high; return *this; }
+    TileMask &operator^=(const TileMask &other) { m_low ^= other.m_low; m_high ^= other.m_high; return *this; }
+    bool operator==(const TileMask &other) const { return m_low == other.m_low && m_high == other.m_high; }
+    bool operator!=(const TileMask &other) const { return !(*this == other); }
+
+private:
+    static constexpr uint64_t HIGH_WORD_MASK = (1ULL << (BOARD_TILES - 64)) - 1;
+
+    uint64_t m_low;   // Tiles 0-63
+    uint64_t m_high;  // Tiles 64-95
+};
+
+#endif // TILEMASK_H
@@ -0,0 +1,40 @@
+#include "transpositiontable.h"
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+{
+    // Largest power of two that fits the budget (at least one slot)
+    size_t slots = 1;
+    while (slots * 2 * sizeof(Slot) <= megabytes * 1024 * 1024) {
+        slots *= 2;
+    }
+    m_slots.reset(new Slot[slots]);
+    m_mask = slots - 1;
+    clear();
+}
+
+bool TranspositionTable::probe(uint64_t key, uint64_t &data) const
+{
+    const Slot &slot = m_slots[key & m_mask];
+    uint64_t stored = slot.data.load(std::memory_order_relaxed);
+    if ((slot.check.load(std::memory_order_relaxed) ^ stored) != key) {
+        return false;
+    }
+    data = stored;
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, uint64_t data)
+{
+    Slot &slot = m_slots[key & m_mask];
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear()
+{
+    // An empty slot must not match key 0
+    for (size_t i = 0; i <= m_mask; ++i) {
+        m_slots[i].data.store(0, std::memory_order_relaxed);
+        m_slots[i].check.store(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Lock-free hash table from a 64-bit position hash (see Zobrist) to one
+// 64-bit word of search data, shared by any number of threads. Each slot
+// stores the data and key ^ data (Hyatt's lockless scheme): a slot torn by
+// two concurrent writers fails the key check on probe instead of returning
+// mixed data. Slots are always overwritten, and concurrent read-modify-write
+// of one slot can lose an update - fine for caches and search statistics.
+class TranspositionTable
+{
+public:
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    // Data stored for key, if the slot still holds it
+    bool probe(uint64_t key, uint64_t &data) const;
+    void store(uint64_t key, uint64_t data);
+
+    void clear();
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;   // key ^ data
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    uint64_t m_mask;
+};
+
+#endif // TRANSPOSITIONTABLE_H
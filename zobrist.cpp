@@ -0,0 +1,114 @@
+#include "zobrist.h"
+#include "fastrng.h"
+#include <algorithm>
+
+struct Zobrist::Keys {
+    static constexpr int KINDS = 6;
+
+    uint64_t pieces[MAX_PLAYERS][KINDS][BOARD_TILES];
+    uint64_t owners[MAX_PLAYERS][BOARD_TILES];
+    uint64_t cities[MAX_PLAYERS][BOARD_TILES];
+    uint64_t fortifications[MAX_PLAYERS][BOARD_TILES];
+    uint64_t wallets[MAX_PLAYERS][WALLET_BUCKETS];
+    uint64_t toMove[MAX_PLAYERS];
+    uint64_t endMovement;
+
+    Keys()
+    {
+        // Fixed seed: hashes stay comparable between runs, processes and save files
+        Xoshiro256 random(0x5A0B815ULL);
+        for (auto &player : pieces) {
+            for (auto &kind : player) {
+                for (uint64_t &key : kind) {
+                    key = random.next();
+                }
+            }
+        }
+        for (auto *table : {&owners, &cities, &fortifications}) {
+            for (auto &player : *table) {
+                for (uint64_t &key : player) {
+                    key = random.next();
+                }
+            }
+        }
+        for (auto &player : wallets) {
+            for (uint64_t &key : player) {
+                key = random.next();
+            }
+        }
+        for (uint64_t &key : toMove) {
+            key = random.next();
+        }
+        endMovement = random.next();
+    }
+};
+
+const Zobrist::Keys &Zobrist::keys()
+{
+    static const Keys table;
+    return table;
+}
+
+uint64_t Zobrist::piece(int player, PieceKind kind, int tile)
+{
+    return keys().pieces[player][static_cast<int>(kind)][tile];
+}
+
+uint64_t Zobrist::owner(int player, int tile)
+{
+    return keys().owners[player][tile];
+}
+
+uint64_t Zobrist::city(int player, int tile)
+{
+    return keys().cities[player][tile];
+}
+
+uint64_t Zobrist::fortification(int player, int tile)
+{
+    return keys().fortifications[player][tile];
+}
+
+uint64_t Zobrist::wallet(int player, int amount)
+{
+    int bucket = std::min(std::max(amount, 0) / WALLET_BUCKET, WALLET_BUCKETS - 1);
+    return keys().wallets[player][bucket];
+}
+
+uint64_t Zobrist::toMove(int player)
+{
+    return keys().toMove[player];
+}
+
+uint64_t Zobrist::endMovement()
+{
+    return keys().endMovement;
+}
+
+uint64_t Zobrist::hash(const PlayerState &player)
+{
+    int index = seat(player.id);
+    uint64_t hash = wallet(index, player.wallet);
+    player.owned.forEach([&](int tile) { hash += owner(index, tile); });
+    player.cities.forEach([&](int tile) { hash += city(index, tile); });
+    player.fortifiedCities.forEach([&](int tile) { hash += fortification(index, tile); });
+    for (const PieceState &pieceState : *player.pieces) {
+        // Prisoners are off the board as far as play is concerned
+        if (pieceState.tile != NO_TILE && pieceState.capturedBy == NO_PLAYER) {
+            hash += piece(index, pieceState.kind, pieceState.tile);
+        }
+    }
+    return hash;
+}
+
+uint64_t Zobrist::hash(const GameState &state)
+{
+    uint64_t hash = 0;
+    for (const PlayerState &player : state.players) {
+        hash += Zobrist::hash(player);
+    }
+    if (state.currentPlayer >= 0 && state.currentPlayer < state.playerCount()) {
+        hash += toMove(seat(state.players[state.currentPlayer].id));
+    }
+    return hash;
+}
@@ -0,0 +1,44 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include "gamestate.h"
+
+// Zobrist keys for game positions: tile ownership, pieces by player, kind
+// and tile, cities, fortifications, bucketed wallets and the player to move.
+// A position's hash is the sum (mod 2^64) of the keys of its features, so
+// updates are one add and one subtract; keys are added rather than XORed
+// because several identical pieces on one tile must not cancel out.
+//
+// Players are keyed by their id ('A' = 0), so a GameState and the Qt model
+// (Player::getZobristHash, kept up to date as pieces move and territories,
+// cities and wallets change) hash the same position to the same value.
+class Zobrist
+{
+public:
+    static constexpr int WALLET_BUCKET = 25;    // Talents per wallet bucket
+    static constexpr int WALLET_BUCKETS = 64;   // The last bucket holds every bigger wallet
+
+    static uint64_t piece(int player, PieceKind kind, int tile);
+    static uint64_t owner(int player, int tile);
+    static uint64_t city(int player, int tile);
+    static uint64_t fortification(int player, int tile);
+    static uint64_t wallet(int player, int amount);
+    static uint64_t toMove(int player);
+
+    // Added to a hash for "the player to move has finished moving" (search trees)
+    static uint64_t endMovement();
+
+    // Seat of a player id ('A'-'F')
+    static int seat(char id) { return id - 'A'; }
+
+    // Whole-position hash; the players' parts plus the player to move
+    static uint64_t hash(const GameState &state);
+    static uint64_t hash(const PlayerState &player);
+
+private:
+    struct Keys;
+    static const Keys &keys();
+};
+
+#endif // ZOBRIST_H